@@ -60,14 +60,14 @@ CMDSDocumentStorage& CMDSDocument::getDocumentStorage() const
 UniversalTime CMDSDocument::getCreationUniversalTime() const
 //----------------------------------------------------------------------------------------------------------------------
 {
-	return mInternals->mDocumentStorage.documentCreationUniversalTime(makeI());
+	return mInternals->mDocumentStorage.documentCreationUniversalTime(*this);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
 UniversalTime CMDSDocument::getModificationUniversalTime() const
 //----------------------------------------------------------------------------------------------------------------------
 {
-	return mInternals->mDocumentStorage.documentModificationUniversalTime(makeI());
+	return mInternals->mDocumentStorage.documentModificationUniversalTime(*this);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -75,7 +75,7 @@ OV<TArray<CString> > CMDSDocument::getArrayOfStrings(const CString& property) co
 //----------------------------------------------------------------------------------------------------------------------
 {
 	// Get value
-	OV<SValue>	value = mInternals->mDocumentStorage.documentValue(property, makeI());
+	OV<SValue>	value = mInternals->mDocumentStorage.documentValue(property, *this);
 	AssertFailIf(value.hasValue() && (value->getType() != SValue::kTypeArrayOfStrings));
 
 	return value.hasValue() ? OV<TArray<CString> >(value->getArrayOfStrings()) : OV<TArray<CString> >();
@@ -86,7 +86,7 @@ void CMDSDocument::set(const CString& property, const TArray<CString>& value) co
 //----------------------------------------------------------------------------------------------------------------------
 {
 	// Set value
-	mInternals->mDocumentStorage.documentSet(property, OV<SValue>(value), makeI());
+	mInternals->mDocumentStorage.documentSet(property, OV<SValue>(value), *this);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -94,7 +94,7 @@ OV<TArray<CDictionary> > CMDSDocument::getArrayOfDictionaries(const CString& pro
 //----------------------------------------------------------------------------------------------------------------------
 {
 	// Get value
-	OV<SValue>	value = mInternals->mDocumentStorage.documentValue(property, makeI());
+	OV<SValue>	value = mInternals->mDocumentStorage.documentValue(property, *this);
 	AssertFailIf(value.hasValue() && (value->getType() != SValue::kTypeArrayOfDictionaries));
 
 	return value.hasValue() ? OV<TArray<CDictionary> >(value->getArrayOfDictionaries()) : OV<TArray<CDictionary> >();
@@ -105,7 +105,7 @@ void CMDSDocument::set(const CString& property, const TArray<CDictionary>& value
 //----------------------------------------------------------------------------------------------------------------------
 {
 	// Set value
-	mInternals->mDocumentStorage.documentSet(property, OV<SValue>(value), makeI());
+	mInternals->mDocumentStorage.documentSet(property, OV<SValue>(value), *this);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -113,7 +113,7 @@ OV<bool> CMDSDocument::getBool(const CString& property) const
 //----------------------------------------------------------------------------------------------------------------------
 {
 	// Get value
-	OV<SValue>	value = mInternals->mDocumentStorage.documentValue(property, makeI());
+	OV<SValue>	value = mInternals->mDocumentStorage.documentValue(property, *this);
 	AssertFailIf(value.hasValue() && (value->getType() != SValue::kTypeBool));
 
 	return value.hasValue() ? OV<bool>(value->getBool()) : OV<bool>();
@@ -127,7 +127,7 @@ OV<bool> CMDSDocument::set(const CString& property, bool value) const
 	OV<bool>	previousValue = getBool(property);
 	if (!previousValue.hasValue() || (value != *previousValue))
 		// Set value
-		mInternals->mDocumentStorage.documentSet(property, OV<SValue>(value), makeI());
+		mInternals->mDocumentStorage.documentSet(property, OV<SValue>(value), *this);
 
 	return previousValue;
 }
@@ -136,7 +136,7 @@ OV<bool> CMDSDocument::set(const CString& property, bool value) const
 OV<CData> CMDSDocument::getData(const CString& property) const
 //----------------------------------------------------------------------------------------------------------------------
 {
-	return mInternals->mDocumentStorage.documentData(property, makeI());
+	return mInternals->mDocumentStorage.documentData(property, *this);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -147,7 +147,7 @@ OV<CData> CMDSDocument::set(const CString& property, const CData& value) const
 	OV<CData>	previousValue = getData(property);
 	if (!previousValue.hasValue() || (value != *previousValue))
 		// Set value
-		mInternals->mDocumentStorage.documentSet(property, OV<SValue>(value), makeI());
+		mInternals->mDocumentStorage.documentSet(property, OV<SValue>(value), *this);
 
 	return previousValue;
 }
@@ -157,7 +157,7 @@ OV<CDictionary> CMDSDocument::getDictionary(const CString& property) const
 //----------------------------------------------------------------------------------------------------------------------
 {
 	// Get value
-	OV<SValue>	value = mInternals->mDocumentStorage.documentValue(property, makeI());
+	OV<SValue>	value = mInternals->mDocumentStorage.documentValue(property, *this);
 	AssertFailIf(value.hasValue() && (value->getType() != SValue::kTypeDictionary));
 
 	return value.hasValue() ? OV<CDictionary>(value->getDictionary()) : OV<CDictionary>();
@@ -171,7 +171,7 @@ OV<CDictionary> CMDSDocument::set(const CString& property, const CDictionary& va
 	OV<CDictionary>	previousValue = getDictionary(property);
 	if (!previousValue.hasValue() || (value != *previousValue))
 		// Set value
-		mInternals->mDocumentStorage.documentSet(property, OV<SValue>(value), makeI());
+		mInternals->mDocumentStorage.documentSet(property, OV<SValue>(value), *this);
 
 	return previousValue;
 }
@@ -181,7 +181,7 @@ OV<Float32> CMDSDocument::getFloat32(const CString& property) const
 //----------------------------------------------------------------------------------------------------------------------
 {
 	// Get value
-	OV<SValue>	value = mInternals->mDocumentStorage.documentValue(property, makeI());
+	OV<SValue>	value = mInternals->mDocumentStorage.documentValue(property, *this);
 	AssertFailIf(value.hasValue() && (value->getType() != SValue::kTypeFloat32));
 
 	return value.hasValue() ? OV<Float32>(value->getFloat32()) : OV<Float32>();
@@ -195,7 +195,7 @@ OV<Float32> CMDSDocument::set(const CString& property, Float32 value) const
 	OV<Float32>	previousValue = getFloat32(property);
 	if (!previousValue.hasValue() || (value != *previousValue))
 		// Set value
-		mInternals->mDocumentStorage.documentSet(property, OV<SValue>(value), makeI());
+		mInternals->mDocumentStorage.documentSet(property, OV<SValue>(value), *this);
 
 	return previousValue;
 }
@@ -205,7 +205,7 @@ OV<Float64> CMDSDocument::getFloat64(const CString& property) const
 //----------------------------------------------------------------------------------------------------------------------
 {
 	// Get value
-	OV<SValue>	value = mInternals->mDocumentStorage.documentValue(property, makeI());
+	OV<SValue>	value = mInternals->mDocumentStorage.documentValue(property, *this);
 	AssertFailIf(value.hasValue() && (value->getType() != SValue::kTypeFloat64));
 
 	return value.hasValue() ? OV<Float64>(value->getFloat64()) : OV<Float64>();
@@ -219,7 +219,7 @@ OV<Float64> CMDSDocument::set(const CString& property, Float64 value) const
 	OV<Float64>	previousValue = getFloat64(property);
 	if (!previousValue.hasValue() || (value != *previousValue))
 		// Set value
-		mInternals->mDocumentStorage.documentSet(property, OV<SValue>(value), makeI());
+		mInternals->mDocumentStorage.documentSet(property, OV<SValue>(value), *this);
 
 	return previousValue;
 }
@@ -229,7 +229,7 @@ OV<SInt32> CMDSDocument::getSInt32(const CString& property) const
 //----------------------------------------------------------------------------------------------------------------------
 {
 	// Get value
-	OV<SValue>	value = mInternals->mDocumentStorage.documentValue(property, makeI());
+	OV<SValue>	value = mInternals->mDocumentStorage.documentValue(property, *this);
 	AssertFailIf(value.hasValue() && (value->getType() != SValue::kTypeSInt32));
 
 	return value.hasValue() ? OV<SInt32>(value->getSInt32()) : OV<SInt32>();
@@ -243,7 +243,7 @@ OV<SInt32> CMDSDocument::set(const CString& property, SInt32 value) const
 	OV<SInt32>	previousValue = getSInt32(property);
 	if (!previousValue.hasValue() || (value != *previousValue))
 		// Set value
-		mInternals->mDocumentStorage.documentSet(property, OV<SValue>(value), makeI());
+		mInternals->mDocumentStorage.documentSet(property, OV<SValue>(value), *this);
 
 	return previousValue;
 }
@@ -253,7 +253,7 @@ OV<SInt64> CMDSDocument::getSInt64(const CString& property) const
 //----------------------------------------------------------------------------------------------------------------------
 {
 	// Get value
-	OV<SValue>	value = mInternals->mDocumentStorage.documentValue(property, makeI());
+	OV<SValue>	value = mInternals->mDocumentStorage.documentValue(property, *this);
 	AssertFailIf(value.hasValue() && (value->getType() != SValue::kTypeSInt64));
 
 	return value.hasValue() ? OV<SInt64>(value->getSInt64()) : OV<SInt64>();
@@ -267,7 +267,7 @@ OV<SInt64> CMDSDocument::set(const CString& property, SInt64 value) const
 	OV<SInt64>	previousValue = getSInt64(property);
 	if (!previousValue.hasValue() || (value != *previousValue))
 		// Set value
-		mInternals->mDocumentStorage.documentSet(property, OV<SValue>(value), makeI());
+		mInternals->mDocumentStorage.documentSet(property, OV<SValue>(value), *this);
 
 	return previousValue;
 }
@@ -277,7 +277,7 @@ OV<CString> CMDSDocument::getString(const CString& property) const
 //----------------------------------------------------------------------------------------------------------------------
 {
 	// Get value
-	OV<SValue>	value = mInternals->mDocumentStorage.documentValue(property, makeI());
+	OV<SValue>	value = mInternals->mDocumentStorage.documentValue(property, *this);
 	AssertFailIf(value.hasValue() && (value->getType() != SValue::kTypeString));
 
 	return value.hasValue() ? OV<CString>(value->getString()) : OV<CString>();
@@ -291,7 +291,7 @@ OV<CString> CMDSDocument::set(const CString& property, const CString& value) con
 	OV<CString>	previousValue = getString(property);
 	if (!previousValue.hasValue() || (value != *previousValue))
 		// Set value
-		mInternals->mDocumentStorage.documentSet(property, OV<SValue>(value), makeI());
+		mInternals->mDocumentStorage.documentSet(property, OV<SValue>(value), *this);
 
 	return previousValue;
 }
@@ -301,7 +301,7 @@ OV<UInt8> CMDSDocument::getUInt8(const CString& property) const
 //----------------------------------------------------------------------------------------------------------------------
 {
 	// Get value
-	OV<SValue>	value = mInternals->mDocumentStorage.documentValue(property, makeI());
+	OV<SValue>	value = mInternals->mDocumentStorage.documentValue(property, *this);
 	AssertFailIf(value.hasValue() && (value->getType() != SValue::kTypeUInt8));
 
 	return value.hasValue() ? OV<UInt8>(value->getUInt8()) : OV<UInt8>();
@@ -315,7 +315,7 @@ OV<UInt8> CMDSDocument::set(const CString& property, UInt8 value) const
 	OV<UInt8>	previousValue = getUInt8(property);
 	if (!previousValue.hasValue() || (value != *previousValue))
 		// Set value
-		mInternals->mDocumentStorage.documentSet(property, OV<SValue>(value), makeI());
+		mInternals->mDocumentStorage.documentSet(property, OV<SValue>(value), *this);
 
 	return previousValue;
 }
@@ -329,7 +329,7 @@ OV<UInt8> CMDSDocument::set(const CString& property, const OV<UInt8>& value) con
 	if (value != previousValue)
 		// Set value
 		mInternals->mDocumentStorage.documentSet(property, value.hasValue() ? OV<SValue>(*value) : OV<SValue>(),
-				makeI());
+				*this);
 
 	return previousValue;
 }
@@ -339,7 +339,7 @@ OV<UInt16> CMDSDocument::getUInt16(const CString& property) const
 //----------------------------------------------------------------------------------------------------------------------
 {
 	// Get value
-	OV<SValue>	value = mInternals->mDocumentStorage.documentValue(property, makeI());
+	OV<SValue>	value = mInternals->mDocumentStorage.documentValue(property, *this);
 	AssertFailIf(value.hasValue() && (value->getType() != SValue::kTypeUInt16));
 
 	return value.hasValue() ? OV<UInt16>(value->getUInt16()) : OV<UInt16>();
@@ -353,7 +353,7 @@ OV<UInt16> CMDSDocument::set(const CString& property, UInt16 value) const
 	OV<UInt16>	previousValue = getUInt16(property);
 	if (!previousValue.hasValue() || (value != *previousValue))
 		// Set value
-		mInternals->mDocumentStorage.documentSet(property, OV<SValue>(value), makeI());
+		mInternals->mDocumentStorage.documentSet(property, OV<SValue>(value), *this);
 
 	return previousValue;
 }
@@ -363,7 +363,7 @@ OV<UInt32> CMDSDocument::getUInt32(const CString& property) const
 //----------------------------------------------------------------------------------------------------------------------
 {
 	// Get value
-	OV<SValue>	value = mInternals->mDocumentStorage.documentValue(property, makeI());
+	OV<SValue>	value = mInternals->mDocumentStorage.documentValue(property, *this);
 	AssertFailIf(value.hasValue() && (value->getType() != SValue::kTypeUInt32));
 
 	return value.hasValue() ? OV<UInt32>(value->getUInt32()) : OV<UInt32>();
@@ -377,7 +377,7 @@ OV<UInt32> CMDSDocument::set(const CString& property, UInt32 value) const
 	OV<UInt32>	previousValue = getUInt32(property);
 	if (!previousValue.hasValue() || (value != *previousValue))
 		// Set value
-		mInternals->mDocumentStorage.documentSet(property, OV<SValue>(value), makeI());
+		mInternals->mDocumentStorage.documentSet(property, OV<SValue>(value), *this);
 
 	return previousValue;
 }
@@ -387,7 +387,7 @@ OV<UInt64> CMDSDocument::getUInt64(const CString& property) const
 //----------------------------------------------------------------------------------------------------------------------
 {
 	// Get value
-	OV<SValue>	value = mInternals->mDocumentStorage.documentValue(property, makeI());
+	OV<SValue>	value = mInternals->mDocumentStorage.documentValue(property, *this);
 	AssertFailIf(value.hasValue() && (value->getType() != SValue::kTypeUInt64));
 
 	return value.hasValue() ? OV<UInt64>(value->getUInt64()) : OV<UInt64>();
@@ -401,7 +401,7 @@ OV<UInt64> CMDSDocument::set(const CString& property, UInt64 value) const
 	OV<UInt64>	previousValue = getUInt64(property);
 	if (!previousValue.hasValue() || (value != *previousValue))
 		// Set value
-		mInternals->mDocumentStorage.documentSet(property, OV<SValue>(value), makeI());
+		mInternals->mDocumentStorage.documentSet(property, OV<SValue>(value), *this);
 
 	return previousValue;
 }
@@ -410,7 +410,7 @@ OV<UInt64> CMDSDocument::set(const CString& property, UInt64 value) const
 OV<UniversalTime> CMDSDocument::getUniversalTime(const CString& property) const
 //----------------------------------------------------------------------------------------------------------------------
 {
-	return mInternals->mDocumentStorage.documentUniversalTime(property, makeI());
+	return mInternals->mDocumentStorage.documentUniversalTime(property, *this);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -421,7 +421,7 @@ OV<UniversalTime> CMDSDocument::setUniversalTime(const CString& property, Univer
 	OV<UniversalTime>	previousValue = getUniversalTime(property);
 	if (!previousValue.hasValue() || (value != *previousValue))
 		// Set value
-		mInternals->mDocumentStorage.documentSet(property, OV<SValue>(value), makeI(),
+		mInternals->mDocumentStorage.documentSet(property, OV<SValue>(value), *this,
 				CMDSDocumentStorage::kSetValueKindUniversalTime);
 
 	return previousValue;
@@ -444,7 +444,7 @@ void CMDSDocument::remove(const CString& property) const
 //----------------------------------------------------------------------------------------------------------------------
 {
 	// Set value
-	mInternals->mDocumentStorage.documentSet(property, OV<SValue>(), makeI());
+	mInternals->mDocumentStorage.documentSet(property, OV<SValue>(), *this);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -588,7 +588,7 @@ void CMDSDocument::removeAttachment(const AttachmentInfo& attachmentInfo)
 void CMDSDocument::remove() const
 //----------------------------------------------------------------------------------------------------------------------
 {
-	mInternals->mDocumentStorage.documentRemove(makeI());
+	mInternals->mDocumentStorage.documentRemove(*this);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
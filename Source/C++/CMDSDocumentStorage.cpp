@@ -367,6 +367,14 @@ void CMDSDocumentStorage::notifyDocumentChanged(const I<CMDSDocument>& document,
 
 // MARK: Class methods
 
+//----------------------------------------------------------------------------------------------------------------------
+SError CMDSDocumentStorage::getInvalidContinuationTokenError(const CString& continuationToken)
+//----------------------------------------------------------------------------------------------------------------------
+{
+	return SError(CString(OSSTR("MDSDocumentStorage")), 4,
+			CString(OSSTR("Invalid continuationToken: ")) + continuationToken);
+}
+
 //----------------------------------------------------------------------------------------------------------------------
 SError CMDSDocumentStorage::getInvalidCountError(UInt32 count)
 //----------------------------------------------------------------------------------------------------------------------
@@ -465,3 +473,10 @@ SError CMDSDocumentStorage::getIllegalInBatchError()
 {
 	return SError(CString(OSSTR("MDSDocumentStorage")), 81, CString(OSSTR("Illegal in batch")));
 }
+
+//----------------------------------------------------------------------------------------------------------------------
+SError CMDSDocumentStorage::getNotUpToDateError(const CString& name)
+//----------------------------------------------------------------------------------------------------------------------
+{
+	return SError(CString(OSSTR("MDSDocumentStorage")), 91, CString(OSSTR("Not up to date: ")) + name);
+}
@@ -163,19 +163,19 @@ class CMDSDocumentStorage {
 																	= 0;
 
 		virtual			UniversalTime						documentCreationUniversalTime(
-																	const I<CMDSDocument>& document) const = 0;
+																	const CMDSDocument& document) const = 0;
 		virtual			UniversalTime						documentModificationUniversalTime(
-																	const I<CMDSDocument>& document) const = 0;
+																	const CMDSDocument& document) const = 0;
 
 		virtual			OV<SValue>							documentValue(const CString& property,
-																	const I<CMDSDocument>& document) const = 0;
+																	const CMDSDocument& document) const = 0;
 		virtual			OV<CData>							documentData(const CString& property,
-																	const I<CMDSDocument>& document) const = 0;
+																	const CMDSDocument& document) const = 0;
 		virtual			OV<UniversalTime>					documentUniversalTime(const CString& property,
-																	const I<CMDSDocument>& document) const = 0;
+																	const CMDSDocument& document) const = 0;
 		virtual			void								documentSet(const CString& property,
 																	const OV<SValue>& value,
-																	const I<CMDSDocument>& document,
+																	const CMDSDocument& document,
  																	SetValueKind setValueKind =
  																			kSetValueKindNothingSpecial) = 0;
 
@@ -196,7 +196,7 @@ class CMDSDocumentStorage {
 																	const CString& documentID,
 																	const CString& attachmentID) = 0;
 
-		virtual			OV<SError>							documentRemove(const I<CMDSDocument>& document) = 0;
+		virtual			OV<SError>							documentRemove(const CMDSDocument& document) = 0;
 
 		virtual			OV<SError>							indexRegister(const CString& name,
 																	const CString& documentType,
@@ -313,6 +313,12 @@ class CMDSDocumentStorage {
 																			documentChangedInfo);
 						DocumentChangedInfos				documentChangedInfos(const CString& documentType) const;
 
+															// Is included performers, keys performers and value infos
+															//	are called from worker threads when caches, collections
+															//	and indexes are updated, several at once.  Their procs
+															//	must be safe to call concurrently with each other and
+															//	with themselves.  They may read document properties,
+															//	including changes in a batch being committed.
 						void								registerDocumentIsIncludedPerformerInfos(
 																	const TArray<DocumentIsIncludedPerformerInfo>&
 																			documentIsIncludedPerformerInfos);
@@ -333,6 +339,8 @@ class CMDSDocumentStorage {
 						void								storeEphemeral(const CString& key, const OV<SValue>& value);
 
 															// Class methods
+		static			SError								getInvalidContinuationTokenError(
+																	const CString& continuationToken);
 		static			SError								getInvalidCountError(UInt32 count);
 		static			SError								getInvalidDocumentTypeError(const CString& documentType);
 		static			SError								getInvalidStartIndexError(UInt32 startIndex);
@@ -356,6 +364,8 @@ class CMDSDocumentStorage {
 
 		static			SError								getIllegalInBatchError();
 
+		static			SError								getNotUpToDateError(const CString& name);
+
 	protected:
 															// Lifecycle methods
 															CMDSDocumentStorage();
@@ -0,0 +1,177 @@
+//----------------------------------------------------------------------------------------------------------------------
+//	CMDSWorkerPool.cpp			©2026 Stevo Brock	All rights reserved.
+//----------------------------------------------------------------------------------------------------------------------
+
+#include "CMDSWorkerPool.h"
+
+#include "ConcurrencyPrimitives.h"
+#include "CThread.h"
+
+#include <atomic>
+#include <thread>
+
+//----------------------------------------------------------------------------------------------------------------------
+// MARK: CMDSWorkerPool::Internals
+
+class CMDSWorkerPool::Internals {
+	public:
+		// Worker
+		class Worker : public CThread {
+			public:
+						Worker(Internals& internals) :
+							CThread(CString(OSSTR("MDS Worker"))), mInternals(internals), mShouldStop(false)
+							{ start(); }
+
+				void	perform()
+							{ mSemaphore.signal(); }
+				void	waitUntilDone()
+							{ mDoneSemaphore.waitFor(); }
+				void	stop()
+							{
+								// Signal and wait until done
+								mShouldStop = true;
+								mSemaphore.signal();
+								mDoneSemaphore.waitFor();
+							}
+
+			protected:
+				void	run()
+							{
+								// Loop until stopped
+								while (true) {
+									// Wait for work
+									mSemaphore.waitFor();
+									if (mShouldStop)
+										break;
+
+									// Perform
+									mInternals.performAvailable();
+									mDoneSemaphore.signal();
+								}
+
+								// Done
+								mDoneSemaphore.signal();
+							}
+
+			private:
+				Internals&			mInternals;
+				std::atomic<bool>	mShouldStop;
+				CSemaphore			mSemaphore;
+				CSemaphore			mDoneSemaphore;
+		};
+
+				Internals(UInt32 workerCount) :
+					mWorkerCount(workerCount), mIsBusy(false), mProc(nil), mProcUserData(nil), mCount(0), mNextIndex(0)
+					{}
+				~Internals()
+					{
+						// Stop workers
+						for (TArray<I<Worker> >::Iterator iterator = mWorkers.getIterator(); iterator; iterator++)
+							// Stop
+							(*iterator)->stop();
+					}
+
+		void	createWorkersIfNeeded()
+					{
+						// Create any workers not yet created
+						for (UInt32 i = mWorkers.getCount(); i < mWorkerCount; i++)
+							// Create worker
+							mWorkers += I<Worker>(new Worker(*this));
+					}
+		void	performAvailable()
+					{
+						// Claim indexes until all have been claimed
+						for (UInt32 index = mNextIndex.fetch_add(1); index < mCount; index = mNextIndex.fetch_add(1))
+							// Perform
+							mProc(index, mProcUserData);
+					}
+
+		UInt32				mWorkerCount;
+		TNArray<I<Worker> >	mWorkers;
+		std::atomic<bool>	mIsBusy;
+
+		Proc				mProc;
+		void*				mProcUserData;
+		UInt32				mCount;
+		std::atomic<UInt32>	mNextIndex;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+//----------------------------------------------------------------------------------------------------------------------
+// MARK: - CMDSWorkerPool
+
+// MARK: Lifecycle methods
+
+//----------------------------------------------------------------------------------------------------------------------
+CMDSWorkerPool::CMDSWorkerPool(const OV<UInt32>& workerCount)
+//----------------------------------------------------------------------------------------------------------------------
+{
+	// Setup.  By default, the calling thread plus one worker for each additional core.
+	UInt32	hardwareConcurrency = std::thread::hardware_concurrency();
+
+	mInternals =
+			new Internals(workerCount.hasValue() ? *workerCount :
+					((hardwareConcurrency > 1) ? hardwareConcurrency - 1 : 0));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+CMDSWorkerPool::~CMDSWorkerPool()
+//----------------------------------------------------------------------------------------------------------------------
+{
+	Delete(mInternals);
+}
+
+// MARK: Instance methods
+
+//----------------------------------------------------------------------------------------------------------------------
+void CMDSWorkerPool::perform(UInt32 count, Proc proc, void* userData)
+//----------------------------------------------------------------------------------------------------------------------
+{
+	// Check if fanning out is possible and worthwhile
+	bool	isBusy = false;
+	if ((count < 2) || (mInternals->mWorkerCount == 0) ||
+			!mInternals->mIsBusy.compare_exchange_strong(isBusy, true)) {
+		// Perform serially
+		for (UInt32 i = 0; i < count; i++)
+			// Perform
+			proc(i, userData);
+
+		return;
+	}
+
+	// Setup.  Workers are only created once there is something for them to do.
+	mInternals->createWorkersIfNeeded();
+	mInternals->mProc = proc;
+	mInternals->mProcUserData = userData;
+	mInternals->mCount = count;
+	mInternals->mNextIndex = 0;
+
+	// Start workers.  The calling thread takes part, so no more than count - 1 workers can have anything to do.
+	UInt32	workerCount = std::min<UInt32>(count - 1, mInternals->mWorkers.getCount());
+	for (UInt32 i = 0; i < workerCount; i++)
+		// Start
+		mInternals->mWorkers[i]->perform();
+
+	// Perform on this thread as well
+	mInternals->performAvailable();
+
+	// Wait for workers
+	for (UInt32 i = 0; i < workerCount; i++)
+		// Wait
+		mInternals->mWorkers[i]->waitUntilDone();
+
+	// Done
+	mInternals->mIsBusy = false;
+}
+
+// MARK: Class methods
+
+//----------------------------------------------------------------------------------------------------------------------
+CMDSWorkerPool& CMDSWorkerPool::getShared()
+//----------------------------------------------------------------------------------------------------------------------
+{
+	// Setup
+	static	CMDSWorkerPool	sWorkerPool;
+
+	return sWorkerPool;
+}
@@ -0,0 +1,42 @@
+//----------------------------------------------------------------------------------------------------------------------
+//	CMDSWorkerPool.h			©2026 Stevo Brock	All rights reserved.
+//----------------------------------------------------------------------------------------------------------------------
+
+#pragma once
+
+#include "TWrappers.h"
+
+//----------------------------------------------------------------------------------------------------------------------
+// MARK: CMDSWorkerPool
+
+// Performs a Proc once for each index in a range, spread across a fixed set of worker threads and the calling thread.
+//	Each participant claims the next unclaimed index until none remain, so a few slow indexes do not hold up the rest.
+//	Only one perform() uses the workers at a time; a perform() made while they are busy (including from within a Proc)
+//	is performed serially on the calling thread.  Worker threads are created on the first perform() that fans out, and
+//	document storages share one pool so their threads do not multiply with each instance.
+
+class CMDSWorkerPool {
+	// Procs
+	public:
+		typedef	void	(*Proc)(UInt32 index, void* userData);
+
+	// Classes
+	private:
+		class Internals;
+
+	// Methods
+	public:
+								// Lifecycle methods
+								CMDSWorkerPool(const OV<UInt32>& workerCount = OV<UInt32>());
+								~CMDSWorkerPool();
+
+								// Instance methods
+		void					perform(UInt32 count, Proc proc, void* userData);
+
+								// Class methods
+		static	CMDSWorkerPool&	getShared();
+
+	// Properties
+	private:
+		Internals*	mInternals;
+};
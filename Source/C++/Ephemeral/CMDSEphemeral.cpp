@@ -4,7 +4,7 @@
 
 #include "CMDSEphemeral.h"
 
-#include "CThread.h"
+#include "CMDSWorkerPool.h"
 #include "CUUID.h"
 #include "SError.h"
 #include "TLockingDictionary.h"
@@ -13,6 +13,8 @@
 #include "TMDSCollection.h"
 #include "TMDSIndex.h"
 
+#include <atomic>
+
 //----------------------------------------------------------------------------------------------------------------------
 // MARK: Types
 
@@ -30,6 +32,377 @@ typedef	TMDSUpdateInfo<CString>							MDSUpdateInfo;
 //----------------------------------------------------------------------------------------------------------------------
 // MARK: - CMDSEphemeral::Internals
 class CMDSEphemeral::Internals {
+	// DocumentIDsPage
+	public:
+		struct DocumentIDsPage {
+			// Methods
+			public:
+											// Lifecycle methods
+											DocumentIDsPage() {}
+											DocumentIDsPage(const TArray<CString>& documentIDs,
+													const OV<CString>& continuationToken) :
+												mDocumentIDs(documentIDs), mContinuationToken(continuationToken)
+												{}
+											DocumentIDsPage(const DocumentIDsPage& other) :
+												mDocumentIDs(other.mDocumentIDs),
+														mContinuationToken(other.mContinuationToken)
+												{}
+
+											// Instance methods
+				const	TArray<CString>&	getDocumentIDs() const
+												{ return mDocumentIDs; }
+				const	OV<CString>&		getContinuationToken() const
+												{ return mContinuationToken; }
+
+			// Properties
+			private:
+				TNArray<CString>	mDocumentIDs;
+				OV<CString>			mContinuationToken;
+		};
+
+	// OrderedDocumentIDs
+	public:
+		class OrderedDocumentIDs {
+			// Methods
+			public:
+										// Lifecycle methods
+										OrderedDocumentIDs() : mCount(0), mNextSequence(0) {}
+										OrderedDocumentIDs(const OrderedDocumentIDs& other) :
+											mDocumentIDs(other.mDocumentIDs), mSequences(other.mSequences),
+													mIndexByDocumentID(other.mIndexByDocumentID),
+													mCount(other.mCount), mNextSequence(other.mNextSequence)
+											{}
+
+										// Instance methods
+				UInt32					getCount() const
+											{ return mCount; }
+				bool					contains(const CString& documentID) const
+											{ return mIndexByDocumentID.contains(documentID); }
+				void					add(const TArray<CString>& documentIDs)
+											{
+												// Iterate document IDs
+												for (TArray<CString>::Iterator iterator = documentIDs.getIterator();
+														iterator; iterator++) {
+													// Check if already included
+													if (mIndexByDocumentID.contains(*iterator))
+														// Keep existing position
+														continue;
+
+													// Add
+													mIndexByDocumentID.set(*iterator,
+															TNumber<UInt32>(mDocumentIDs.getCount()));
+													mDocumentIDs += *iterator;
+													mSequences += TNumber<SInt64>(mNextSequence++);
+													mCount++;
+												}
+											}
+				void					remove(const TArray<CString>& documentIDs)
+											{
+												// Iterate document IDs
+												for (TArray<CString>::Iterator iterator = documentIDs.getIterator();
+														iterator; iterator++) {
+													// Check if included
+													if (!mIndexByDocumentID.contains(*iterator))
+														// Not included
+														continue;
+
+													// Remove.  The slot in mDocumentIDs stays behind until the
+													//	next compact.
+													mIndexByDocumentID.remove(*iterator);
+													mCount--;
+												}
+
+												// Check if should compact
+												if ((mDocumentIDs.getCount() - mCount) > mCount)
+													// Compact
+													compact();
+											}
+				void					remove(const TSet<CString>& documentIDs)
+											{ remove(documentIDs.getArray()); }
+
+				TNArray<CString>		getDocumentIDs(UInt32 startIndex = 0,
+												const OV<UInt32>& count = OV<UInt32>()) const
+											{
+												// Setup
+												TNArray<CString>	documentIDs;
+												UInt32				index =
+																			(mDocumentIDs.getCount() == mCount) ?
+																					startIndex : 0;
+												UInt32				skipCount =
+																			(mDocumentIDs.getCount() == mCount) ?
+																					0 : startIndex;
+
+												// Collect
+												for (; (index < mDocumentIDs.getCount()) &&
+																(!count.hasValue() ||
+																		(documentIDs.getCount() < *count));
+														index++) {
+													// Check if current
+													if (!isCurrent(index))
+														// Removed
+														continue;
+													else if (skipCount > 0)
+														// Before start index
+														skipCount--;
+													else
+														// Add
+														documentIDs += mDocumentIDs[index];
+												}
+
+												return documentIDs;
+											}
+				DocumentIDsPage			getDocumentIDsPage(const OV<SInt64>& afterSequence, UInt32 count) const
+											{
+												// The continuation token is the sequence of the last slot of the
+												//	previous page.  Sequences never change and only increase along
+												//	mDocumentIDs (compact keeps the order), so the next page starts at
+												//	the first slot past it whether or not that document is still here.
+												UInt32	index = 0;
+												if (afterSequence.hasValue()) {
+													// Binary search
+													UInt32	endIndex = mDocumentIDs.getCount();
+													while (index < endIndex) {
+														// Check middle
+														UInt32	middleIndex = index + (endIndex - index) / 2;
+														if (*mSequences[middleIndex] <= *afterSequence)
+															// After middle
+															index = middleIndex + 1;
+														else
+															// At or before middle
+															endIndex = middleIndex;
+													}
+												}
+
+												// Collect
+												TNArray<CString>	documentIDs;
+												SInt64				lastSequence = 0;
+												for (; (index < mDocumentIDs.getCount()) &&
+																(documentIDs.getCount() < count);
+														index++) {
+													// Check if current
+													if (isCurrent(index)) {
+														// Add
+														documentIDs += mDocumentIDs[index];
+														lastSequence = *mSequences[index];
+													}
+												}
+
+												// A short page is the last page
+												return DocumentIDsPage(documentIDs,
+														((count > 0) && (documentIDs.getCount() == count)) ?
+																OV<CString>(CString(lastSequence)) : OV<CString>());
+											}
+
+			private:
+				bool					isCurrent(UInt32 index) const
+											{
+												// A slot is current when the document ID still maps to it
+												const	OR<TNumber<UInt32> >	documentIDIndex =
+																						mIndexByDocumentID[
+																								mDocumentIDs[index]];
+
+												return documentIDIndex.hasReference() && (**documentIDIndex == index);
+											}
+				void					compact()
+											{
+												// Rebuild with only current slots
+												TNArray<CString>			documentIDs;
+												TNArray<TNumber<SInt64> >	sequences;
+												for (UInt32 index = 0; index < mDocumentIDs.getCount(); index++) {
+													// Check if current
+													if (isCurrent(index)) {
+														// Move
+														mIndexByDocumentID.set(mDocumentIDs[index],
+																TNumber<UInt32>(documentIDs.getCount()));
+														documentIDs += mDocumentIDs[index];
+														sequences += mSequences[index];
+													}
+												}
+												mDocumentIDs = documentIDs;
+												mSequences = sequences;
+											}
+
+			// Properties
+			private:
+				TNArray<CString>				mDocumentIDs;
+				TNArray<TNumber<SInt64> >		mSequences;
+				TNDictionary<TNumber<UInt32> >	mIndexByDocumentID;
+				UInt32							mCount;
+				SInt64							mNextSequence;
+		};
+
+	// AssociationAdjacency
+	public:
+		class AssociationAdjacency {
+			// Methods
+			public:
+												// Lifecycle methods
+												AssociationAdjacency() {}
+												AssociationAdjacency(const AssociationAdjacency& other) :
+													mToDocumentIDsByFromDocumentID(
+															other.mToDocumentIDsByFromDocumentID),
+															mFromDocumentIDsByToDocumentID(
+																	other.mFromDocumentIDsByToDocumentID)
+													{}
+
+												// Instance methods
+				TNArray<CMDSAssociation::Item>	getItems() const
+													{
+														// Setup
+														TNArray<CMDSAssociation::Item>	items;
+														TSet<CString>					fromDocumentIDs =
+																mToDocumentIDsByFromDocumentID.getKeys();
+
+														// Iterate from document IDs
+														for (TSet<CString>::Iterator fromIterator =
+																		fromDocumentIDs.getIterator();
+																fromIterator; fromIterator++) {
+															// Iterate to document IDs
+															TArray<CString>	toDocumentIDs =
+																					getToDocumentIDs(*fromIterator);
+															for (TArray<CString>::Iterator toIterator =
+																			toDocumentIDs.getIterator();
+																	toIterator; toIterator++)
+																// Add item
+																items +=
+																		CMDSAssociation::Item(*fromIterator,
+																				*toIterator);
+														}
+
+														return items;
+													}
+				TNArray<CString>				getFromDocumentIDs(const CString& toDocumentID) const
+													{
+														// Get from document IDs
+														const	OR<OrderedDocumentIDs>	fromDocumentIDs =
+																mFromDocumentIDsByToDocumentID.get(toDocumentID);
+
+														return fromDocumentIDs.hasReference() ?
+																fromDocumentIDs->getDocumentIDs() : TNArray<CString>();
+													}
+				OrderedDocumentIDs				getOrderedFromDocumentIDs(const CString& toDocumentID) const
+													{
+														// Get from document IDs
+														const	OR<OrderedDocumentIDs>	fromDocumentIDs =
+																mFromDocumentIDsByToDocumentID.get(toDocumentID);
+
+														return fromDocumentIDs.hasReference() ?
+																*fromDocumentIDs : OrderedDocumentIDs();
+													}
+				DocumentIDsPage					getFromDocumentIDsPage(const CString& toDocumentID,
+														const OV<SInt64>& afterSequence, UInt32 count) const
+													{
+														// Get from document IDs
+														const	OR<OrderedDocumentIDs>	fromDocumentIDs =
+																mFromDocumentIDsByToDocumentID.get(toDocumentID);
+
+														return fromDocumentIDs.hasReference() ?
+																fromDocumentIDs->getDocumentIDsPage(afterSequence,
+																		count) :
+																DocumentIDsPage();
+													}
+				TNArray<CString>				getToDocumentIDs(const CString& fromDocumentID) const
+													{
+														// Get to document IDs
+														const	OR<OrderedDocumentIDs>	toDocumentIDs =
+																mToDocumentIDsByFromDocumentID.get(fromDocumentID);
+
+														return toDocumentIDs.hasReference() ?
+																toDocumentIDs->getDocumentIDs() : TNArray<CString>();
+													}
+				OrderedDocumentIDs				getOrderedToDocumentIDs(const CString& fromDocumentID) const
+													{
+														// Get to document IDs
+														const	OR<OrderedDocumentIDs>	toDocumentIDs =
+																mToDocumentIDsByFromDocumentID.get(fromDocumentID);
+
+														return toDocumentIDs.hasReference() ?
+																*toDocumentIDs : OrderedDocumentIDs();
+													}
+				DocumentIDsPage					getToDocumentIDsPage(const CString& fromDocumentID,
+														const OV<SInt64>& afterSequence, UInt32 count) const
+													{
+														// Get to document IDs
+														const	OR<OrderedDocumentIDs>	toDocumentIDs =
+																mToDocumentIDsByFromDocumentID.get(fromDocumentID);
+
+														return toDocumentIDs.hasReference() ?
+																toDocumentIDs->getDocumentIDsPage(afterSequence,
+																		count) :
+																DocumentIDsPage();
+													}
+				void							update(const TArray<CMDSAssociation::Update>& updates)
+													{
+														// Iterate updates
+														for (TArray<CMDSAssociation::Update>::Iterator iterator =
+																		updates.getIterator();
+																iterator; iterator++) {
+															// Setup
+															const	CString&	fromDocumentID =
+																						iterator->getItem()
+																								.getFromDocumentID();
+															const	CString&	toDocumentID =
+																						iterator->getItem()
+																								.getToDocumentID();
+
+															// Check Add or Remove
+															if (iterator->getAction() ==
+																	CMDSAssociation::Update::kActionAdd) {
+																// Add
+																add(mToDocumentIDsByFromDocumentID, fromDocumentID,
+																		toDocumentID);
+																add(mFromDocumentIDsByToDocumentID, toDocumentID,
+																		fromDocumentID);
+															} else {
+																// Remove
+																remove(mToDocumentIDsByFromDocumentID, fromDocumentID,
+																		toDocumentID);
+																remove(mFromDocumentIDsByToDocumentID, toDocumentID,
+																		fromDocumentID);
+															}
+														}
+													}
+
+			private:
+				static	void					add(TNDictionary<OrderedDocumentIDs>& orderedDocumentIDsByDocumentID,
+														const CString& documentID, const CString& otherDocumentID)
+													{
+														// Check if first
+														if (!orderedDocumentIDsByDocumentID.contains(documentID))
+															// Start empty
+															orderedDocumentIDsByDocumentID.set(documentID,
+																	OrderedDocumentIDs());
+
+														// Add
+														orderedDocumentIDsByDocumentID.get(documentID)->add(
+																TSArray<CString>(otherDocumentID));
+													}
+				static	void					remove(
+														TNDictionary<OrderedDocumentIDs>&
+																orderedDocumentIDsByDocumentID,
+														const CString& documentID, const CString& otherDocumentID)
+													{
+														// Check if have
+														OR<OrderedDocumentIDs>	orderedDocumentIDs =
+																						orderedDocumentIDsByDocumentID
+																								.get(documentID);
+														if (!orderedDocumentIDs.hasReference())
+															// Don't have
+															return;
+
+														// Remove
+														orderedDocumentIDs->remove(TSArray<CString>(otherDocumentID));
+														if (orderedDocumentIDs->getCount() == 0)
+															// Now empty
+															orderedDocumentIDsByDocumentID.remove(documentID);
+													}
+
+			// Properties
+			private:
+				TNDictionary<OrderedDocumentIDs>	mToDocumentIDsByFromDocumentID;
+				TNDictionary<OrderedDocumentIDs>	mFromDocumentIDsByToDocumentID;
+		};
+
 	// AttachmentContentInfo
 	public:
 		struct AttachmentContentInfo {
@@ -201,12 +574,6 @@ class CMDSEphemeral::Internals {
 															mModificationUniversalTime = SUniversalTime::getCurrent();
 														}
 
-													// Class methods
-		static	bool								compareRevision(const I<DocumentBacking>& documentBacking1,
-															const I<DocumentBacking>& documentBacking2, void* userData)
-														{ return documentBacking1->getRevision() <
-																documentBacking2->getRevision(); }
-
 			// Properties
 			private:
 				CString								mDocumentID;
@@ -219,6 +586,284 @@ class CMDSEphemeral::Internals {
 				TNDictionary<AttachmentContentInfo>	mAttachmentContentInfoByAttachmentID;
 		};
 
+	// IndexValues
+	public:
+		class IndexValues {
+			// Methods
+			public:
+											// Lifecycle methods
+											IndexValues() {}
+											IndexValues(const IndexValues& other) :
+												mDocumentIDByKey(other.mDocumentIDByKey),
+														mKeysByDocumentID(other.mKeysByDocumentID)
+												{}
+
+											// Instance methods
+		const	TNDictionary<CString>&		getDocumentIDByKey() const
+												{ return mDocumentIDByKey; }
+				void						update(const TArray<MDSIndex::KeysInfo>& keysInfos)
+												{
+													// Iterate keys infos
+													for (TArray<MDSIndex::KeysInfo>::Iterator iterator =
+																	keysInfos.getIterator();
+															iterator; iterator++) {
+														// Remove existing keys for this document
+														remove(iterator->getID());
+
+														// Add keys
+														const	TArray<CString>&	keys = iterator->getKeys();
+														for (TArray<CString>::Iterator keyIterator = keys.getIterator();
+																keyIterator; keyIterator++) {
+															// Check if key is moving from another document
+															const	OR<CString>	documentID =
+																						mDocumentIDByKey[*keyIterator];
+															if (documentID.hasReference() &&
+																	(*documentID != iterator->getID()))
+																// Remove from other document
+																mKeysByDocumentID.get(*documentID)->remove(
+																		*keyIterator);
+
+															// Add
+															mDocumentIDByKey.set(*keyIterator, iterator->getID());
+														}
+														if (!keys.isEmpty())
+															// Note keys
+															mKeysByDocumentID.set(iterator->getID(),
+																	TNArray<CString>(keys));
+													}
+												}
+				void						remove(const CString& documentID)
+												{
+													// Check if have keys for this document
+													const	OR<TNArray<CString> >	keys =
+																							mKeysByDocumentID.get(
+																									documentID);
+													if (!keys.hasReference())
+														// Nothing to remove
+														return;
+
+													// Remove keys
+													for (TArray<CString>::Iterator iterator = keys->getIterator();
+															iterator; iterator++)
+														// Remove key
+														mDocumentIDByKey.remove(*iterator);
+													mKeysByDocumentID.remove(documentID);
+												}
+
+			// Properties
+			private:
+				TNDictionary<CString>			mDocumentIDByKey;
+				TNDictionary<TNArray<CString> >	mKeysByDocumentID;
+		};
+
+	// RevisionLog
+	public:
+		class RevisionLog {
+			// Entry
+			public:
+				struct Entry {
+					// Methods
+					public:
+												// Lifecycle methods
+												Entry(UInt32 revision, const CString& documentID) :
+													mRevision(revision), mDocumentID(documentID)
+													{}
+												Entry(const Entry& other) :
+													mRevision(other.mRevision), mDocumentID(other.mDocumentID)
+													{}
+
+												// Instance methods
+								UInt32			getRevision() const
+													{ return mRevision; }
+						const	CString&		getDocumentID() const
+													{ return mDocumentID; }
+
+					// Properties
+					private:
+						UInt32	mRevision;
+						CString	mDocumentID;
+				};
+
+			// Methods
+			public:
+										// Lifecycle methods
+										RevisionLog() : mDocumentCount(0) {}
+										RevisionLog(const RevisionLog& other) :
+											mEntries(other.mEntries), mRevisionByDocumentID(other.mRevisionByDocumentID),
+													mDocumentCount(other.mDocumentCount)
+											{}
+
+										// Instance methods
+				UInt32					getEntryCount() const
+											{ return mEntries.getCount(); }
+		const	Entry&					getEntry(UInt32 index) const
+											{ return mEntries[index]; }
+				bool					isCurrent(UInt32 index) const
+											{
+												// An entry is current when it holds the document's latest revision
+												const	Entry&					entry = mEntries[index];
+												const	OR<TNumber<UInt32> >	revision =
+																						mRevisionByDocumentID[
+																								entry.getDocumentID()];
+
+												return revision.hasReference() &&
+														(**revision == entry.getRevision());
+											}
+				UInt32					getFirstEntryIndexAfter(UInt32 revision) const
+											{
+												// Binary search
+												UInt32	lowIndex = 0;
+												UInt32	highIndex = mEntries.getCount();
+												while (lowIndex < highIndex) {
+													// Check middle
+													UInt32	middleIndex = lowIndex + (highIndex - lowIndex) / 2;
+													if (mEntries[middleIndex].getRevision() <= revision)
+														// After middle
+														lowIndex = middleIndex + 1;
+													else
+														// At or before middle
+														highIndex = middleIndex;
+												}
+
+												return lowIndex;
+											}
+				void					note(const CString& documentID, UInt32 revision)
+											{
+												// Update latest revision
+												if (!mRevisionByDocumentID.contains(documentID))
+													// New document
+													mDocumentCount++;
+												mRevisionByDocumentID.set(documentID, TNumber<UInt32>(revision));
+
+												// Add entry
+												if (mEntries.isEmpty() ||
+														(mEntries[mEntries.getCount() - 1].getRevision() < revision))
+													// Append
+													mEntries += Entry(revision, documentID);
+												else
+													// Revisions are handed out before the partition lock is taken so a
+													//	racing writer can land here out of order
+													mEntries.insertAtIndex(Entry(revision, documentID),
+															getFirstEntryIndexAfter(revision));
+
+												// Check if should compact
+												if ((mEntries.getCount() - mDocumentCount) > mDocumentCount) {
+													// Keep only current entries
+													TNArray<Entry>	entries;
+													for (UInt32 index = 0; index < mEntries.getCount(); index++) {
+														// Check if current
+														if (isCurrent(index))
+															// Keep
+															entries += mEntries[index];
+													}
+													mEntries = entries;
+												}
+											}
+
+			// Properties
+			private:
+				TNArray<Entry>					mEntries;
+				TNDictionary<TNumber<UInt32> >	mRevisionByDocumentID;
+				UInt32							mDocumentCount;
+		};
+
+	// DocumentTypePartition
+	public:
+		class DocumentTypePartition {
+			// Methods
+			public:
+										// Lifecycle methods
+										DocumentTypePartition() : mLastRevision(0) {}
+
+										// Instance methods
+				UInt32					getLastRevision() const
+											{ return mLastRevision.load(); }
+				UInt32					nextRevision()
+											{ return mLastRevision.fetch_add(1) + 1; }
+
+				UInt32					getDocumentCount() const
+											{ return mDocumentBackingByDocumentID.getKeyCount(); }
+				OR<I<DocumentBacking> >	getDocumentBacking(const CString& documentID)
+											{ return mDocumentBackingByDocumentID.get(documentID); }
+				void					add(const I<DocumentBacking>& documentBacking)
+											{
+												// Add and note revision
+												mDocumentBackingByDocumentID.set(documentBacking->getDocumentID(),
+														documentBacking);
+												noteRevision(*documentBacking);
+											}
+				void					noteRevision(const DocumentBacking& documentBacking)
+											{ mRevisionLog.note(documentBacking.getDocumentID(),
+													documentBacking.getRevision()); }
+
+			// Properties
+			public:
+				TNDictionary<I<DocumentBacking> >	mDocumentBackingByDocumentID;
+				RevisionLog							mRevisionLog;
+				CReadPreferringLock					mLock;
+
+			private:
+				std::atomic<UInt32>					mLastRevision;
+		};
+
+	// ViewsUpdate
+	public:
+		class ViewsUpdate {
+			// Methods
+			public:
+								// Lifecycle methods
+								ViewsUpdate(Internals& internals, const OR<TNArray<I<MDSCache> > >& caches,
+										const OR<TNArray<I<MDSCollection> > >& collections,
+										const OR<TNArray<I<MDSIndex> > >& indexes,
+										const TArray<MDSUpdateInfo>& updateInfos) :
+									mInternals(internals),
+											mCaches(caches.hasReference() ? *caches : TNArray<I<MDSCache> >()),
+											mCollections(collections.hasReference() ?
+													*collections : TNArray<I<MDSCollection> >()),
+											mIndexes(indexes.hasReference() ? *indexes : TNArray<I<MDSIndex> >()),
+											mUpdateInfos(updateInfos)
+									{}
+
+								// Instance methods
+				UInt32			getCount() const
+									{ return mCaches.getCount() + mCollections.getCount() + mIndexes.getCount(); }
+
+								// Class methods
+		static	void			perform(UInt32 index, ViewsUpdate* viewsUpdate)
+									{
+										// Update the cache, collection or index at this index
+										if (index < viewsUpdate->mCaches.getCount()) {
+											// Update cache
+											viewsUpdate->mInternals.cacheUpdate(viewsUpdate->mCaches[index],
+													viewsUpdate->mUpdateInfos);
+
+											return;
+										}
+										index -= viewsUpdate->mCaches.getCount();
+
+										if (index < viewsUpdate->mCollections.getCount()) {
+											// Update collection
+											viewsUpdate->mInternals.collectionUpdate(
+													viewsUpdate->mCollections[index], viewsUpdate->mUpdateInfos);
+
+											return;
+										}
+										index -= viewsUpdate->mCollections.getCount();
+
+										// Update index
+										viewsUpdate->mInternals.indexUpdate(viewsUpdate->mIndexes[index],
+												viewsUpdate->mUpdateInfos);
+									}
+
+			// Properties
+			private:
+						Internals&					mInternals;
+						TNArray<I<MDSCache> >		mCaches;
+						TNArray<I<MDSCollection> >	mCollections;
+						TNArray<I<MDSIndex> >		mIndexes;
+				const	TArray<MDSUpdateInfo>&		mUpdateInfos;
+		};
+
 	// More Types
 	public:
 		typedef	TMDSBatch<I<DocumentBacking> >				Batch;
@@ -239,17 +884,18 @@ class CMDSEphemeral::Internals {
 				TArray<CMDSAssociation::Item>	associationGetItems(const CString& name) const
 													{
 														// Get association items
-														mDocumentMapsLock.lockForReading();
 														TNArray<CMDSAssociation::Item>	associationItems;
-														if (mAssociationItemsByName.contains(name))
-															associationItems = *mAssociationItemsByName.get(name);
-														mDocumentMapsLock.unlockForReading();
+														mAssociationAdjacencyLock.lockForReading();
+														const	OR<AssociationAdjacency>	associationAdjacency =
+																mAssociationAdjacencyByName.get(name);
+														if (associationAdjacency.hasReference())
+															// Copy
+															associationItems = associationAdjacency->getItems();
+														mAssociationAdjacencyLock.unlockForReading();
 
 														// Check for batch
 														OR<I<Batch> >	batch =
-																				mBatchByThreadRef[
-																						CThread::
-																								getCurrentRefAsString()];
+																				mBatchByThread.get();
 														if (batch.hasReference())
 															// Apply batch changes
 															associationItems =
@@ -258,6 +904,241 @@ class CMDSEphemeral::Internals {
 
 														return associationItems;
 													}
+				TArray<CString>					associationGetFromDocumentIDs(const CString& name,
+														const CString& toDocumentID) const
+													{
+														// Get from document IDs
+														TNArray<CString>	fromDocumentIDs;
+														mAssociationAdjacencyLock.lockForReading();
+														const	OR<AssociationAdjacency>	associationAdjacency =
+																mAssociationAdjacencyByName.get(name);
+														if (associationAdjacency.hasReference())
+															// Copy
+															fromDocumentIDs =
+																	associationAdjacency->getFromDocumentIDs(
+																			toDocumentID);
+														mAssociationAdjacencyLock.unlockForReading();
+
+														// Check for batch
+														OR<I<Batch> >	batch = mBatchByThread.get();
+														if (batch.hasReference() &&
+																(*batch)->associationGetUpdatedNames().contains(name)) {
+															// Apply batch changes that touch this to document ID
+															TArray<CMDSAssociation::Update>	associationUpdates =
+																	(*batch)->associationGetUpdates(name);
+															for (TArray<CMDSAssociation::Update>::Iterator iterator =
+																			associationUpdates.getIterator();
+																	iterator; iterator++) {
+																// Check update
+																if (iterator->getItem().getToDocumentID() !=
+																		toDocumentID)
+																	// Different to document ID
+																	continue;
+																else if (iterator->getAction() ==
+																		CMDSAssociation::Update::kActionAdd)
+																	// Add
+																	fromDocumentIDs +=
+																			iterator->getItem().getFromDocumentID();
+																else
+																	// Remove
+																	fromDocumentIDs.remove(
+																			iterator->getItem().getFromDocumentID());
+															}
+														}
+
+														return fromDocumentIDs;
+													}
+				TArray<CString>					associationGetToDocumentIDs(const CString& name,
+														const CString& fromDocumentID) const
+													{
+														// Get to document IDs
+														TNArray<CString>	toDocumentIDs;
+														mAssociationAdjacencyLock.lockForReading();
+														const	OR<AssociationAdjacency>	associationAdjacency =
+																mAssociationAdjacencyByName.get(name);
+														if (associationAdjacency.hasReference())
+															// Copy
+															toDocumentIDs =
+																	associationAdjacency->getToDocumentIDs(
+																			fromDocumentID);
+														mAssociationAdjacencyLock.unlockForReading();
+
+														// Check for batch
+														OR<I<Batch> >	batch = mBatchByThread.get();
+														if (batch.hasReference() &&
+																(*batch)->associationGetUpdatedNames().contains(name)) {
+															// Apply batch changes that touch this from document ID
+															TArray<CMDSAssociation::Update>	associationUpdates =
+																	(*batch)->associationGetUpdates(name);
+															for (TArray<CMDSAssociation::Update>::Iterator iterator =
+																			associationUpdates.getIterator();
+																	iterator; iterator++) {
+																// Check update
+																if (iterator->getItem().getFromDocumentID() !=
+																		fromDocumentID)
+																	// Different from document ID
+																	continue;
+																else if (iterator->getAction() ==
+																		CMDSAssociation::Update::kActionAdd)
+																	// Add
+																	toDocumentIDs +=
+																			iterator->getItem().getToDocumentID();
+																else
+																	// Remove
+																	toDocumentIDs.remove(
+																			iterator->getItem().getToDocumentID());
+															}
+														}
+
+														return toDocumentIDs;
+													}
+				DocumentIDsPage					associationGetFromDocumentIDsPage(const CString& name,
+														const CString& toDocumentID, const OV<SInt64>& afterSequence,
+														UInt32 count) const
+													{
+														// Check for batch
+														mAssociationAdjacencyLock.lockForReading();
+														const	OR<AssociationAdjacency>	associationAdjacency =
+																mAssociationAdjacencyByName.get(name);
+														OR<I<Batch> >						batch =
+																mBatchByThread.get();
+														if (!batch.hasReference() ||
+																!(*batch)->associationGetUpdatedNames().contains(name)) {
+															// Page directly
+															DocumentIDsPage	documentIDsPage;
+															if (associationAdjacency.hasReference())
+																// Get page
+																documentIDsPage =
+																		associationAdjacency->getFromDocumentIDsPage(
+																				toDocumentID, afterSequence, count);
+															mAssociationAdjacencyLock.unlockForReading();
+
+															return documentIDsPage;
+														}
+
+														// Copy so batch changes can be applied.  Added document IDs
+														//	get new sequences so existing tokens stay valid.
+														OrderedDocumentIDs	fromDocumentIDs;
+														if (associationAdjacency.hasReference())
+															// Copy
+															fromDocumentIDs =
+																	associationAdjacency->getOrderedFromDocumentIDs(
+																			toDocumentID);
+														mAssociationAdjacencyLock.unlockForReading();
+
+														// Apply batch changes that touch this to document ID
+														TArray<CMDSAssociation::Update>	associationUpdates =
+																(*batch)->associationGetUpdates(name);
+														for (TArray<CMDSAssociation::Update>::Iterator iterator =
+																		associationUpdates.getIterator();
+																iterator; iterator++) {
+															// Check update
+															if (iterator->getItem().getToDocumentID() != toDocumentID)
+																// Different to document ID
+																continue;
+															else if (iterator->getAction() ==
+																	CMDSAssociation::Update::kActionAdd)
+																// Add
+																fromDocumentIDs.add(
+																		TSArray<CString>(
+																				iterator->getItem()
+																						.getFromDocumentID()));
+															else
+																// Remove
+																fromDocumentIDs.remove(
+																		TSArray<CString>(
+																				iterator->getItem()
+																						.getFromDocumentID()));
+														}
+
+														return fromDocumentIDs.getDocumentIDsPage(afterSequence, count);
+													}
+				DocumentIDsPage					associationGetToDocumentIDsPage(const CString& name,
+														const CString& fromDocumentID,
+														const OV<SInt64>& afterSequence, UInt32 count) const
+													{
+														// Check for batch
+														mAssociationAdjacencyLock.lockForReading();
+														const	OR<AssociationAdjacency>	associationAdjacency =
+																mAssociationAdjacencyByName.get(name);
+														OR<I<Batch> >						batch =
+																mBatchByThread.get();
+														if (!batch.hasReference() ||
+																!(*batch)->associationGetUpdatedNames().contains(name)) {
+															// Page directly
+															DocumentIDsPage	documentIDsPage;
+															if (associationAdjacency.hasReference())
+																// Get page
+																documentIDsPage =
+																		associationAdjacency->getToDocumentIDsPage(
+																				fromDocumentID, afterSequence, count);
+															mAssociationAdjacencyLock.unlockForReading();
+
+															return documentIDsPage;
+														}
+
+														// Copy so batch changes can be applied.  Added document IDs
+														//	get new sequences so existing tokens stay valid.
+														OrderedDocumentIDs	toDocumentIDs;
+														if (associationAdjacency.hasReference())
+															// Copy
+															toDocumentIDs =
+																	associationAdjacency->getOrderedToDocumentIDs(
+																			fromDocumentID);
+														mAssociationAdjacencyLock.unlockForReading();
+
+														// Apply batch changes that touch this from document ID
+														TArray<CMDSAssociation::Update>	associationUpdates =
+																(*batch)->associationGetUpdates(name);
+														for (TArray<CMDSAssociation::Update>::Iterator iterator =
+																		associationUpdates.getIterator();
+																iterator; iterator++) {
+															// Check update
+															if (iterator->getItem().getFromDocumentID() !=
+																	fromDocumentID)
+																// Different from document ID
+																continue;
+															else if (iterator->getAction() ==
+																	CMDSAssociation::Update::kActionAdd)
+																// Add
+																toDocumentIDs.add(
+																		TSArray<CString>(
+																				iterator->getItem().getToDocumentID()));
+															else
+																// Remove
+																toDocumentIDs.remove(
+																		TSArray<CString>(
+																				iterator->getItem().getToDocumentID()));
+														}
+
+														return toDocumentIDs.getDocumentIDsPage(afterSequence, count);
+													}
+				void							associationUpdate(const CString& name,
+														const TArray<CMDSAssociation::Update>& updates)
+													{
+														// Update association adjacency
+														mAssociationAdjacencyLock.lockForWriting();
+														OR<AssociationAdjacency>	associationAdjacency =
+																		mAssociationAdjacencyByName.get(name);
+														if (associationAdjacency.hasReference())
+															// Update
+															associationAdjacency->update(updates);
+														mAssociationAdjacencyLock.unlockForWriting();
+													}
+				OV<MDSCacheValueMap>			cacheGetValueMap(const CString& name) const
+													{
+														// Get cache value map
+														OV<MDSCacheValueMap>	cacheValueMap;
+														mCacheValuesLock.lockForReading();
+														const	OR<MDSCacheValueMap>	currentCacheValueMap =
+																mCacheValuesByName.get(name);
+														if (currentCacheValueMap.hasReference())
+															// Copy
+															cacheValueMap.setValue(*currentCacheValueMap);
+														mCacheValuesLock.unlockForReading();
+
+														return cacheValueMap;
+													}
 				void							cacheUpdate(const I<MDSCache>& cache,
 														const TArray<MDSUpdateInfo>& updateInfos)
 													{
@@ -270,12 +1151,58 @@ class CMDSEphemeral::Internals {
 																												.getValueInfoByID();
 
 														// Check if have updates
-														if (valueInfoByID.hasValue())
+														if (valueInfoByID.hasValue()) {
 															// Update storage
-															mCacheValuesByName.update(cache->getName(),
-																	(TNLockingDictionary<MDSCacheValueMap>::UpdateProc)
-																			updateCacheValueMapWithUpdateInfosByID,
-																	(void*) &(*valueInfoByID));
+															mCacheValuesLock.lockForWriting();
+															if (!mCacheValuesByName.contains(cache->getName()))
+																// Start empty
+																mCacheValuesByName.set(cache->getName(),
+																		MDSCacheValueMap());
+															OR<MDSCacheValueMap>	cacheValueMap =
+																							mCacheValuesByName.get(
+																									cache->getName());
+															for (TDictionary<CDictionary>::Iterator iterator =
+																			valueInfoByID->getIterator();
+																	iterator; iterator++)
+																// Update
+																cacheValueMap->set(iterator.getKey(),
+																		iterator.getValue());
+															mCacheValuesLock.unlockForWriting();
+														}
+													}
+				OV<TNArray<CString> >			collectionGetDocumentIDs(const CString& name, UInt32 startIndex = 0,
+														const OV<UInt32>& count = OV<UInt32>()) const
+													{
+														// Get document IDs
+														OV<TNArray<CString> >	documentIDs;
+														mCollectionDocumentIDsLock.lockForReading();
+														const	OR<OrderedDocumentIDs>	collectionDocumentIDs =
+																mCollectionDocumentIDsByName.get(name);
+														if (collectionDocumentIDs.hasReference())
+															// Copy
+															documentIDs.setValue(
+																	collectionDocumentIDs->getDocumentIDs(startIndex,
+																			count));
+														mCollectionDocumentIDsLock.unlockForReading();
+
+														return documentIDs;
+													}
+				OV<DocumentIDsPage>				collectionGetDocumentIDsPage(const CString& name,
+														const OV<SInt64>& afterSequence, UInt32 count) const
+													{
+														// Get document IDs
+														OV<DocumentIDsPage>	documentIDsPage;
+														mCollectionDocumentIDsLock.lockForReading();
+														const	OR<OrderedDocumentIDs>	collectionDocumentIDs =
+																mCollectionDocumentIDsByName.get(name);
+														if (collectionDocumentIDs.hasReference())
+															// Copy
+															documentIDsPage.setValue(
+																	collectionDocumentIDs->getDocumentIDsPage(
+																			afterSequence, count));
+														mCollectionDocumentIDsLock.unlockForReading();
+
+														return documentIDsPage;
 													}
 				void							collectionUpdate(const I<MDSCollection>& collection,
 														const TArray<MDSUpdateInfo>& updateInfos)
@@ -287,105 +1214,82 @@ class CMDSEphemeral::Internals {
 
 														// Check if have updates
 														if (collectionUpdateResults.getIncludedIDs().hasValue() ||
-																collectionUpdateResults.getNotIncludedIDs().hasValue())
+																collectionUpdateResults.getNotIncludedIDs().hasValue()) {
 															// Update storage
-															mCollectionValuesByName.update(collection->getName(),
-																	(TNLockingDictionary<TNArray<CString> >::UpdateProc)
-																			collectionUpdateFromUpdateResults,
-																	&collectionUpdateResults);
-													}
-		static	OV<TNArray<CString> >			collectionUpdateFromUpdateResults(
-														const OR<TNArray<CString> >& currentValue,
-														MDSCollection::UpdateResults* collectionUpdateResults)
-													{
-														// Setup
-														TNSet<CString>	notIncludedIDs(
-																				collectionUpdateResults->
-																								getNotIncludedIDs()
-																								.hasValue() ?
-																						*collectionUpdateResults->
-																								getNotIncludedIDs() :
-																						TNArray<CString>());
-
-														// Compose updated values
-														TNArray<CString>	updatedValues;
-														if (currentValue.hasReference())
-															// Start with current values, and then filtered
-															updatedValues =
-																	currentValue->filtered(
-																			(TNArray<CString>::IsMatchProc)
-																					TSet<CString>::doesNotContainItem,
-																			&notIncludedIDs);
-
-														if (collectionUpdateResults->getIncludedIDs().hasValue())
-															// Add included IDs
-															updatedValues += *collectionUpdateResults->getIncludedIDs();
-
-														return !updatedValues.isEmpty() ?
-																OV<TNArray<CString> >(updatedValues) :
-																OV<TNArray<CString> >();
+															mCollectionDocumentIDsLock.lockForWriting();
+															OR<OrderedDocumentIDs>	collectionDocumentIDs =
+																	mCollectionDocumentIDsByName.get(
+																			collection->getName());
+															if (collectionDocumentIDs.hasReference()) {
+																// Remove not included and add included
+																if (collectionUpdateResults.getNotIncludedIDs()
+																		.hasValue())
+																	// Remove
+																	collectionDocumentIDs->remove(
+																			*collectionUpdateResults
+																					.getNotIncludedIDs());
+																if (collectionUpdateResults.getIncludedIDs().hasValue())
+																	// Add
+																	collectionDocumentIDs->add(
+																			*collectionUpdateResults.getIncludedIDs());
+															}
+															mCollectionDocumentIDsLock.unlockForWriting();
+														}
 													}
 				DocumentBackingsResult			documentBackingsGet(const CString& documentType, UInt32 sinceRevision,
 														const OV<UInt32>& count = OV<UInt32>(), bool activeOnly = false)
 													{
-														// Setup
-														TNArray<I<DocumentBacking> >	documentBackings;
-
-														// Perform under lock
-														mDocumentMapsLock.lockForReading();
-														bool	isKnownDocumentType =
-																		mDocumentIDsByDocumentType.contains(
-																				documentType);
-														if (isKnownDocumentType) {
-															// Collect DocumentBackings
-															TSet<CString>&	documentIDs =
-																					*mDocumentIDsByDocumentType.get(
-																							documentType);
-															for (TSet<CString>::Iterator iterator =
-																			documentIDs.getIterator();
-																	iterator; iterator++) {
-																// Get DocumentBacking
-																I<DocumentBacking>&	documentBacking =
-																							*mDocumentBackingByDocumentID
-																									.get(*iterator);
-
-																// Check
-																if ((documentBacking->getRevision() > sinceRevision) &&
-																		(!activeOnly || documentBacking->isActive()))
-																	// Passes
-																	documentBackings += documentBacking;
-															}
-														}
-														mDocumentMapsLock.unlockForReading();
-
-														if (!isKnownDocumentType)
-															// Document type not found
-															return TVResult<DocumentBackings>(
+														// Get partition
+														OR<DocumentTypePartition>	documentTypePartition =
+																							documentTypePartitionGet(
+																									documentType);
+														if (!documentTypePartition.hasReference())
+															// Unknown document type
+															return DocumentBackingsResult(
 																	mDocumentStorage.getUnknownDocumentTypeError(
 																			documentType));
-														else if (!count.hasValue())
-															// No count
-															return TVResult<DocumentBackings>(documentBackings);
-														else {
-															// Sort by revision
-															documentBackings.sort(
-																	DocumentBacking::compareRevision, nil);
-
-															return TVResult<DocumentBackings>(
-																	documentBackings.popFirst(*count));
+
+														// Collect DocumentBackings in revision order
+														TNArray<I<DocumentBacking> >	documentBackings;
+														const	RevisionLog&			revisionLog =
+																								documentTypePartition->
+																										mRevisionLog;
+														documentTypePartition->mLock.lockForReading();
+														for (UInt32 index = revisionLog.getFirstEntryIndexAfter(
+																		sinceRevision);
+																(index < revisionLog.getEntryCount()) &&
+																		(!count.hasValue() ||
+																				(documentBackings.getCount() < *count));
+																index++) {
+															// Check if current
+															if (!revisionLog.isCurrent(index))
+																// Superseded by a later revision
+																continue;
+
+															// Get DocumentBacking
+															const	CString&			documentID =
+																	revisionLog.getEntry(index).getDocumentID();
+																	I<DocumentBacking>	documentBacking =
+																	*documentTypePartition->getDocumentBacking(
+																			documentID);
+
+															// Check
+															if (!activeOnly || documentBacking->isActive())
+																// Passes
+																documentBackings += documentBacking;
 														}
+														documentTypePartition->mLock.unlockForReading();
+
+														return DocumentBackingsResult(documentBackings);
 													}
 				DocumentBackingsResult			documentBackingsGet(const CString& documentType,
 														const TArray<CString>& documentIDs)
 													{
-														// Validate
-														mDocumentMapsLock.lockForReading();
-														bool	isKnownDocumentType =
-																		mDocumentIDsByDocumentType.contains(
-																				documentType);
-														mDocumentMapsLock.unlockForReading();
-
-														if (!isKnownDocumentType)
+														// Get partition
+														OR<DocumentTypePartition>	documentTypePartition =
+																							documentTypePartitionGet(
+																									documentType);
+														if (!documentTypePartition.hasReference())
 															// Unknown document type
 															return DocumentBackingsResult(
 																	mDocumentStorage.getUnknownDocumentTypeError(
@@ -394,13 +1298,15 @@ class CMDSEphemeral::Internals {
 														// Retrieve document backings
 														TNArray<I<DocumentBacking> >	documentBackings;
 														OV<SError>						error;
-														mDocumentMapsLock.lockForReading();
+														documentTypePartition->mLock.lockForReading();
 														for (TArray<CString>::Iterator iterator =
 																		documentIDs.getIterator();
 																iterator; iterator++) {
 															// Validate
-															const OR<I<DocumentBacking> >	documentBacking =
-																									mDocumentBackingByDocumentID.get(*iterator);
+															OR<I<DocumentBacking> >	documentBacking =
+																							documentTypePartition->
+																									getDocumentBacking(
+																											*iterator);
 															if (!documentBacking.hasReference()) {
 																// Document ID not found
 																error.setValue(
@@ -412,12 +1318,196 @@ class CMDSEphemeral::Internals {
 															// Add to array
 															documentBackings += *documentBacking;
 														}
-														mDocumentMapsLock.unlockForReading();
+														documentTypePartition->mLock.unlockForReading();
 
 														return !error.hasValue() ?
 																DocumentBackingsResult(documentBackings) :
 																DocumentBackingsResult(*error);
 													}
+				OR<I<DocumentBacking> >			documentBackingGet(const CString& documentType,
+														const CString& documentID)
+													{
+														// Get partition
+														OR<DocumentTypePartition>	documentTypePartition =
+																							documentTypePartitionGet(
+																									documentType);
+														if (!documentTypePartition.hasReference())
+															// Unknown document type
+															return OR<I<DocumentBacking> >();
+
+														// Get DocumentBacking
+														documentTypePartition->mLock.lockForReading();
+														OR<I<DocumentBacking> >	documentBacking =
+																						documentTypePartition->
+																								getDocumentBacking(
+																										documentID);
+														documentTypePartition->mLock.unlockForReading();
+
+														return documentBacking;
+													}
+				OV<CString>						documentIDGetFirstUnknown(const CString& documentType,
+														const TArray<CString>& documentIDs)
+													{
+														// Check if have anything to check
+														if (documentIDs.isEmpty())
+															// Nothing unknown
+															return OV<CString>();
+
+														// Get partition
+														OR<DocumentTypePartition>	documentTypePartition =
+																							documentTypePartitionGet(
+																									documentType);
+														if (!documentTypePartition.hasReference())
+															// No documents of this type
+															return OV<CString>(documentIDs[0]);
+
+														// Check document IDs
+														OV<CString>	unknownDocumentID;
+														documentTypePartition->mLock.lockForReading();
+														for (TArray<CString>::Iterator iterator =
+																		documentIDs.getIterator();
+																iterator; iterator++) {
+															// Check if have document with this ID
+															if (!documentTypePartition->mDocumentBackingByDocumentID
+																	.contains(*iterator)) {
+																// Not found
+																unknownDocumentID.setValue(*iterator);
+																break;
+															}
+														}
+														documentTypePartition->mLock.unlockForReading();
+
+														return unknownDocumentID;
+													}
+				TArray<CMDSDocument::RevisionInfo>	documentRevisionInfosGet(const CString& documentType,
+														const TArray<CString>& documentIDs)
+													{
+														// Collect Document RevisionInfos
+														TNArray<CMDSDocument::RevisionInfo>	documentRevisionInfos;
+														DocumentBackingsResult				documentBackingsResult =
+																									documentBackingsGet(
+																											documentType,
+																											documentIDs);
+														if (!documentBackingsResult.hasError())
+															// Iterate DocumentBackings
+															for (TArray<I<DocumentBacking> >::Iterator iterator =
+																			documentBackingsResult.getValue()
+																					.getIterator();
+																	iterator; iterator++)
+																// Add Document RevisionInfo
+																documentRevisionInfos +=
+																		(*iterator)->getDocumentRevisionInfo();
+
+														return documentRevisionInfos;
+													}
+				TArray<CMDSDocument::FullInfo>	documentFullInfosGet(const CString& documentType,
+														const TArray<CString>& documentIDs)
+													{
+														// Collect Document FullInfos
+														TNArray<CMDSDocument::FullInfo>	documentFullInfos;
+														DocumentBackingsResult			documentBackingsResult =
+																								documentBackingsGet(
+																										documentType,
+																										documentIDs);
+														if (!documentBackingsResult.hasError())
+															// Iterate DocumentBackings
+															for (TArray<I<DocumentBacking> >::Iterator iterator =
+																			documentBackingsResult.getValue()
+																					.getIterator();
+																	iterator; iterator++)
+																// Add Document FullInfo
+																documentFullInfos +=
+																		(*iterator)->getDocumentFullInfo();
+
+														return documentFullInfos;
+													}
+				OR<DocumentTypePartition>		documentTypePartitionGet(const CString& documentType)
+													{
+														// Get partition.  Partitions are never removed, so the
+														//	reference remains valid after the lock is released.
+														mDocumentTypePartitionsLock.lockForReading();
+														OR<I<DocumentTypePartition> >	documentTypePartition =
+																mDocumentTypePartitionByDocumentType.get(documentType);
+														OR<DocumentTypePartition>		documentTypePartition_ =
+																documentTypePartition.hasReference() ?
+																		OR<DocumentTypePartition>(
+																				**documentTypePartition) :
+																		OR<DocumentTypePartition>();
+														mDocumentTypePartitionsLock.unlockForReading();
+
+														return documentTypePartition_;
+													}
+				DocumentTypePartition&			documentTypePartitionGetOrCreate(const CString& documentType)
+													{
+														// Check if have partition
+														OR<DocumentTypePartition>	documentTypePartition =
+																							documentTypePartitionGet(
+																									documentType);
+														if (documentTypePartition.hasReference())
+															// Have partition
+															return *documentTypePartition;
+
+														// Create partition unless another writer got here first
+														mDocumentTypePartitionsLock.lockForWriting();
+														if (!mDocumentTypePartitionByDocumentType.contains(documentType))
+															// Create
+															mDocumentTypePartitionByDocumentType.set(documentType,
+																	I<DocumentTypePartition>(
+																			new DocumentTypePartition()));
+														DocumentTypePartition&	documentTypePartition_ =
+																**mDocumentTypePartitionByDocumentType.get(documentType);
+														mDocumentTypePartitionsLock.unlockForWriting();
+
+														return documentTypePartition_;
+													}
+		static	TVResult<OV<SInt64> >			getAfterSequence(const OV<CString>& continuationToken)
+													{
+														// Check for token
+														if (!continuationToken.hasValue())
+															// First page
+															return TVResult<OV<SInt64> >(OV<SInt64>());
+
+														// Tokens are sequences written out in full, so anything that
+														//	does not survive the round trip did not come from us
+														SInt64	sequence = continuationToken->getSInt64();
+														if (CString(sequence) != *continuationToken)
+															return TVResult<OV<SInt64> >(
+																	CMDSDocumentStorage::
+																			getInvalidContinuationTokenError(
+																					*continuationToken));
+
+														return TVResult<OV<SInt64> >(OV<SInt64>(sequence));
+													}
+		static	TArray<CString>					documentIDsSlice(const TArray<CString>& documentIDs,
+														UInt32 startIndex, const OV<UInt32>& count)
+													{
+														// Collect document IDs in range
+														TNArray<CString>	sliceDocumentIDs;
+														UInt32				endIndex =
+																					count.hasValue() ?
+																							startIndex + *count :
+																							documentIDs.getCount();
+														for (UInt32 i = startIndex;
+																(i < endIndex) && (i < documentIDs.getCount()); i++)
+															// Add
+															sliceDocumentIDs += documentIDs[i];
+
+														return sliceDocumentIDs;
+													}
+				OV<TNDictionary<CString> >		indexGetDocumentIDByKey(const CString& name) const
+													{
+														// Get document ID by key
+														OV<TNDictionary<CString> >	documentIDByKey;
+														mIndexValuesLock.lockForReading();
+														const	OR<IndexValues>	indexValues =
+																		mIndexValuesByName.get(name);
+														if (indexValues.hasReference())
+															// Copy
+															documentIDByKey.setValue(indexValues->getDocumentIDByKey());
+														mIndexValuesLock.unlockForReading();
+
+														return documentIDByKey;
+													}
 				void							indexUpdate(const I<MDSIndex>& index,
 														const TArray<MDSUpdateInfo>& updateInfos)
 													{
@@ -426,56 +1516,16 @@ class CMDSEphemeral::Internals {
 																						index->update(updateInfos);
 
 														// Check if have updates
-														if (indexUpdateResults.getKeysInfos().hasValue())
+														if (indexUpdateResults.getKeysInfos().hasValue()) {
 															// Update storage
-															mIndexValuesByName.update(index->getName(),
-																	(TNLockingDictionary<TDictionary<CString> >::
-																					UpdateProc)
-																			indexUpdateFromUpdateResults,
-																	&indexUpdateResults);
-													}
-		static	OV<TNDictionary<CString> >		indexUpdateFromUpdateResults(
-														const OR<TNDictionary<CString> >& currentValue,
-														MDSIndex::UpdateResults* indexUpdateResults)
-													{
-														// Setup
-														TNArray<CString>		documentIDsArray(
-																						*indexUpdateResults->
-																								getKeysInfos(),
-																						MDSIndex::KeysInfo::getID);
-														TNSet<CString>			documentIDs(documentIDsArray);
-
-														TNDictionary<CString>	updatedValueInfo =
-																						currentValue.hasReference() ?
-																								*currentValue :
-																								TNDictionary<CString>();
-
-														// Filter out document IDs included in update
-														for (TDictionary<CString>::Iterator iterator =
-																		updatedValueInfo.getIterator();
-																iterator; iterator++) {
-															// Check if have new value(s) for documentID for this key
-															if (documentIDs.contains(iterator.getValue()))
-																// Yes, remove
-																updatedValueInfo.remove(iterator.getKey());
+															mIndexValuesLock.lockForWriting();
+															if (!mIndexValuesByName.contains(index->getName()))
+																// Start empty
+																mIndexValuesByName.set(index->getName(), IndexValues());
+															mIndexValuesByName.get(index->getName())->update(
+																	*indexUpdateResults.getKeysInfos());
+															mIndexValuesLock.unlockForWriting();
 														}
-
-														// Add/Update keys => document IDs
-														for (TArray<MDSIndex::KeysInfo>::Iterator keysInfoIterator =
-																		indexUpdateResults->getKeysInfos()->
-																				getIterator();
-																keysInfoIterator; keysInfoIterator++)
-															// Iterate keys
-															for (TArray<CString>::Iterator keyIterator =
-																			keysInfoIterator->getKeys().getIterator();
-																	keyIterator; keyIterator++)
-																// Add key => document ID
-																updatedValueInfo.set(*keyIterator,
-																		keysInfoIterator->getID());
-
-														return !updatedValueInfo.isEmpty() ?
-																OV<TNDictionary<CString> >(updatedValueInfo) :
-																OV<TNDictionary<CString> >();
 													}
 
 				void							process(const CString& documentID,
@@ -537,19 +1587,6 @@ class CMDSEphemeral::Internals {
 															iterator->notify(document, documentChangeKind);
 													}
 
-				UInt32							nextRevision(const CString& documentType)
-													{
-														// Compose next revision
-														mDocumentLastRevisionByDocumentTypeLock.lock();
-														UInt32	nextRevision =
-																		mDocumentLastRevisionByDocumentType
-																				.getUInt32(documentType, 0) + 1;
-														mDocumentLastRevisionByDocumentType.set(documentType,
-																nextRevision);
-														mDocumentLastRevisionByDocumentTypeLock.unlock();
-
-														return nextRevision;
-													}
 				TArray<MDSUpdateInfo>			updateInfosGet(const CString& documentType,
 														const CMDSDocument::Info& documentInfo, UInt32 sinceRevision)
 													{
@@ -581,188 +1618,124 @@ class CMDSEphemeral::Internals {
 				void							update(const CString& documentType,
 														const TArray<MDSUpdateInfo>& updateInfos)
 													{
+														// Setup
+														ViewsUpdate	viewsUpdate(*this,
+																			mCachesByDocumentType.get(documentType),
+																			mCollectionsByDocumentType.get(
+																					documentType),
+																			mIndexesByDocumentType.get(documentType),
+																			updateInfos);
+
+														// Update caches, collections and indexes.  Each computes its
+														//	own results and takes the lock for its own storage, so
+														//	they are spread across the shared worker pool.
+														CMDSWorkerPool::getShared().perform(viewsUpdate.getCount(),
+																(CMDSWorkerPool::Proc) ViewsUpdate::perform,
+																&viewsUpdate);
+													}
+				void							noteRemoved(const CString& documentType,
+														const TSet<CString>& documentIDs)
+													{
+														// Check if have document IDs
+														if (documentIDs.isEmpty())
+															// Nothing to do
+															return;
+
 														// Update caches
 														const	OR<TNArray<I<MDSCache> > >	caches =
-																									mCachesByDocumentType
-																											.get(documentType);
-														if (caches.hasReference())
+																mCachesByDocumentType.get(documentType);
+														if (caches.hasReference()) {
 															// Update
+															mCacheValuesLock.lockForWriting();
 															for (TArray<I<MDSCache> >::Iterator iterator =
 																			caches->getIterator();
-																	iterator; iterator++)
-																// Update
-																cacheUpdate(*iterator, updateInfos);
+																	iterator; iterator++) {
+																// Get cache value map
+																OR<MDSCacheValueMap>	cacheValueMap =
+																		mCacheValuesByName.get((*iterator)->getName());
+																if (cacheValueMap.hasReference())
+																	// Remove document IDs
+																	for (TSet<CString>::Iterator documentIDIterator =
+																					documentIDs.getIterator();
+																			documentIDIterator; documentIDIterator++)
+																		// Remove
+																		cacheValueMap->remove(*documentIDIterator);
+															}
+															mCacheValuesLock.unlockForWriting();
+														}
 
 														// Update collections
-														const	OR<TNArray<I<MDSCollection> > > collections =
-																										mCollectionsByDocumentType
-																												.get(documentType);
-														if (collections.hasReference())
+														const	OR<TNArray<I<MDSCollection> > >	collections =
+																mCollectionsByDocumentType.get(documentType);
+														if (collections.hasReference()) {
 															// Update
+															mCollectionDocumentIDsLock.lockForWriting();
 															for (TArray<I<MDSCollection> >::Iterator iterator =
 																			collections->getIterator();
-																	iterator; iterator++)
-																// Update
-																collectionUpdate(*iterator, updateInfos);
+																	iterator; iterator++) {
+																// Get collection document IDs
+																OR<OrderedDocumentIDs>	collectionDocumentIDs =
+																		mCollectionDocumentIDsByName.get(
+																				(*iterator)->getName());
+																if (collectionDocumentIDs.hasReference())
+																	// Remove document IDs
+																	collectionDocumentIDs->remove(documentIDs);
+															}
+															mCollectionDocumentIDsLock.unlockForWriting();
+														}
 
 														// Update indexes
-														const	OR<TNArray<I<MDSIndex> > > indexes =
-																									mIndexesByDocumentType
-																											.get(documentType);
-														if (indexes.hasReference())
+														const	OR<TNArray<I<MDSIndex> > >	indexes =
+																mIndexesByDocumentType.get(documentType);
+														if (indexes.hasReference()) {
 															// Update
+															mIndexValuesLock.lockForWriting();
 															for (TArray<I<MDSIndex> >::Iterator iterator =
 																			indexes->getIterator();
-																	iterator; iterator++)
-																// Update
-																indexUpdate(*iterator, updateInfos);
-													}
-				void							noteRemoved(const TSet<CString>& documentIDs)
-													{
-														// Update caches
-														const	TSet<CString>&	cacheNames =
-																						mCacheValuesByName.getKeys();
-														for (TSet<CString>::Iterator iterator =
-																		cacheNames.getIterator();
-																iterator; iterator++)
-															// Update storage
-															mCacheValuesByName.update(*iterator,
-																	(TNLockingDictionary<MDSCacheValueMap>::UpdateProc)
-																			updateCacheValueMapWithRemovedDocumentIDs,
-																	(void*) &documentIDs);
-
-														// Update collections
-														const	TSet<CString>&	collectionNames =
-																						mCollectionValuesByName
-																								.getKeys();
-														for (TSet<CString>::Iterator iterator =
-																		collectionNames.getIterator();
-																iterator; iterator++)
-															// Update storage
-															mCollectionValuesByName.update(*iterator,
-																	(TNLockingDictionary<TNArray<CString> >::UpdateProc)
-																			updateCollectionValuesWithRemovedDocumentIDs,
-																	(void*) &documentIDs);
-
-														// Update indexes
-														const	TSet<CString>	indexNames =
-																						mIndexValuesByName.getKeys();
-														for (TSet<CString>::Iterator iterator =
-																		indexNames.getIterator();
-																iterator; iterator++)
-															// Update storage
-															mIndexValuesByName.update(*iterator,
-																	(TNLockingDictionary<TDictionary<CString> >::
-																					UpdateProc)
-																			updateIndexValuesWithRemovedDocumentIDs,
-																	(void*) &documentIDs);
-													}
-
-												// Class methods
-		static	OV<MDSCacheValueMap>			updateCacheValueMapWithRemovedDocumentIDs(
-														const OR<MDSCacheValueMap>& currentCacheValueMap,
-														TSet<CString>* documentIDs)
-													{
-														// Filter document ids
-														MDSCacheValueMap	filteredCacheValueMap =
-																				MDSCacheValueMap(*currentCacheValueMap)
-																						.filtered(
-																								(MDSCacheValueMap::
-																												KeyIsMatchProc)
-																										TSet<CString>::
-																												doesNotContainItem,
-																								documentIDs);
-
-														return (!filteredCacheValueMap.isEmpty()) ?
-																OV<MDSCacheValueMap>(filteredCacheValueMap) :
-																OV<MDSCacheValueMap>();
-													}
-		static	OV<MDSCacheValueMap>			updateCacheValueMapWithUpdateInfosByID(
-														const OR<MDSCacheValueMap>& currentCacheValueMap,
-														TDictionary<CDictionary>* infosByID)
-													{
-														// Setup
-														MDSCacheValueMap	cacheValueMap =
-																					currentCacheValueMap
-																									.hasReference() ?
-																							MDSCacheValueMap(
-																									*currentCacheValueMap) :
-																							MDSCacheValueMap();
-														// Update
-														for (TDictionary<CDictionary>::Iterator iterator =
-																		infosByID->getIterator();
-																iterator; iterator++)
-															// Update
-															cacheValueMap.set(iterator.getKey(), iterator.getValue());
-
-														return !cacheValueMap.isEmpty() ?
-																OV<MDSCacheValueMap>(cacheValueMap) :
-																OV<MDSCacheValueMap>();
-													}
-
-		static	OV<TNArray<CString> >			updateCollectionValuesWithRemovedDocumentIDs(
-														const OR<TNArray<CString> >& currentDocumentIDs,
-														TSet<CString>* documentIDs)
-													{
-														// Filter document ids
-														TNArray<CString>	filteredDocumentIDs =
-																					currentDocumentIDs->filtered(
-																							(TNArray<CString>::
-																											IsMatchProc)
-																									TSet<CString>::
-																											doesNotContainItem,
-																							documentIDs);
-
-														return (!filteredDocumentIDs.isEmpty()) ?
-																OV<TNArray<CString> >(filteredDocumentIDs) :
-																OV<TNArray<CString> >();
-													}
-
-		static	OV<TDictionary<CString> >		updateIndexValuesWithRemovedDocumentIDs(
-														const OR<TDictionary<CString> >& currentIndexValues,
-														TSet<CString>* documentIDs)
-													{
-														// Filter document ids
-														TNDictionary<CString>	filteredDictionary =
-																						TNDictionary<CString>(*currentIndexValues)
-																								.filtered(
-																										(TNDictionary<CString>::KeyIsMatchProc)
-																												TSet<CString>::
-																														doesNotContainItem,
-																										documentIDs);
-
-														return (!filteredDictionary.isEmpty()) ?
-																OV<TDictionary<CString> >(filteredDictionary) :
-																OV<TDictionary<CString> >();
+																	iterator; iterator++) {
+																// Get index values
+																OR<IndexValues>	indexValues =
+																		mIndexValuesByName.get((*iterator)->getName());
+																if (indexValues.hasReference())
+																	// Remove document IDs
+																	for (TSet<CString>::Iterator documentIDIterator =
+																					documentIDs.getIterator();
+																			documentIDIterator; documentIDIterator++)
+																		// Remove
+																		indexValues->remove(*documentIDIterator);
+															}
+															mIndexValuesLock.unlockForWriting();
+														}
 													}
 
 	// Properties
 	public:
 		CMDSDocumentStorage&							mDocumentStorage;
 
+		TNDictionary<AssociationAdjacency>				mAssociationAdjacencyByName;
+		CReadPreferringLock								mAssociationAdjacencyLock;
 		TNLockingDictionary<I<CMDSAssociation> >		mAssociationByName;
-		TNLockingArrayDictionary<CMDSAssociation::Item>	mAssociationItemsByName;
 
-		TNLockingDictionary<I<Batch> >					mBatchByThreadRef;
+		TMDSBatchByThread<I<Batch> >					mBatchByThread;
 
 		TNLockingDictionary<I<MDSCache> >				mCacheByName;
 		TNLockingArrayDictionary<I<MDSCache> >			mCachesByDocumentType;
-		TNLockingDictionary<MDSCacheValueMap>			mCacheValuesByName;
+		TNDictionary<MDSCacheValueMap>					mCacheValuesByName;
+		CReadPreferringLock								mCacheValuesLock;
 
 		TNLockingDictionary<I<MDSCollection> >			mCollectionByName;
 		TNLockingArrayDictionary<I<MDSCollection> >		mCollectionsByDocumentType;
-		TNLockingDictionary<TNArray<CString> >			mCollectionValuesByName;
+		TNDictionary<OrderedDocumentIDs>				mCollectionDocumentIDsByName;
+		CReadPreferringLock								mCollectionDocumentIDsLock;
 
-		TNDictionary<I<DocumentBacking> >				mDocumentBackingByDocumentID;
-		TNSetDictionary<CString>						mDocumentIDsByDocumentType;
-		CReadPreferringLock								mDocumentMapsLock;
-		CDictionary										mDocumentLastRevisionByDocumentType;
-		CLock											mDocumentLastRevisionByDocumentTypeLock;
+		TNDictionary<I<DocumentTypePartition> >			mDocumentTypePartitionByDocumentType;
+		CReadPreferringLock								mDocumentTypePartitionsLock;
 		TNLockingDictionary<CDictionary>				mDocumentsBeingCreatedPropertyMapByDocumentID;
 
 		TNLockingDictionary<I<MDSIndex> >				mIndexByName;
 		TNLockingArrayDictionary<I<MDSIndex> >			mIndexesByDocumentType;
-		TNLockingDictionary<TDictionary<CString> >		mIndexValuesByName;
+		TNDictionary<IndexValues>						mIndexValuesByName;
+		CReadPreferringLock								mIndexValuesLock;
 
 		TNLockingDictionary<CString>					mInfoValueByKey;
 		TNLockingDictionary<CString>					mInternalValueByKey;
@@ -796,10 +1769,15 @@ OV<SError> CMDSEphemeral::associationRegister(const CString& name, const CString
 //----------------------------------------------------------------------------------------------------------------------
 {
 	// Check if have association already
-	if (!mInternals->mAssociationByName.get(name).hasReference())
+	if (!mInternals->mAssociationByName.get(name).hasReference()) {
 		// Create
+		mInternals->mAssociationAdjacencyLock.lockForWriting();
+		mInternals->mAssociationAdjacencyByName.set(name, Internals::AssociationAdjacency());
+		mInternals->mAssociationAdjacencyLock.unlockForWriting();
+
 		mInternals->mAssociationByName.set(name,
 				I<CMDSAssociation>(new CMDSAssociation(name, fromDocumentType, toDocumentType)));
+	}
 
 	return OV<SError>();
 }
@@ -825,24 +1803,18 @@ OV<SError> CMDSEphemeral::associationIterateFrom(const CString& name, const CStr
 	if (!association.hasReference())
 		return OV<SError>(getUnknownAssociationError(name));
 
-	mInternals->mDocumentMapsLock.lockForReading();
-	bool	found = mInternals->mDocumentBackingByDocumentID.contains(fromDocumentID);
-	mInternals->mDocumentMapsLock.unlockForReading();
-	if (!found)
+	if (!mInternals->documentBackingGet((*association)->getFromDocumentType(), fromDocumentID).hasReference())
 		return OV<SError>(getUnknownDocumentIDError(fromDocumentID));
 
 	if ((*association)->getToDocumentType() != toDocumentType)
 		return OV<SError>(getInvalidDocumentTypeError(toDocumentType));
 
-	// Get association items
-	const	CMDSDocument::Info&				documentInfo = documentCreateInfo(toDocumentType);
-			TArray<CMDSAssociation::Item>	associationItems = mInternals->associationGetItems(name);
-	for (TArray<CMDSAssociation::Item>::Iterator iterator = associationItems.getIterator(); iterator; iterator++) {
-		// Check for docmentID match
-		if (iterator->getFromDocumentID() == fromDocumentID)
-			// Match
-			proc(documentInfo.create(iterator->getToDocumentID(), (CMDSDocumentStorage&) *this), procUserData);
-	}
+	// Iterate to document IDs
+	const	CMDSDocument::Info&	documentInfo = documentCreateInfo(toDocumentType);
+			TArray<CString>		toDocumentIDs = mInternals->associationGetToDocumentIDs(name, fromDocumentID);
+	for (TArray<CString>::Iterator iterator = toDocumentIDs.getIterator(); iterator; iterator++)
+		// Call proc
+		proc(documentInfo.create(*iterator, (CMDSDocumentStorage&) *this), procUserData);
 
 	return OV<SError>();
 }
@@ -857,24 +1829,18 @@ OV<SError> CMDSEphemeral::associationIterateTo(const CString& name, const CStrin
 	if (!association.hasReference())
 		return OV<SError>(getUnknownAssociationError(name));
 
-	mInternals->mDocumentMapsLock.lockForReading();
-	bool	found = mInternals->mDocumentBackingByDocumentID.contains(toDocumentID);
-	mInternals->mDocumentMapsLock.unlockForReading();
-	if (!found)
+	if (!mInternals->documentBackingGet((*association)->getToDocumentType(), toDocumentID).hasReference())
 		return OV<SError>(getUnknownDocumentIDError(toDocumentID));
 
 	if ((*association)->getFromDocumentType() != fromDocumentType)
 		return OV<SError>(getInvalidDocumentTypeError(fromDocumentType));
 
-	// Get association items
-	const	CMDSDocument::Info&				documentInfo = documentCreateInfo(fromDocumentType);
-			TArray<CMDSAssociation::Item>	associationItems = mInternals->associationGetItems(name);
-	for (TArray<CMDSAssociation::Item>::Iterator iterator = associationItems.getIterator(); iterator; iterator++) {
-		// Check for docmentID match
-		if (iterator->getToDocumentID() == toDocumentID)
-			// Match
-			proc(documentInfo.create(iterator->getFromDocumentID(), (CMDSDocumentStorage&) *this), procUserData);
-	}
+	// Iterate from document IDs
+	const	CMDSDocument::Info&	documentInfo = documentCreateInfo(fromDocumentType);
+			TArray<CString>		fromDocumentIDs = mInternals->associationGetFromDocumentIDs(name, toDocumentID);
+	for (TArray<CString>::Iterator iterator = fromDocumentIDs.getIterator(); iterator; iterator++)
+		// Call proc
+		proc(documentInfo.create(*iterator, (CMDSDocumentStorage&) *this), procUserData);
 
 	return OV<SError>();
 }
@@ -885,22 +1851,14 @@ TVResult<SValue> CMDSEphemeral::associationGetValues(const CString& name, CMDSAs
 //----------------------------------------------------------------------------------------------------------------------
 {
 	// Validate
-	if (!mInternals->mAssociationByName.contains(name))
+	OR<I<CMDSAssociation> >	association = mInternals->mAssociationByName.get(name);
+	if (!association.hasReference())
 		return TVResult<SValue>(getUnknownAssociationError(name));
 
-	OV<SError>	error;
-	mInternals->mDocumentMapsLock.lockForReading();
-	for (TArray<CString>::Iterator iterator = fromDocumentIDs.getIterator(); iterator; iterator++) {
-		// Check if have document with this ID
-		if (!mInternals->mDocumentBackingByDocumentID.contains(*iterator)) {
-			// Not found
-			error.setValue(getUnknownDocumentIDError(*iterator));
-			break;
-		}
-	}
-	mInternals->mDocumentMapsLock.unlockForReading();
-	if (error.hasValue())
-		return TVResult<SValue>(*error);
+	OV<CString>	unknownDocumentID =
+						mInternals->documentIDGetFirstUnknown((*association)->getFromDocumentType(), fromDocumentIDs);
+	if (unknownDocumentID.hasValue())
+		return TVResult<SValue>(getUnknownDocumentIDError(*unknownDocumentID));
 
 	OR<I<MDSCache> >	cache = mInternals->mCacheByName.get(cacheName);
 	if (!cache.hasReference())
@@ -913,26 +1871,28 @@ TVResult<SValue> CMDSEphemeral::associationGetValues(const CString& name, CMDSAs
 	}
 
 	// Setup
-	TNSet<CString>					fromDocumentIDsUse(fromDocumentIDs);
-	TArray<CMDSAssociation::Item>	associationItems = mInternals->associationGetItems(name);
-	TDictionary<CDictionary>&		cacheValueInfos = *mInternals->mCacheValuesByName.get(cacheName);
+	TNSet<CString>			fromDocumentIDsUse(fromDocumentIDs);
+	MDSCacheValueMap		cacheValueInfos = *mInternals->cacheGetValueMap(cacheName);
 
 	// Process association items
 	switch (action) {
 		case CMDSAssociation::kGetValueActionDetail: {
 			// Detail
 			TNArray<CDictionary>	results;
-			for (TArray<CMDSAssociation::Item>::Iterator associationItemIterator = associationItems.getIterator();
-					associationItemIterator; associationItemIterator++) {
-				// Check fromDocumentID
-				if (fromDocumentIDsUse.contains(associationItemIterator->getFromDocumentID())) {
+			for (TSet<CString>::Iterator fromDocumentIDIterator = fromDocumentIDsUse.getIterator();
+					fromDocumentIDIterator; fromDocumentIDIterator++) {
+				// Iterate to document IDs
+				TArray<CString>	toDocumentIDs =
+										mInternals->associationGetToDocumentIDs(name, *fromDocumentIDIterator);
+				for (TArray<CString>::Iterator toDocumentIDIterator = toDocumentIDs.getIterator();
+						toDocumentIDIterator; toDocumentIDIterator++) {
 					// Setup
 					CDictionary	result;
-					result.set(CString(OSSTR("fromID")), associationItemIterator->getFromDocumentID());
-					result.set(CString(OSSTR("toID")), associationItemIterator->getToDocumentID());
+					result.set(CString(OSSTR("fromID")), *fromDocumentIDIterator);
+					result.set(CString(OSSTR("toID")), *toDocumentIDIterator);
 
 					// Iterate cachedValueNames
-					CDictionary&	valueInfos = *cacheValueInfos.get(associationItemIterator->getToDocumentID());
+					CDictionary&	valueInfos = *cacheValueInfos.get(*toDocumentIDIterator);
 					for (TArray<CString>::Iterator cacheValueNameIterator = cachedValueNames.getIterator();
 							cacheValueNameIterator; cacheValueNameIterator++)
 						// Update result
@@ -949,15 +1909,18 @@ TVResult<SValue> CMDSEphemeral::associationGetValues(const CString& name, CMDSAs
 			// Sum
 			CDictionary	results;
 			UInt64		count = 0;
-			for (TArray<CMDSAssociation::Item>::Iterator associationItemIterator = associationItems.getIterator();
-					associationItemIterator; associationItemIterator++) {
-				// Check fromDocumentID
-				if (fromDocumentIDsUse.contains(associationItemIterator->getFromDocumentID())) {
+			for (TSet<CString>::Iterator fromDocumentIDIterator = fromDocumentIDsUse.getIterator();
+					fromDocumentIDIterator; fromDocumentIDIterator++) {
+				// Iterate to document IDs
+				TArray<CString>	toDocumentIDs =
+										mInternals->associationGetToDocumentIDs(name, *fromDocumentIDIterator);
+				for (TArray<CString>::Iterator toDocumentIDIterator = toDocumentIDs.getIterator();
+						toDocumentIDIterator; toDocumentIDIterator++) {
 					// Included
 					count++;
 
 					// Get value and sum
-					CDictionary&	valueInfos = *cacheValueInfos.get(associationItemIterator->getToDocumentID());
+					CDictionary&	valueInfos = *cacheValueInfos.get(*toDocumentIDIterator);
 
 					// Iterate cachedValueNames
 					for (TArray<CString>::Iterator cacheValueNameIterator = cachedValueNames.getIterator();
@@ -999,60 +1962,41 @@ OV<SError> CMDSEphemeral::associationUpdate(const CString& name, const TArray<CM
 							(TNSet<CString>::ArrayMapProc) CMDSAssociation::Update::getToDocumentIDFromItem);
 
 	// Check for batch
-	const	OR<I<Internals::Batch> >	batch = mInternals->mBatchByThreadRef[CThread::getCurrentRefAsString()];
+	const	OR<I<Internals::Batch> >	batch = mInternals->mBatchByThread.get();
 	if (batch.hasReference()) {
 		// In batch
-		mInternals->mDocumentMapsLock.lockForReading();
-		TNSet<CString>	existingFromDocumentIDs =
-								mInternals->mDocumentIDsByDocumentType.get((*association)->getFromDocumentType(),
-										TNSet<CString>());
-		mInternals->mDocumentMapsLock.unlockForReading();
-		updateFromDocumentIDs -= existingFromDocumentIDs;
 		updateFromDocumentIDs -= (*batch)->documentIDsGet((*association)->getFromDocumentType());
-		if (!updateFromDocumentIDs.isEmpty())
-			return OV<SError>(getUnknownDocumentIDError(updateFromDocumentIDs.getArray()[0]));
-
-		mInternals->mDocumentMapsLock.lockForReading();
-		TNSet<CString>	existingToDocumentIDs =
-								mInternals->mDocumentIDsByDocumentType.get((*association)->getToDocumentType(),
-										TNSet<CString>());
-		mInternals->mDocumentMapsLock.unlockForReading();
-		updateToDocumentIDs -= existingToDocumentIDs;
+		OV<CString>	unknownFromDocumentID =
+							mInternals->documentIDGetFirstUnknown((*association)->getFromDocumentType(),
+									updateFromDocumentIDs.getArray());
+		if (unknownFromDocumentID.hasValue())
+			return OV<SError>(getUnknownDocumentIDError(*unknownFromDocumentID));
+
 		updateToDocumentIDs -= (*batch)->documentIDsGet((*association)->getToDocumentType());
-		if (!updateToDocumentIDs.isEmpty())
-			return OV<SError>(getUnknownDocumentIDError(updateToDocumentIDs.getArray()[0]));
+		OV<CString>	unknownToDocumentID =
+							mInternals->documentIDGetFirstUnknown((*association)->getToDocumentType(),
+									updateToDocumentIDs.getArray());
+		if (unknownToDocumentID.hasValue())
+			return OV<SError>(getUnknownDocumentIDError(*unknownToDocumentID));
 
 		// Update
 		(*batch)->associationNoteUpdated(name, updates);
 	} else {
 		// Not in batch
-		mInternals->mDocumentMapsLock.lockForReading();
-		TNSet<CString>	existingFromDocumentIDs =
-								mInternals->mDocumentIDsByDocumentType.get((*association)->getFromDocumentType(),
-										TNSet<CString>());
-		mInternals->mDocumentMapsLock.unlockForReading();
-		updateFromDocumentIDs -= existingFromDocumentIDs;
-		if (!updateFromDocumentIDs.isEmpty())
-			return OV<SError>(getUnknownDocumentIDError(updateFromDocumentIDs.getArray()[0]));
-
-		mInternals->mDocumentMapsLock.lockForReading();
-		TNSet<CString>	existingToDocumentIDs =
-								mInternals->mDocumentIDsByDocumentType.get((*association)->getToDocumentType(),
-										TNSet<CString>());
-		mInternals->mDocumentMapsLock.unlockForReading();
-		updateToDocumentIDs -= existingToDocumentIDs;
-		if (!updateToDocumentIDs.isEmpty())
-			return OV<SError>(getUnknownDocumentIDError(updateToDocumentIDs.getArray()[0]));
-
-		// Iterate updates
-		for (TArray<CMDSAssociation::Update>::Iterator iterator = updates.getIterator(); iterator; iterator++)
-			// Check Add or Remove
-			if (iterator->getAction() == CMDSAssociation::Update::kActionAdd)
-				// Add
-				mInternals->mAssociationItemsByName.add(name, iterator->getItem());
-			else
-				// Remove
-				mInternals->mAssociationItemsByName.remove(name, iterator->getItem());
+		OV<CString>	unknownFromDocumentID =
+							mInternals->documentIDGetFirstUnknown((*association)->getFromDocumentType(),
+									updateFromDocumentIDs.getArray());
+		if (unknownFromDocumentID.hasValue())
+			return OV<SError>(getUnknownDocumentIDError(*unknownFromDocumentID));
+
+		OV<CString>	unknownToDocumentID =
+							mInternals->documentIDGetFirstUnknown((*association)->getToDocumentType(),
+									updateToDocumentIDs.getArray());
+		if (unknownToDocumentID.hasValue())
+			return OV<SError>(getUnknownDocumentIDError(*unknownToDocumentID));
+
+		// Update
+		mInternals->associationUpdate(name, updates);
 	}
 
 	return OV<SError>();
@@ -1078,6 +2022,9 @@ OV<SError> CMDSEphemeral::cacheRegister(const CString& name, const CString& docu
 	I<MDSCache>	cache(new MDSCache(name, documentType, relevantProperties, _cacheValueInfos, 0));
 
 	// Add to maps
+	mInternals->mCacheValuesLock.lockForWriting();
+	mInternals->mCacheValuesByName.set(name, MDSCacheValueMap());
+	mInternals->mCacheValuesLock.unlockForWriting();
 	mInternals->mCacheByName.set(name, cache);
 	mInternals->mCachesByDocumentType.add(documentType, cache);
 
@@ -1107,9 +2054,8 @@ TVResult<TArray<CDictionary> > CMDSEphemeral::cacheGetValues(const CString& name
 	}
 
 	// Setup
-	TDictionary<CDictionary>	cacheValuesByDocumentID =
-										mInternals->mCacheValuesByName.get((*cache)->getName(),
-												TNDictionary<CDictionary>());
+	OV<MDSCacheValueMap>	cacheValueMap = mInternals->cacheGetValueMap((*cache)->getName());
+	MDSCacheValueMap		cacheValuesByDocumentID = cacheValueMap.hasValue() ? *cacheValueMap : MDSCacheValueMap();
 
 	// Check if have documentIDs
 	TNArray<CDictionary>	infos;
@@ -1174,12 +2120,14 @@ OV<SError> CMDSEphemeral::collectionRegister(const CString& name, const CString&
 	UInt32	lastRevision;
 	if (isUpToDate) {
 		// Get current last revision
-		mInternals->mDocumentLastRevisionByDocumentTypeLock.lock();
-		lastRevision = mInternals->mDocumentLastRevisionByDocumentType.getUInt32(documentType, 0);
-		mInternals->mDocumentLastRevisionByDocumentTypeLock.unlock();
+		OR<Internals::DocumentTypePartition>	documentTypePartition =
+														mInternals->documentTypePartitionGet(documentType);
+		lastRevision = documentTypePartition.hasReference() ? documentTypePartition->getLastRevision() : 0;
 	} else {
 		// Start fresh
-		mInternals->mCollectionValuesByName.remove(name);
+		mInternals->mCollectionDocumentIDsLock.lockForWriting();
+		mInternals->mCollectionDocumentIDsByName.remove(name);
+		mInternals->mCollectionDocumentIDsLock.unlockForWriting();
 		lastRevision = 0;
 	}
 
@@ -1188,6 +2136,11 @@ OV<SError> CMDSEphemeral::collectionRegister(const CString& name, const CString&
 										checkRelevantProperties, isIncludedInfo, lastRevision));
 
 	// Add to maps
+	mInternals->mCollectionDocumentIDsLock.lockForWriting();
+	if (!mInternals->mCollectionDocumentIDsByName.contains(name))
+		// Start empty
+		mInternals->mCollectionDocumentIDsByName.set(name, Internals::OrderedDocumentIDs());
+	mInternals->mCollectionDocumentIDsLock.unlockForWriting();
 	mInternals->mCollectionByName.set(name, collection);
 	mInternals->mCollectionsByDocumentType.add(documentType, collection);
 
@@ -1205,13 +2158,20 @@ TVResult<UInt32> CMDSEphemeral::collectionGetDocumentCount(const CString& name)
 //----------------------------------------------------------------------------------------------------------------------
 {
 	// Validate
-	const	OR<TNArray<CString> >	documentIDs = mInternals->mCollectionValuesByName.get(name);
-	if (!documentIDs.hasReference())
+	mInternals->mCollectionDocumentIDsLock.lockForReading();
+	const	OR<Internals::OrderedDocumentIDs>	collectionDocumentIDs =
+															mInternals->mCollectionDocumentIDsByName.get(name);
+			OV<UInt32>							count =
+															collectionDocumentIDs.hasReference() ?
+																	OV<UInt32>(collectionDocumentIDs->getCount()) :
+																	OV<UInt32>();
+	mInternals->mCollectionDocumentIDsLock.unlockForReading();
+	if (!count.hasValue())
 		return TVResult<UInt32>(getUnknownCollectionError(name));
-	if (mInternals->mBatchByThreadRef[CThread::getCurrentRefAsString()].hasReference())
+	if (mInternals->mBatchByThread.get().hasReference())
 		return TVResult<UInt32>(getIllegalInBatchError());
 
-	return TVResult<UInt32>(documentIDs->getCount());
+	return TVResult<UInt32>(*count);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -1220,10 +2180,10 @@ OV<SError> CMDSEphemeral::collectionIterate(const CString& name, const CString&
 //----------------------------------------------------------------------------------------------------------------------
 {
 	// Validate
-	const	OR<TNArray<CString> >	documentIDs = mInternals->mCollectionValuesByName.get(name);
-	if (!documentIDs.hasReference())
+	OV<TNArray<CString> >	documentIDs = mInternals->collectionGetDocumentIDs(name);
+	if (!documentIDs.hasValue())
 		return OV<SError>(getUnknownCollectionError(name));
-	if (mInternals->mBatchByThreadRef[CThread::getCurrentRefAsString()].hasReference())
+	if (mInternals->mBatchByThread.get().hasReference())
 		return OV<SError>(getIllegalInBatchError());
 
 	// Setup
@@ -1247,7 +2207,7 @@ TVResult<TArray<CMDSDocument::CreateResultInfo> > CMDSEphemeral::documentCreate(
 	TNArray<CMDSDocument::CreateResultInfo>	documentCreateResultInfos;
 
 	// Check for batch
-	const	OR<I<Internals::Batch> >	batch = mInternals->mBatchByThreadRef[CThread::getCurrentRefAsString()];
+	const	OR<I<Internals::Batch> >	batch = mInternals->mBatchByThread.get();
 	if (batch.hasReference()) {
 		// In batch
 		for (TArray<CMDSDocument::CreateInfo>::Iterator iterator = documentCreateInfos.getIterator(); iterator;
@@ -1266,7 +2226,10 @@ TVResult<TArray<CMDSDocument::CreateResultInfo> > CMDSEphemeral::documentCreate(
 		}
 	} else {
 		// Setup
-		TNArray<MDSUpdateInfo>	updateInfos;
+		Internals::DocumentTypePartition&	documentTypePartition =
+													mInternals->documentTypePartitionGetOrCreate(
+															documentInfoForNew.getDocumentType());
+		TNArray<MDSUpdateInfo>				updateInfos;
 
 		// Iterate document create infos
 		for (TArray<CMDSDocument::CreateInfo>::Iterator iterator = documentCreateInfos.getIterator(); iterator;
@@ -1287,7 +2250,7 @@ TVResult<TArray<CMDSDocument::CreateResultInfo> > CMDSEphemeral::documentCreate(
 			mInternals->mDocumentsBeingCreatedPropertyMapByDocumentID.remove(documentID);
 
 			// Add document
-			UInt32							revision = mInternals->nextRevision(documentInfoForNew.getDocumentType());
+			UInt32							revision = documentTypePartition.nextRevision();
 			UniversalTime					creationUniversalTime =
 													iterator->getCreationUniversalTime().getValue(universalTime);
 			UniversalTime					modificationUniversalTime =
@@ -1296,10 +2259,9 @@ TVResult<TArray<CMDSDocument::CreateResultInfo> > CMDSEphemeral::documentCreate(
 													new Internals::DocumentBacking(documentID, revision,
 															creationUniversalTime, modificationUniversalTime,
 															propertyMap));
-			mInternals->mDocumentMapsLock.lockForWriting();
-			mInternals->mDocumentBackingByDocumentID.set(documentID, documentBacking);
-			mInternals->mDocumentIDsByDocumentType.insert(documentInfoForNew.getDocumentType(), documentID);
-			mInternals->mDocumentMapsLock.unlockForWriting();
+			documentTypePartition.mLock.lockForWriting();
+			documentTypePartition.add(documentBacking);
+			documentTypePartition.mLock.unlockForWriting();
 			documentCreateResultInfos +=
 					CMDSDocument::CreateResultInfo(document,
 							CMDSDocument::OverviewInfo(documentID, revision, creationUniversalTime,
@@ -1324,15 +2286,18 @@ TVResult<UInt32> CMDSEphemeral::documentGetCount(const CString& documentType) co
 //----------------------------------------------------------------------------------------------------------------------
 {
 	// Validate
-	mInternals->mDocumentMapsLock.lockForReading();
-	const	OR<TNSet<CString> >	documentIDs = mInternals->mDocumentIDsByDocumentType.get(documentType);
-	mInternals->mDocumentMapsLock.unlockForReading();
-	if (!documentIDs.hasReference())
+	OR<Internals::DocumentTypePartition>	documentTypePartition = mInternals->documentTypePartitionGet(documentType);
+	if (!documentTypePartition.hasReference())
 		return TVResult<UInt32>(getUnknownDocumentTypeError(documentType));
-	if (mInternals->mBatchByThreadRef[CThread::getCurrentRefAsString()].hasReference())
+	if (mInternals->mBatchByThread.get().hasReference())
 		return TVResult<UInt32>(getIllegalInBatchError());
 
-	return TVResult<UInt32>(documentIDs->getCount());
+	// Get count
+	documentTypePartition->mLock.lockForReading();
+	UInt32	count = documentTypePartition->getDocumentCount();
+	documentTypePartition->mLock.unlockForReading();
+
+	return TVResult<UInt32>(count);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -1341,7 +2306,7 @@ OV<SError> CMDSEphemeral::documentIterate(const CMDSDocument::Info& documentInfo
 //----------------------------------------------------------------------------------------------------------------------
 {
 	// Setup
-	const	OR<I<Internals::Batch> >	batch = mInternals->mBatchByThreadRef[CThread::getCurrentRefAsString()];
+	const	OR<I<Internals::Batch> >	batch = mInternals->mBatchByThread.get();
 
 	// Iterate document IDs
 	TNArray<CString>	documentIDsForDocumentBackings;
@@ -1375,7 +2340,7 @@ OV<SError> CMDSEphemeral::documentIterate(const CMDSDocument::Info& documentInfo
 //----------------------------------------------------------------------------------------------------------------------
 {
 	// Validate
-	const	OR<I<Internals::Batch> >	batch = mInternals->mBatchByThreadRef[CThread::getCurrentRefAsString()];
+	const	OR<I<Internals::Batch> >	batch = mInternals->mBatchByThread.get();
 	if (batch.hasReference())
 		return OV<SError>(getIllegalInBatchError());
 
@@ -1394,28 +2359,26 @@ OV<SError> CMDSEphemeral::documentIterate(const CMDSDocument::Info& documentInfo
 }
 
 //----------------------------------------------------------------------------------------------------------------------
-UniversalTime CMDSEphemeral::documentCreationUniversalTime(const I<CMDSDocument>& document) const
+UniversalTime CMDSEphemeral::documentCreationUniversalTime(const CMDSDocument& document) const
 //----------------------------------------------------------------------------------------------------------------------
 {
 	// Check for batch
-	const	OR<I<Internals::Batch> >			batch = mInternals->mBatchByThreadRef[CThread::getCurrentRefAsString()];
+	const	OR<I<Internals::Batch> >			batch = mInternals->mBatchByThread.get();
 			OR<Internals::BatchDocumentInfo>	batchDocumentInfo =
 														batch.hasReference() ?
-																(*batch)->documentInfoGet(document->getID()) :
+																(*batch)->documentInfoGet(document.getID()) :
 																OR<Internals::BatchDocumentInfo>();
 	if (batchDocumentInfo.hasReference())
 		// In batch
 		return batchDocumentInfo->getCreationUniversalTime();
-	else if (mInternals->mDocumentsBeingCreatedPropertyMapByDocumentID.contains(document->getID()))
+	else if (mInternals->mDocumentsBeingCreatedPropertyMapByDocumentID.contains(document.getID()))
 		// Being created
 		return SUniversalTime::getCurrent();
 	else {
 		// "Idle"
-		mInternals->mDocumentMapsLock.lockForReading();
 		const	OR<I<Internals::DocumentBacking> >	documentBacking =
-															mInternals->mDocumentBackingByDocumentID.get(
-																	document->getID());
-		mInternals->mDocumentMapsLock.unlockForReading();
+															mInternals->documentBackingGet(document.getDocumentType(),
+																	document.getID());
 
 		return documentBacking.hasReference() ?
 				(*documentBacking)->getCreationUniversalTime() : SUniversalTime::getCurrent();
@@ -1423,28 +2386,26 @@ UniversalTime CMDSEphemeral::documentCreationUniversalTime(const I<CMDSDocument>
 }
 
 //----------------------------------------------------------------------------------------------------------------------
-UniversalTime CMDSEphemeral::documentModificationUniversalTime(const I<CMDSDocument>& document) const
+UniversalTime CMDSEphemeral::documentModificationUniversalTime(const CMDSDocument& document) const
 //----------------------------------------------------------------------------------------------------------------------
 {
 	// Check for batch
-	const	OR<I<Internals::Batch> >			batch = mInternals->mBatchByThreadRef[CThread::getCurrentRefAsString()];
+	const	OR<I<Internals::Batch> >			batch = mInternals->mBatchByThread.get();
 			OR<Internals::BatchDocumentInfo>	batchDocumentInfo =
 														batch.hasReference() ?
-																(*batch)->documentInfoGet(document->getID()) :
+																(*batch)->documentInfoGet(document.getID()) :
 																OR<Internals::BatchDocumentInfo>();
 	if (batchDocumentInfo.hasReference())
 		// In batch
 		return batchDocumentInfo->getModificationUniversalTime();
-	else if (mInternals->mDocumentsBeingCreatedPropertyMapByDocumentID.contains(document->getID()))
+	else if (mInternals->mDocumentsBeingCreatedPropertyMapByDocumentID.contains(document.getID()))
 		// Being created
 		return SUniversalTime::getCurrent();
 	else {
 		// "Idle"
-		mInternals->mDocumentMapsLock.lockForReading();
 		const	OR<I<Internals::DocumentBacking> >	documentBacking =
-															mInternals->mDocumentBackingByDocumentID.get(
-																	document->getID());
-		mInternals->mDocumentMapsLock.unlockForReading();
+															mInternals->documentBackingGet(document.getDocumentType(),
+																	document.getID());
 
 		return documentBacking.hasReference() ?
 				(*documentBacking)->getModificationUniversalTime() : SUniversalTime::getCurrent();
@@ -1452,34 +2413,33 @@ UniversalTime CMDSEphemeral::documentModificationUniversalTime(const I<CMDSDocum
 }
 
 //----------------------------------------------------------------------------------------------------------------------
-OV<SValue> CMDSEphemeral::documentValue(const CString& property, const I<CMDSDocument>& document) const
+OV<SValue> CMDSEphemeral::documentValue(const CString& property, const CMDSDocument& document) const
 //----------------------------------------------------------------------------------------------------------------------
 {
 	// Check for batch
-	const	OR<I<Internals::Batch> >			batch = mInternals->mBatchByThreadRef[CThread::getCurrentRefAsString()];
+	const	OR<I<Internals::Batch> >			batch = mInternals->mBatchByThread.get();
 			OR<Internals::BatchDocumentInfo>	batchDocumentInfo =
 														batch.hasReference() ?
-																(*batch)->documentInfoGet(document->getID()) :
+																(*batch)->documentInfoGet(document.getID()) :
 																OR<Internals::BatchDocumentInfo>();
 	if (batchDocumentInfo.hasReference())
 		// In batch
 		return batchDocumentInfo->getValue(property);
-	else if (mInternals->mDocumentsBeingCreatedPropertyMapByDocumentID.contains(document->getID()))
+	else if (mInternals->mDocumentsBeingCreatedPropertyMapByDocumentID.contains(document.getID()))
 		// Being created
-		return mInternals->mDocumentsBeingCreatedPropertyMapByDocumentID[document->getID()]->getOValue(property);
+		return mInternals->mDocumentsBeingCreatedPropertyMapByDocumentID[document.getID()]->getOValue(property);
 	else {
 		// "Idle"
-		mInternals->mDocumentMapsLock.lockForReading();
 		const	OR<I<Internals::DocumentBacking> >	documentBacking =
-															mInternals->mDocumentBackingByDocumentID[document->getID()];
-		mInternals->mDocumentMapsLock.unlockForReading();
+															mInternals->documentBackingGet(document.getDocumentType(),
+																	document.getID());
 
 		return (*documentBacking)->getPropertyMap().getOValue(property);
 	}
 }
 
 //----------------------------------------------------------------------------------------------------------------------
-OV<CData> CMDSEphemeral::documentData(const CString& property, const I<CMDSDocument>& document) const
+OV<CData> CMDSEphemeral::documentData(const CString& property, const CMDSDocument& document) const
 //----------------------------------------------------------------------------------------------------------------------
 {
 	// Get value
@@ -1489,7 +2449,7 @@ OV<CData> CMDSEphemeral::documentData(const CString& property, const I<CMDSDocum
 }
 
 //----------------------------------------------------------------------------------------------------------------------
-OV<UniversalTime> CMDSEphemeral::documentUniversalTime(const CString& property, const I<CMDSDocument>& document) const
+OV<UniversalTime> CMDSEphemeral::documentUniversalTime(const CString& property, const CMDSDocument& document) const
 //----------------------------------------------------------------------------------------------------------------------
 {
 	// Get value
@@ -1500,27 +2460,25 @@ OV<UniversalTime> CMDSEphemeral::documentUniversalTime(const CString& property,
 }
 
 //----------------------------------------------------------------------------------------------------------------------
-void CMDSEphemeral::documentSet(const CString& property, const OV<SValue>& value, const I<CMDSDocument>& document,
+void CMDSEphemeral::documentSet(const CString& property, const OV<SValue>& value, const CMDSDocument& document,
 		SetValueKind setValueKind)
 //----------------------------------------------------------------------------------------------------------------------
 {
 	// Setup
-	const	CString&	documentType = document->getDocumentType();
+	const	CString&	documentType = document.getDocumentType();
 
 	// Check for batch
-	const	OR<I<Internals::Batch> >	batch = mInternals->mBatchByThreadRef[CThread::getCurrentRefAsString()];
+	const	OR<I<Internals::Batch> >	batch = mInternals->mBatchByThread.get();
 	if (batch.hasReference()) {
 		// In batch
-		const	OR<Internals::BatchDocumentInfo>	batchDocumentInfo = (*batch)->documentInfoGet(document->getID());
+		const	OR<Internals::BatchDocumentInfo>	batchDocumentInfo = (*batch)->documentInfoGet(document.getID());
 		if (batchDocumentInfo.hasReference())
 			// Have document in batch
 			batchDocumentInfo->set(property, value);
 		else {
 			// Don't have document in batch
-			mInternals->mDocumentMapsLock.lockForReading();
 			OR<I<Internals::DocumentBacking> >	documentBacking =
-														mInternals->mDocumentBackingByDocumentID.get(document->getID());
-			mInternals->mDocumentMapsLock.unlockForReading();
+														mInternals->documentBackingGet(documentType, document.getID());
 
 			(*batch)->documentAdd(documentType, R<I<Internals::DocumentBacking> >(*documentBacking))
 					.set(property, value);
@@ -1528,26 +2486,29 @@ void CMDSEphemeral::documentSet(const CString& property, const OV<SValue>& value
 	} else {
 		// Check if being created
 		const	OR<CDictionary>	propertyMap =
-										mInternals->mDocumentsBeingCreatedPropertyMapByDocumentID[document->getID()];
+										mInternals->mDocumentsBeingCreatedPropertyMapByDocumentID[document.getID()];
 		if (propertyMap.hasReference())
 			// Being created
 			propertyMap->set(property, value);
 		else {
 			// "Idle"
-			mInternals->mDocumentMapsLock.lockForWriting();
+			Internals::DocumentTypePartition&	documentTypePartition =
+														*mInternals->documentTypePartitionGet(documentType);
+			documentTypePartition.mLock.lockForWriting();
 			OR<I<Internals::DocumentBacking> >	documentBacking =
-														mInternals->mDocumentBackingByDocumentID.get(document->getID());
+														documentTypePartition.getDocumentBacking(document.getID());
 			(*documentBacking)->getPropertyMap().set(property, value);
-			mInternals->mDocumentMapsLock.unlockForWriting();
+			documentTypePartition.mLock.unlockForWriting();
 
 			// Update stuffs
+			I<CMDSDocument>	documentInstance = document.makeI();
 			mInternals->update(documentType,
 					TSArray<MDSUpdateInfo>(
-							MDSUpdateInfo(document, (*documentBacking)->getRevision(), document->getID(),
+							MDSUpdateInfo(documentInstance, (*documentBacking)->getRevision(), document.getID(),
 									TSSet<CString>(property))));
 
 			// Call document changed procs
-			notifyDocumentChanged(document, CMDSDocument::kChangeKindUpdated);
+			notifyDocumentChanged(documentInstance, CMDSDocument::kChangeKindUpdated);
 		}
 	}
 }
@@ -1558,14 +2519,11 @@ TVResult<CMDSDocument::AttachmentInfo> CMDSEphemeral::documentAttachmentAdd(cons
 //----------------------------------------------------------------------------------------------------------------------
 {
 	// Validate
-	mInternals->mDocumentMapsLock.lockForReading();
-	bool	isKnownDocumentType = mInternals->mDocumentIDsByDocumentType.contains(documentType);
-	mInternals->mDocumentMapsLock.unlockForReading();
-	if (!isKnownDocumentType)
+	if (!mInternals->documentTypePartitionGet(documentType).hasReference())
 		return TVResult<CMDSDocument::AttachmentInfo>(getUnknownDocumentTypeError(documentType));
 
 	// Check for batch
-	const	OR<I<Internals::Batch> >	batch = mInternals->mBatchByThreadRef[CThread::getCurrentRefAsString()];
+	const	OR<I<Internals::Batch> >	batch = mInternals->mBatchByThread.get();
 	if (batch.hasReference()) {
 		// In batch
 		const	OR<Internals::BatchDocumentInfo>	batchDocumentInfo = (*batch)->documentInfoGet(documentID);
@@ -1574,10 +2532,8 @@ TVResult<CMDSDocument::AttachmentInfo> CMDSEphemeral::documentAttachmentAdd(cons
 			return TVResult<CMDSDocument::AttachmentInfo>(batchDocumentInfo->attachmentAdd(info, content));
 		else {
 			// Don't have document in batch
-			mInternals->mDocumentMapsLock.lockForReading();
 			OR<I<Internals::DocumentBacking> >	documentBacking =
-														mInternals->mDocumentBackingByDocumentID.get(documentID);
-			mInternals->mDocumentMapsLock.unlockForReading();
+														mInternals->documentBackingGet(documentType, documentID);
 			if (!documentBacking.hasReference())
 				return TVResult<CMDSDocument::AttachmentInfo>(getUnknownDocumentIDError(documentID));
 
@@ -1587,15 +2543,18 @@ TVResult<CMDSDocument::AttachmentInfo> CMDSEphemeral::documentAttachmentAdd(cons
 		}
 	} else {
 		// Not in batch
+		Internals::DocumentTypePartition&	documentTypePartition = *mInternals->documentTypePartitionGet(documentType);
 		OV<CMDSDocument::AttachmentInfo>	documentAttachmentInfo;
-		mInternals->mDocumentMapsLock.lockForWriting();
-		OR<I<Internals::DocumentBacking> >	documentBacking = mInternals->mDocumentBackingByDocumentID.get(documentID);
-		if (documentBacking.hasReference())
+		documentTypePartition.mLock.lockForWriting();
+		OR<I<Internals::DocumentBacking> >	documentBacking = documentTypePartition.getDocumentBacking(documentID);
+		if (documentBacking.hasReference()) {
 			// Add attachment
 			documentAttachmentInfo.setValue(
-					(*documentBacking)->attachmentAdd(CUUID().getBase64String(), mInternals->nextRevision(documentType),
+					(*documentBacking)->attachmentAdd(CUUID().getBase64String(), documentTypePartition.nextRevision(),
 							info, content));
-		mInternals->mDocumentMapsLock.unlockForWriting();
+			documentTypePartition.noteRevision(**documentBacking);
+		}
+		documentTypePartition.mLock.unlockForWriting();
 
 		return documentAttachmentInfo.hasValue() ?
 				TVResult<CMDSDocument::AttachmentInfo>(*documentAttachmentInfo) :
@@ -1609,25 +2568,20 @@ TVResult<CMDSDocument::AttachmentInfoByID> CMDSEphemeral::documentAttachmentInfo
 //----------------------------------------------------------------------------------------------------------------------
 {
 	// Validate
-	mInternals->mDocumentMapsLock.lockForReading();
-	bool	isKnownDocumentType = mInternals->mDocumentIDsByDocumentType.contains(documentType);
-	mInternals->mDocumentMapsLock.unlockForReading();
-	if (!isKnownDocumentType)
+	if (!mInternals->documentTypePartitionGet(documentType).hasReference())
 		return TVResult<CMDSDocument::AttachmentInfoByID>(getUnknownDocumentTypeError(documentType));
 
 	// Check for batch
-	const	OR<I<Internals::Batch> >			batch = mInternals->mBatchByThreadRef[CThread::getCurrentRefAsString()];
+	const	OR<I<Internals::Batch> >			batch = mInternals->mBatchByThread.get();
 			OR<Internals::BatchDocumentInfo>	batchDocumentInfo =
 														batch.hasReference() ?
 																(*batch)->documentInfoGet(documentID) :
 																OR<Internals::BatchDocumentInfo>();
 	if (batchDocumentInfo.hasReference()) {
 		// Have document in batch
-		mInternals->mDocumentMapsLock.lockForReading();
 		CMDSDocument::AttachmentInfoByID	documentAttachmentInfoByID =
-													(*mInternals->mDocumentBackingByDocumentID.get(documentID))->
+													(*mInternals->documentBackingGet(documentType, documentID))->
 															getDocumentAttachmentInfoByID();
-		mInternals->mDocumentMapsLock.unlockForReading();
 
 		return TVResult<CMDSDocument::AttachmentInfoByID>(
 				batchDocumentInfo->getUpdatedDocumentAttachmentInfoByID(documentAttachmentInfoByID));
@@ -1636,9 +2590,7 @@ TVResult<CMDSDocument::AttachmentInfoByID> CMDSEphemeral::documentAttachmentInfo
 		return TVResult<CMDSDocument::AttachmentInfoByID>(TNDictionary<CMDSDocument::AttachmentInfo>());
 
 	// Not in batch, not creating
-	mInternals->mDocumentMapsLock.lockForReading();
-	OR<I<Internals::DocumentBacking> >	documentBacking = mInternals->mDocumentBackingByDocumentID.get(documentID);
-	mInternals->mDocumentMapsLock.unlockForReading();
+	OR<I<Internals::DocumentBacking> >	documentBacking = mInternals->documentBackingGet(documentType, documentID);
 
 	return documentBacking.hasReference() ?
 			TVResult<CMDSDocument::AttachmentInfoByID>((*documentBacking)->getDocumentAttachmentInfoByID()) :
@@ -1651,14 +2603,11 @@ TVResult<CData> CMDSEphemeral::documentAttachmentContent(const CString& document
 //----------------------------------------------------------------------------------------------------------------------
 {
 	// Validate
-	mInternals->mDocumentMapsLock.lockForReading();
-	bool	isKnownDocumentType = mInternals->mDocumentIDsByDocumentType.contains(documentType);
-	mInternals->mDocumentMapsLock.unlockForReading();
-	if (!isKnownDocumentType)
+	if (!mInternals->documentTypePartitionGet(documentType).hasReference())
 		return TVResult<CData>(getUnknownDocumentTypeError(documentType));
 
 	// Check situation
-	const	OR<I<Internals::Batch> >			batch = mInternals->mBatchByThreadRef[CThread::getCurrentRefAsString()];
+	const	OR<I<Internals::Batch> >			batch = mInternals->mBatchByThread.get();
 			OR<Internals::BatchDocumentInfo>	batchDocumentInfo =
 														batch.hasReference() ?
 																(*batch)->documentInfoGet(documentID) :
@@ -1675,13 +2624,14 @@ TVResult<CData> CMDSEphemeral::documentAttachmentContent(const CString& document
 		return TVResult<CData>(getUnknownAttachmentIDError(attachmentID));
 
 	// Get non-batch attachment content
-	mInternals->mDocumentMapsLock.lockForReading();
-	OR<I<Internals::DocumentBacking> >		documentBacking = mInternals->mDocumentBackingByDocumentID.get(documentID);
+	Internals::DocumentTypePartition&		documentTypePartition = *mInternals->documentTypePartitionGet(documentType);
+	documentTypePartition.mLock.lockForReading();
+	OR<I<Internals::DocumentBacking> >		documentBacking = documentTypePartition.getDocumentBacking(documentID);
 	OR<Internals::AttachmentContentInfo>	attachmentContentInfo =
 													documentBacking.hasReference() ?
 															(*documentBacking)->getAttachmentContentInfo(attachmentID) :
 															OR<Internals::AttachmentContentInfo>();
-	mInternals->mDocumentMapsLock.unlockForReading();
+	documentTypePartition.mLock.unlockForReading();
 	if (!documentBacking.hasReference())
 		return TVResult<CData>(getUnknownDocumentIDError(documentID));
 	if (!attachmentContentInfo.hasReference())
@@ -1696,18 +2646,15 @@ TVResult<OV<UInt32> > CMDSEphemeral::documentAttachmentUpdate(const CString& doc
 //----------------------------------------------------------------------------------------------------------------------
 {
 	// Validate
-	mInternals->mDocumentMapsLock.lockForReading();
-	bool								isKnownDocumentType =
-												mInternals->mDocumentIDsByDocumentType.contains(documentType);
-	OR<I<Internals::DocumentBacking> >	documentBacking = mInternals->mDocumentBackingByDocumentID.get(documentID);
-	mInternals->mDocumentMapsLock.unlockForReading();
-	if (!isKnownDocumentType)
+	if (!mInternals->documentTypePartitionGet(documentType).hasReference())
 		return TVResult<OV<UInt32> >(getUnknownDocumentTypeError(documentType));
+
+	OR<I<Internals::DocumentBacking> >	documentBacking = mInternals->documentBackingGet(documentType, documentID);
 	if (!documentBacking.hasReference())
 		return TVResult<OV<UInt32> >(getUnknownDocumentIDError(documentID));
 
 	// Check for batch
-	const	OR<I<Internals::Batch> >	batch = mInternals->mBatchByThreadRef[CThread::getCurrentRefAsString()];
+	const	OR<I<Internals::Batch> >	batch = mInternals->mBatchByThread.get();
 	if (batch.hasReference()) {
 		// In batch
 		const	OR<Internals::BatchDocumentInfo>	batchDocumentInfo = (*batch)->documentInfoGet(documentID);
@@ -1742,11 +2689,13 @@ TVResult<OV<UInt32> > CMDSEphemeral::documentAttachmentUpdate(const CString& doc
 		if (!attachmentContentInfo.hasReference())
 			return TVResult<OV<UInt32> >(getUnknownAttachmentIDError(attachmentID));
 
-		mInternals->mDocumentMapsLock.lockForWriting();
+		Internals::DocumentTypePartition&	documentTypePartition = *mInternals->documentTypePartitionGet(documentType);
+		documentTypePartition.mLock.lockForWriting();
 		UInt32	revision =
-						(*documentBacking)->attachmentUpdate(mInternals->nextRevision(documentType), attachmentID,
+						(*documentBacking)->attachmentUpdate(documentTypePartition.nextRevision(), attachmentID,
 								updatedInfo, updatedContent);
-		mInternals->mDocumentMapsLock.unlockForWriting();
+		documentTypePartition.noteRevision(**documentBacking);
+		documentTypePartition.mLock.unlockForWriting();
 
 		return TVResult<OV<UInt32> >(OV<UInt32>(revision));
 	}
@@ -1758,18 +2707,15 @@ OV<SError> CMDSEphemeral::documentAttachmentRemove(const CString& documentType,
 //----------------------------------------------------------------------------------------------------------------------
 {
 	// Validate
-	mInternals->mDocumentMapsLock.lockForReading();
-	bool								isKnownDocumentType =
-												mInternals->mDocumentIDsByDocumentType.contains(documentType);
-	OR<I<Internals::DocumentBacking> >	documentBacking = mInternals->mDocumentBackingByDocumentID.get(documentID);
-	mInternals->mDocumentMapsLock.unlockForReading();
-	if (!isKnownDocumentType)
+	if (!mInternals->documentTypePartitionGet(documentType).hasReference())
 		return OV<SError>(getUnknownDocumentTypeError(documentType));
+
+	OR<I<Internals::DocumentBacking> >	documentBacking = mInternals->documentBackingGet(documentType, documentID);
 	if (!documentBacking.hasReference())
 		return OV<SError>(getUnknownDocumentIDError(documentID));
 
 	// Check for batch
-	const	OR<I<Internals::Batch> >	batch = mInternals->mBatchByThreadRef[CThread::getCurrentRefAsString()];
+	const	OR<I<Internals::Batch> >	batch = mInternals->mBatchByThread.get();
 	if (batch.hasReference()) {
 		// In batch
 		const	OR<Internals::BatchDocumentInfo>	batchDocumentInfo = (*batch)->documentInfoGet(documentID);
@@ -1802,49 +2748,50 @@ OV<SError> CMDSEphemeral::documentAttachmentRemove(const CString& documentType,
 		if (!attachmentContentInfo.hasReference())
 			return OV<SError>(getUnknownAttachmentIDError(attachmentID));
 
-		mInternals->mDocumentMapsLock.lockForWriting();
-		(*documentBacking)->attachmentRemove(mInternals->nextRevision(documentType), attachmentID);
-		mInternals->mDocumentMapsLock.unlockForWriting();
+		Internals::DocumentTypePartition&	documentTypePartition = *mInternals->documentTypePartitionGet(documentType);
+		documentTypePartition.mLock.lockForWriting();
+		(*documentBacking)->attachmentRemove(documentTypePartition.nextRevision(), attachmentID);
+		documentTypePartition.noteRevision(**documentBacking);
+		documentTypePartition.mLock.unlockForWriting();
 
 		return OV<SError>();
 	}
 }
 
 //----------------------------------------------------------------------------------------------------------------------
-OV<SError> CMDSEphemeral::documentRemove(const I<CMDSDocument>& document)
+OV<SError> CMDSEphemeral::documentRemove(const CMDSDocument& document)
 //----------------------------------------------------------------------------------------------------------------------
 {
 	// Setup
-	const	CString&	documentType = document->getDocumentType();
+	const	CString&	documentType = document.getDocumentType();
 
 	// Check for batch
-	const	OR<I<Internals::Batch> >	batch = mInternals->mBatchByThreadRef[CThread::getCurrentRefAsString()];
+	const	OR<I<Internals::Batch> >	batch = mInternals->mBatchByThread.get();
 	if (batch.hasReference()) {
 		// In batch
-		const	OR<Internals::BatchDocumentInfo>	batchDocumentInfo = (*batch)->documentInfoGet(document->getID());
+		const	OR<Internals::BatchDocumentInfo>	batchDocumentInfo = (*batch)->documentInfoGet(document.getID());
 		if (batchDocumentInfo.hasReference())
 			// Have document in batch
 			batchDocumentInfo->remove();
 		else {
 			// Don't have document in batch
-			mInternals->mDocumentMapsLock.lockForReading();
 			OR<I<Internals::DocumentBacking> >	documentBacking =
-														mInternals->mDocumentBackingByDocumentID.get(document->getID());
-			mInternals->mDocumentMapsLock.unlockForReading();
+														mInternals->documentBackingGet(documentType, document.getID());
 
 			(*batch)->documentAdd(documentType, R<I<Internals::DocumentBacking> >(*documentBacking)).remove();
 		}
 	} else {
 		// Not in batch
-		mInternals->mDocumentMapsLock.lockForWriting();
-		(*mInternals->mDocumentBackingByDocumentID.get(document->getID()))->setActive(false);
-		mInternals->mDocumentMapsLock.unlockForWriting();
+		Internals::DocumentTypePartition&	documentTypePartition = *mInternals->documentTypePartitionGet(documentType);
+		documentTypePartition.mLock.lockForWriting();
+		(*documentTypePartition.getDocumentBacking(document.getID()))->setActive(false);
+		documentTypePartition.mLock.unlockForWriting();
 
 		// Remove
-		mInternals->noteRemoved(TSSet<CString>(document->getID()));
+		mInternals->noteRemoved(documentType, TSSet<CString>(document.getID()));
 
 		// Call document changed procs
-		notifyDocumentChanged(document, CMDSDocument::ChangeKind::kChangeKindRemoved);
+		notifyDocumentChanged(document.makeI(), CMDSDocument::ChangeKind::kChangeKindRemoved);
 	}
 
 	return OV<SError>();
@@ -1866,6 +2813,9 @@ OV<SError> CMDSEphemeral::indexRegister(const CString& name, const CString& docu
 	I<MDSIndex>	index(new MDSIndex(name, documentType, relevantProperties, documentKeysPerformer, keysInfo, 0));
 
 	// Add to maps
+	mInternals->mIndexValuesLock.lockForWriting();
+	mInternals->mIndexValuesByName.set(name, Internals::IndexValues());
+	mInternals->mIndexValuesLock.unlockForWriting();
 	mInternals->mIndexByName.set(name, index);
 	mInternals->mIndexesByDocumentType.add(documentType, index);
 
@@ -1881,10 +2831,10 @@ OV<SError> CMDSEphemeral::indexIterate(const CString& name, const CString& docum
 //----------------------------------------------------------------------------------------------------------------------
 {
 	// Validate
-	const	OR<TDictionary<CString> >	items = mInternals->mIndexValuesByName.get(name);
-	if (!items.hasReference())
+	OV<TNDictionary<CString> >	items = mInternals->indexGetDocumentIDByKey(name);
+	if (!items.hasValue())
 		return OV<SError>(getUnknownIndexError(name));
-	if (mInternals->mBatchByThreadRef[CThread::getCurrentRefAsString()].hasReference())
+	if (mInternals->mBatchByThread.get().hasReference())
 		return OV<SError>(getIllegalInBatchError());
 
 	// Setup
@@ -1980,13 +2930,13 @@ OV<SError> CMDSEphemeral::batch(BatchProc batchProc, void* userData)
 	I<Internals::Batch>	batch(new Internals::Batch());
 
 	// Store
-	mInternals->mBatchByThreadRef.set(CThread::getCurrentRefAsString(), batch);
+	mInternals->mBatchByThread.set(batch);
 
 	// Call proc
 	TVResult<EMDSBatchResult>	batchResult = batchProc(userData);
 
 	// Remove
-	mInternals->mBatchByThreadRef.remove(CThread::getCurrentRefAsString());
+	mInternals->mBatchByThread.remove();
 
 	// Check result
 	ReturnErrorIfResultError(batchResult);
@@ -2000,8 +2950,12 @@ OV<SError> CMDSEphemeral::batch(BatchProc batchProc, void* userData)
 			// Setup
 			const	CString&				documentType = documentTypeIterator.getKey();
 
-			const	CMDSDocument::Info&		documentInfo = documentCreateInfo(documentType);
-					DocumentChangedInfos	documentChangedInfos = this->documentChangedInfos(documentType);
+			const	CMDSDocument::Info&					documentInfo = documentCreateInfo(documentType);
+					DocumentChangedInfos				documentChangedInfos =
+																this->documentChangedInfos(documentType);
+					Internals::DocumentTypePartition&	documentTypePartition =
+																mInternals->documentTypePartitionGetOrCreate(
+																		documentType);
 
 			// Update documents
 			TNArray<MDSUpdateInfo>	updateInfos;
@@ -2016,14 +2970,14 @@ OV<SError> CMDSEphemeral::batch(BatchProc batchProc, void* userData)
 				// Check removed
 				if (!batchDocumentInfo.isRemoved()) {
 					// Add/update document
-					mInternals->mDocumentMapsLock.lockForWriting();
+					documentTypePartition.mLock.lockForWriting();
 					OR<I<Internals::DocumentBacking> >	documentBacking =
-																mInternals->mDocumentBackingByDocumentID.get(
-																		documentID);
+																documentTypePartition.getDocumentBacking(documentID);
 					if (documentBacking.hasReference()) {
 						// Update document backing
-						(*documentBacking)->update(mInternals->nextRevision(documentType),
+						(*documentBacking)->update(documentTypePartition.nextRevision(),
 								batchDocumentInfo.getUpdatedPropertyMap(), batchDocumentInfo.getRemovedProperties());
+						documentTypePartition.noteRevision(**documentBacking);
 
 						// Process
 						TNSet<CString>	changedProperties =
@@ -2036,13 +2990,12 @@ OV<SError> CMDSEphemeral::batch(BatchProc batchProc, void* userData)
 						// Add document
 						I<Internals::DocumentBacking>	newDocumentBacking(
 																new Internals::DocumentBacking(documentID,
-																		mInternals->nextRevision(documentType),
+																		documentTypePartition.nextRevision(),
 																		batchDocumentInfo.getCreationUniversalTime(),
 																		batchDocumentInfo
 																				.getModificationUniversalTime(),
 																		batchDocumentInfo.getUpdatedPropertyMap()));
-						mInternals->mDocumentBackingByDocumentID.set(documentID, newDocumentBacking);
-						mInternals->mDocumentIDsByDocumentType.insert(documentType, documentID);
+						documentTypePartition.add(newDocumentBacking);
 
 						// Process
 						mInternals->process(documentID, batchDocumentInfo, *newDocumentBacking,
@@ -2051,16 +3004,16 @@ OV<SError> CMDSEphemeral::batch(BatchProc batchProc, void* userData)
 					}
 
 					// Unlock
-					mInternals->mDocumentMapsLock.unlockForWriting();
+					documentTypePartition.mLock.unlockForWriting();
 				} else {
 					// Remove document
 					removedDocumentIDs.insert(documentID);
 
 					// Lock
-					mInternals->mDocumentMapsLock.lockForWriting();
+					documentTypePartition.mLock.lockForWriting();
 
 					// Update maps
-					(*mInternals->mDocumentBackingByDocumentID.get(documentID))->setActive(false);
+					(*documentTypePartition.getDocumentBacking(documentID))->setActive(false);
 
 					// Check if have changed procs
 					if (!documentChangedInfos.isEmpty()) {
@@ -2075,34 +3028,22 @@ OV<SError> CMDSEphemeral::batch(BatchProc batchProc, void* userData)
 					}
 
 					// Unlock
-					mInternals->mDocumentMapsLock.unlockForWriting();
+					documentTypePartition.mLock.unlockForWriting();
 				}
 			}
 
 			// Update stuffs
-			mInternals->noteRemoved(removedDocumentIDs);
+			mInternals->noteRemoved(documentType, removedDocumentIDs);
 			mInternals->update(documentType, updateInfos);
 		}
 
 		// Iterate all association changes
 		TSet<CString>	associationNames = batch->associationGetUpdatedNames();
 		for (TSet<CString>::Iterator associationNameIterator = associationNames.getIterator(); associationNameIterator;
-				associationNameIterator++) {
-			// Iterate updates
-			TArray<CMDSAssociation::Update>	associationUpdates = batch->associationGetUpdates(*associationNameIterator);
-			for (TArray<CMDSAssociation::Update>::Iterator associationUpdateIterator = associationUpdates.getIterator();
-					associationUpdateIterator; associationUpdateIterator++) {
-				// Check action
-				if (associationUpdateIterator->getAction() == CMDSAssociation::Update::kActionAdd)
-					// Add
-					mInternals->mAssociationItemsByName.remove(*associationNameIterator,
-							associationUpdateIterator->getItem());
-				else
-					// Remove
-					mInternals->mAssociationItemsByName.add(*associationNameIterator,
-							associationUpdateIterator->getItem());
-			}
-		}
+				associationNameIterator++)
+			// Apply updates
+			mInternals->associationUpdate(*associationNameIterator,
+					batch->associationGetUpdates(*associationNameIterator));
 	}
 
 	return OV<SError>();
@@ -2117,46 +3058,27 @@ TVResult<CMDSDocumentStorageServer::DocumentRevisionInfosWithTotalCount>
 //----------------------------------------------------------------------------------------------------------------------
 {
 	// Validate
-	if (!mInternals->mAssociationByName.contains(name))
+	OR<I<CMDSAssociation> >	association = mInternals->mAssociationByName.get(name);
+	if (!association.hasReference())
 		return TVResult<CMDSDocumentStorageServer::DocumentRevisionInfosWithTotalCount>(
 				getUnknownAssociationError(name));
 
-	mInternals->mDocumentMapsLock.lockForReading();
-	bool	found = mInternals->mDocumentBackingByDocumentID.contains(fromDocumentID);
-	mInternals->mDocumentMapsLock.unlockForReading();
-	if (!found)
+	if (!mInternals->documentBackingGet((*association)->getFromDocumentType(), fromDocumentID).hasReference())
 		return TVResult<CMDSDocumentStorageServer::DocumentRevisionInfosWithTotalCount>(
 				getUnknownDocumentIDError(fromDocumentID));
 
 	// Get document IDs
-	TArray<CMDSAssociation::Item>	associationItems = mInternals->associationGetItems(name);
-	TNArray<CString>				documentIDs;
-	UInt32							toDocumentIDIndex = 0;
-	for (TArray<CMDSAssociation::Item>::Iterator iterator = associationItems.getIterator(); iterator; iterator++)
-		// Check association item
-		if (iterator->getFromDocumentID() == fromDocumentID) {
-			// Check index
-			if (toDocumentIDIndex >= startIndex)
-				// Add documentID
-				documentIDs += iterator->getToDocumentID();
-
-			// Update
-			if (count.hasValue() && (++toDocumentIDIndex > (startIndex + *count)))
-				// Done
-				break;
-		}
+	TArray<CString>	associatedDocumentIDs = mInternals->associationGetToDocumentIDs(name, fromDocumentID);
+	TArray<CString>	documentIDs = Internals::documentIDsSlice(associatedDocumentIDs, startIndex, count);
 
-		// Retrieve Document RevisionInfos
-		TNArray<CMDSDocument::RevisionInfo>	documentRevisionInfos;
-		mInternals->mDocumentMapsLock.lockForReading();
-		for (TArray<CString>::Iterator iterator = documentIDs.getIterator(); iterator; iterator++)
-			// Add Document RevisionInfo
-			documentRevisionInfos += (*mInternals->mDocumentBackingByDocumentID[*iterator])->getDocumentRevisionInfo();
-		mInternals->mDocumentMapsLock.unlockForReading();
+	// Retrieve Document RevisionInfos
+	TArray<CMDSDocument::RevisionInfo>	documentRevisionInfos =
+												mInternals->documentRevisionInfosGet(
+														(*association)->getToDocumentType(), documentIDs);
 
-		return TVResult<CMDSDocumentStorageServer::DocumentRevisionInfosWithTotalCount>(
-				CMDSDocumentStorageServer::DocumentRevisionInfosWithTotalCount(documentIDs.getCount(),
-						documentRevisionInfos));
+	return TVResult<CMDSDocumentStorageServer::DocumentRevisionInfosWithTotalCount>(
+			CMDSDocumentStorageServer::DocumentRevisionInfosWithTotalCount(associatedDocumentIDs.getCount(),
+					documentRevisionInfos));
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -2166,46 +3088,27 @@ TVResult<CMDSDocumentStorageServer::DocumentRevisionInfosWithTotalCount>
 //----------------------------------------------------------------------------------------------------------------------
 {
 	// Validate
-	if (!mInternals->mAssociationByName.contains(name))
+	OR<I<CMDSAssociation> >	association = mInternals->mAssociationByName.get(name);
+	if (!association.hasReference())
 		return TVResult<CMDSDocumentStorageServer::DocumentRevisionInfosWithTotalCount>(
 				getUnknownAssociationError(name));
 
-	mInternals->mDocumentMapsLock.lockForReading();
-	bool	found = mInternals->mDocumentBackingByDocumentID.contains(toDocumentID);
-	mInternals->mDocumentMapsLock.unlockForReading();
-	if (!found)
+	if (!mInternals->documentBackingGet((*association)->getToDocumentType(), toDocumentID).hasReference())
 		return TVResult<CMDSDocumentStorageServer::DocumentRevisionInfosWithTotalCount>(
 				getUnknownDocumentIDError(toDocumentID));
 
 	// Get document IDs
-	TArray<CMDSAssociation::Item>	associationItems = mInternals->associationGetItems(name);
-	TNArray<CString>				documentIDs;
-	UInt32							fromDocumentIDIndex = 0;
-	for (TArray<CMDSAssociation::Item>::Iterator iterator = associationItems.getIterator(); iterator; iterator++)
-		// Check association item
-		if (iterator->getToDocumentID() == toDocumentID) {
-			// Check index
-			if (fromDocumentIDIndex >= startIndex)
-				// Add documentID
-				documentIDs += iterator->getFromDocumentID();
-
-			// Update
-			if (count.hasValue() && (++fromDocumentIDIndex > (startIndex + *count)))
-				// Done
-				break;
-		}
+	TArray<CString>	associatedDocumentIDs = mInternals->associationGetFromDocumentIDs(name, toDocumentID);
+	TArray<CString>	documentIDs = Internals::documentIDsSlice(associatedDocumentIDs, startIndex, count);
 
-		// Retrieve Document RevisionInfos
-		TNArray<CMDSDocument::RevisionInfo>	documentRevisionInfos;
-		mInternals->mDocumentMapsLock.lockForReading();
-		for (TArray<CString>::Iterator iterator = documentIDs.getIterator(); iterator; iterator++)
-			// Add Document RevisionInfo
-			documentRevisionInfos += (*mInternals->mDocumentBackingByDocumentID[*iterator])->getDocumentRevisionInfo();
-		mInternals->mDocumentMapsLock.unlockForReading();
+	// Retrieve Document RevisionInfos
+	TArray<CMDSDocument::RevisionInfo>	documentRevisionInfos =
+												mInternals->documentRevisionInfosGet(
+														(*association)->getFromDocumentType(), documentIDs);
 
-		return TVResult<CMDSDocumentStorageServer::DocumentRevisionInfosWithTotalCount>(
-				CMDSDocumentStorageServer::DocumentRevisionInfosWithTotalCount(documentIDs.getCount(),
-						documentRevisionInfos));
+	return TVResult<CMDSDocumentStorageServer::DocumentRevisionInfosWithTotalCount>(
+			CMDSDocumentStorageServer::DocumentRevisionInfosWithTotalCount(associatedDocumentIDs.getCount(),
+					documentRevisionInfos));
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -2214,46 +3117,26 @@ TVResult<CMDSDocumentStorageServer::DocumentFullInfosWithTotalCount> CMDSEphemer
 //----------------------------------------------------------------------------------------------------------------------
 {
 	// Validate
-	if (!mInternals->mAssociationByName.contains(name))
+	OR<I<CMDSAssociation> >	association = mInternals->mAssociationByName.get(name);
+	if (!association.hasReference())
 		return TVResult<CMDSDocumentStorageServer::DocumentFullInfosWithTotalCount>(
 				getUnknownAssociationError(name));
 
-	mInternals->mDocumentMapsLock.lockForReading();
-	bool	found = mInternals->mDocumentBackingByDocumentID.contains(fromDocumentID);
-	mInternals->mDocumentMapsLock.unlockForReading();
-	if (!found)
+	if (!mInternals->documentBackingGet((*association)->getFromDocumentType(), fromDocumentID).hasReference())
 		return TVResult<CMDSDocumentStorageServer::DocumentFullInfosWithTotalCount>(
 				getUnknownDocumentIDError(fromDocumentID));
 
 	// Get document IDs
-	TArray<CMDSAssociation::Item>	associationItems = mInternals->associationGetItems(name);
-	TNArray<CString>				documentIDs;
-	UInt32							toDocumentIDIndex = 0;
-	for (TArray<CMDSAssociation::Item>::Iterator iterator = associationItems.getIterator(); iterator; iterator++) {
-		// Check association item
-		if (iterator->getFromDocumentID() == fromDocumentID) {
-			// Check index
-			if (toDocumentIDIndex >= startIndex)
-				// Add documentID
-				documentIDs += iterator->getToDocumentID();
-
-			// Update
-			if (count.hasValue() && (++toDocumentIDIndex > (startIndex + *count)))
-				// Done
-				break;
-		}
-	}
+	TArray<CString>	associatedDocumentIDs = mInternals->associationGetToDocumentIDs(name, fromDocumentID);
+	TArray<CString>	documentIDs = Internals::documentIDsSlice(associatedDocumentIDs, startIndex, count);
 
 	// Retrieve Document FullInfos
-	TNArray<CMDSDocument::FullInfo>	documentFullInfos;
-	mInternals->mDocumentMapsLock.lockForReading();
-	for (TArray<CString>::Iterator iterator = documentIDs.getIterator(); iterator; iterator++)
-		// Add Document FullInfo
-		documentFullInfos += (*mInternals->mDocumentBackingByDocumentID[*iterator])->getDocumentFullInfo();
-	mInternals->mDocumentMapsLock.unlockForReading();
+	TArray<CMDSDocument::FullInfo>	documentFullInfos =
+											mInternals->documentFullInfosGet((*association)->getToDocumentType(),
+													documentIDs);
 
 	return TVResult<CMDSDocumentStorageServer::DocumentFullInfosWithTotalCount>(
-			CMDSDocumentStorageServer::DocumentFullInfosWithTotalCount(documentIDs.getCount(),
+			CMDSDocumentStorageServer::DocumentFullInfosWithTotalCount(associatedDocumentIDs.getCount(),
 					documentFullInfos));
 }
 
@@ -2263,59 +3146,170 @@ TVResult<CMDSDocumentStorageServer::DocumentFullInfosWithTotalCount> CMDSEphemer
 //----------------------------------------------------------------------------------------------------------------------
 {
 	// Validate
-	if (!mInternals->mAssociationByName.contains(name))
+	OR<I<CMDSAssociation> >	association = mInternals->mAssociationByName.get(name);
+	if (!association.hasReference())
 		return TVResult<CMDSDocumentStorageServer::DocumentFullInfosWithTotalCount>(
 				getUnknownAssociationError(name));
 
-	mInternals->mDocumentMapsLock.lockForReading();
-	bool	found = mInternals->mDocumentBackingByDocumentID.contains(toDocumentID);
-	mInternals->mDocumentMapsLock.unlockForReading();
-	if (!found)
+	if (!mInternals->documentBackingGet((*association)->getToDocumentType(), toDocumentID).hasReference())
 		return TVResult<CMDSDocumentStorageServer::DocumentFullInfosWithTotalCount>(
 				getUnknownDocumentIDError(toDocumentID));
 
 	// Get document IDs
-	TArray<CMDSAssociation::Item>	associationItems = mInternals->associationGetItems(name);
-	TNArray<CString>				documentIDs;
-	UInt32							fromDocumentIDIndex = 0;
-	for (TArray<CMDSAssociation::Item>::Iterator iterator = associationItems.getIterator(); iterator; iterator++) {
-		// Check association item
-		if (iterator->getToDocumentID() == toDocumentID) {
-			// Check index
-			if (fromDocumentIDIndex >= startIndex)
-				// Add documentID
-				documentIDs += iterator->getFromDocumentID();
-
-			// Update
-			if (count.hasValue() && (++fromDocumentIDIndex > (startIndex + *count)))
-				// Done
-				break;
-		}
-	}
+	TArray<CString>	associatedDocumentIDs = mInternals->associationGetFromDocumentIDs(name, toDocumentID);
+	TArray<CString>	documentIDs = Internals::documentIDsSlice(associatedDocumentIDs, startIndex, count);
 
 	// Retrieve Document FullInfos
-	TNArray<CMDSDocument::FullInfo>	documentFullInfos;
-	mInternals->mDocumentMapsLock.lockForReading();
-	for (TArray<CString>::Iterator iterator = documentIDs.getIterator(); iterator; iterator++)
-		// Add Document FullInfo
-		documentFullInfos += (*mInternals->mDocumentBackingByDocumentID[*iterator])->getDocumentFullInfo();
-	mInternals->mDocumentMapsLock.unlockForReading();
+	TArray<CMDSDocument::FullInfo>	documentFullInfos =
+											mInternals->documentFullInfosGet((*association)->getFromDocumentType(),
+													documentIDs);
 
 	return TVResult<CMDSDocumentStorageServer::DocumentFullInfosWithTotalCount>(
-			CMDSDocumentStorageServer::DocumentFullInfosWithTotalCount(documentIDs.getCount(),
+			CMDSDocumentStorageServer::DocumentFullInfosWithTotalCount(associatedDocumentIDs.getCount(),
 					documentFullInfos));
 }
 
 //----------------------------------------------------------------------------------------------------------------------
-OV<SError> CMDSEphemeral::cacheGetStatus(const CString& name) const
+TVResult<CMDSDocumentStorageServer::DocumentRevisionInfosPage>
+				CMDSEphemeral::associationGetDocumentRevisionInfosPageFrom(
+		const CString& name, const CString& fromDocumentID, const OV<CString>& continuationToken, UInt32 count) const
+//----------------------------------------------------------------------------------------------------------------------
+{
+	// Validate
+	OR<I<CMDSAssociation> >	association = mInternals->mAssociationByName.get(name);
+	if (!association.hasReference())
+		return TVResult<DocumentRevisionInfosPage>(getUnknownAssociationError(name));
+
+	if (!mInternals->documentBackingGet((*association)->getFromDocumentType(), fromDocumentID).hasReference())
+		return TVResult<DocumentRevisionInfosPage>(getUnknownDocumentIDError(fromDocumentID));
+
+	TVResult<OV<SInt64> >	afterSequence = Internals::getAfterSequence(continuationToken);
+	ReturnValueIfResultError(afterSequence, TVResult<DocumentRevisionInfosPage>(afterSequence.getError()));
+
+	// Get document IDs
+	Internals::DocumentIDsPage	documentIDsPage =
+										mInternals->associationGetToDocumentIDsPage(name, fromDocumentID, *afterSequence,
+												count);
+	const	TArray<CString>&	documentIDs = documentIDsPage.getDocumentIDs();
+
+	// Retrieve Document RevisionInfos
+	TArray<CMDSDocument::RevisionInfo>	documentRevisionInfos =
+												mInternals->documentRevisionInfosGet(
+														(*association)->getToDocumentType(), documentIDs);
+
+	return TVResult<DocumentRevisionInfosPage>(
+			DocumentRevisionInfosPage(documentRevisionInfos, documentIDsPage.getContinuationToken()));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+TVResult<CMDSDocumentStorageServer::DocumentRevisionInfosPage> CMDSEphemeral::associationGetDocumentRevisionInfosPageTo(
+		const CString& name, const CString& toDocumentID, const OV<CString>& continuationToken, UInt32 count) const
+//----------------------------------------------------------------------------------------------------------------------
+{
+	// Validate
+	OR<I<CMDSAssociation> >	association = mInternals->mAssociationByName.get(name);
+	if (!association.hasReference())
+		return TVResult<DocumentRevisionInfosPage>(getUnknownAssociationError(name));
+
+	if (!mInternals->documentBackingGet((*association)->getToDocumentType(), toDocumentID).hasReference())
+		return TVResult<DocumentRevisionInfosPage>(getUnknownDocumentIDError(toDocumentID));
+
+	TVResult<OV<SInt64> >	afterSequence = Internals::getAfterSequence(continuationToken);
+	ReturnValueIfResultError(afterSequence, TVResult<DocumentRevisionInfosPage>(afterSequence.getError()));
+
+	// Get document IDs
+	Internals::DocumentIDsPage	documentIDsPage =
+										mInternals->associationGetFromDocumentIDsPage(name, toDocumentID, *afterSequence,
+												count);
+	const	TArray<CString>&	documentIDs = documentIDsPage.getDocumentIDs();
+
+	// Retrieve Document RevisionInfos
+	TArray<CMDSDocument::RevisionInfo>	documentRevisionInfos =
+												mInternals->documentRevisionInfosGet(
+														(*association)->getFromDocumentType(), documentIDs);
+
+	return TVResult<DocumentRevisionInfosPage>(
+			DocumentRevisionInfosPage(documentRevisionInfos, documentIDsPage.getContinuationToken()));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+TVResult<CMDSDocumentStorageServer::DocumentFullInfosPage> CMDSEphemeral::associationGetDocumentFullInfosPageFrom(
+		const CString& name, const CString& fromDocumentID, const OV<CString>& continuationToken, UInt32 count) const
+//----------------------------------------------------------------------------------------------------------------------
+{
+	// Validate
+	OR<I<CMDSAssociation> >	association = mInternals->mAssociationByName.get(name);
+	if (!association.hasReference())
+		return TVResult<DocumentFullInfosPage>(getUnknownAssociationError(name));
+
+	if (!mInternals->documentBackingGet((*association)->getFromDocumentType(), fromDocumentID).hasReference())
+		return TVResult<DocumentFullInfosPage>(getUnknownDocumentIDError(fromDocumentID));
+
+	TVResult<OV<SInt64> >	afterSequence = Internals::getAfterSequence(continuationToken);
+	ReturnValueIfResultError(afterSequence, TVResult<DocumentFullInfosPage>(afterSequence.getError()));
+
+	// Get document IDs
+	Internals::DocumentIDsPage	documentIDsPage =
+										mInternals->associationGetToDocumentIDsPage(name, fromDocumentID, *afterSequence,
+												count);
+	const	TArray<CString>&	documentIDs = documentIDsPage.getDocumentIDs();
+
+	// Retrieve Document FullInfos
+	TArray<CMDSDocument::FullInfo>	documentFullInfos =
+											mInternals->documentFullInfosGet((*association)->getToDocumentType(),
+													documentIDs);
+
+	return TVResult<DocumentFullInfosPage>(
+			DocumentFullInfosPage(documentFullInfos, documentIDsPage.getContinuationToken()));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+TVResult<CMDSDocumentStorageServer::DocumentFullInfosPage> CMDSEphemeral::associationGetDocumentFullInfosPageTo(
+		const CString& name, const CString& toDocumentID, const OV<CString>& continuationToken, UInt32 count) const
+//----------------------------------------------------------------------------------------------------------------------
+{
+	// Validate
+	OR<I<CMDSAssociation> >	association = mInternals->mAssociationByName.get(name);
+	if (!association.hasReference())
+		return TVResult<DocumentFullInfosPage>(getUnknownAssociationError(name));
+
+	if (!mInternals->documentBackingGet((*association)->getToDocumentType(), toDocumentID).hasReference())
+		return TVResult<DocumentFullInfosPage>(getUnknownDocumentIDError(toDocumentID));
+
+	TVResult<OV<SInt64> >	afterSequence = Internals::getAfterSequence(continuationToken);
+	ReturnValueIfResultError(afterSequence, TVResult<DocumentFullInfosPage>(afterSequence.getError()));
+
+	// Get document IDs
+	Internals::DocumentIDsPage	documentIDsPage =
+										mInternals->associationGetFromDocumentIDsPage(name, toDocumentID, *afterSequence,
+												count);
+	const	TArray<CString>&	documentIDs = documentIDsPage.getDocumentIDs();
+
+	// Retrieve Document FullInfos
+	TArray<CMDSDocument::FullInfo>	documentFullInfos =
+											mInternals->documentFullInfosGet((*association)->getFromDocumentType(),
+													documentIDs);
+
+	return TVResult<DocumentFullInfosPage>(
+			DocumentFullInfosPage(documentFullInfos, documentIDsPage.getContinuationToken()));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+TVResult<CMDSDocumentStorageServer::Status> CMDSEphemeral::cacheGetStatus(const CString& name) const
 //----------------------------------------------------------------------------------------------------------------------
 {
 	// Validate
 	OR<I<MDSCache> >	cache = mInternals->mCacheByName.get(name);
 	if (!cache.hasReference())
-		return OV<SError>(getUnknownCacheError(name));
+		return TVResult<Status>(getUnknownCacheError(name));
 
-	return OV<SError>();
+	// Caches are brought up to date when registered
+	OR<Internals::DocumentTypePartition>	documentTypePartition =
+													mInternals->documentTypePartitionGet((*cache)->getDocumentType());
+
+	return TVResult<Status>(
+			Status(true, (*cache)->getLastRevision(),
+					documentTypePartition.hasReference() ? documentTypePartition->getLastRevision() : 0));
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -2324,26 +3318,14 @@ TVResult<TArray<CMDSDocument::RevisionInfo> > CMDSEphemeral::collectionGetDocume
 //----------------------------------------------------------------------------------------------------------------------
 {
 	// Validate
-	const	OR<TNArray<CString> >	documentIDs = mInternals->mCollectionValuesByName.get(name);
-	if (!documentIDs.hasReference())
+	OV<TNArray<CString> >	documentIDs = mInternals->collectionGetDocumentIDs(name, startIndex, count);
+	if (!documentIDs.hasValue())
 		return TVResult<TArray<CMDSDocument::RevisionInfo> >(getUnknownCollectionError(name));
 
-	// Process documentIDs
-	TNArray<CMDSDocument::RevisionInfo>	documentRevisionInfos;
-	mInternals->mDocumentMapsLock.lockForReading();
-	for (TArray<CString>::Iterator iterator = documentIDs->getIterator(); iterator; iterator++) {
-		// Check index
-		if (iterator.getIndex() >= startIndex)
-			// Add Document RevisionInfo
-			documentRevisionInfos +=
-					(*mInternals->mDocumentBackingByDocumentID.get(*iterator))->getDocumentRevisionInfo();
-
-		// Check count
-		if (count.hasValue() && (iterator.getIndex() > (startIndex + *count)))
-			// Done
-			break;
-	}
-	mInternals->mDocumentMapsLock.unlockForReading();
+	// Retrieve Document RevisionInfos
+	CString								documentType = (*mInternals->mCollectionByName.get(name))->getDocumentType();
+	TArray<CMDSDocument::RevisionInfo>	documentRevisionInfos =
+												mInternals->documentRevisionInfosGet(documentType, *documentIDs);
 
 	return TVResult<TArray<CMDSDocument::RevisionInfo> >(documentRevisionInfos);
 }
@@ -2354,29 +3336,68 @@ TVResult<TArray<CMDSDocument::FullInfo> > CMDSEphemeral::collectionGetDocumentFu
 //----------------------------------------------------------------------------------------------------------------------
 {
 	// Validate
-	const	OR<TNArray<CString> >	documentIDs = mInternals->mCollectionValuesByName.get(name);
-	if (!documentIDs.hasReference())
+	OV<TNArray<CString> >	documentIDs = mInternals->collectionGetDocumentIDs(name, startIndex, count);
+	if (!documentIDs.hasValue())
 		return TVResult<TArray<CMDSDocument::FullInfo> >(getUnknownCollectionError(name));
 
-	// Process documentIDs
-	TNArray<CMDSDocument::FullInfo>	documentFullInfos;
-	mInternals->mDocumentMapsLock.lockForReading();
-	for (TArray<CString>::Iterator iterator = documentIDs->getIterator(); iterator; iterator++) {
-		// Check index
-		if (iterator.getIndex() >= startIndex)
-			// Add Document FullInfo
-			documentFullInfos += (*mInternals->mDocumentBackingByDocumentID.get(*iterator))->getDocumentFullInfo();
-
-		// Check count
-		if (count.hasValue() && (iterator.getIndex() > (startIndex + *count)))
-			// Done
-			break;
-	}
-	mInternals->mDocumentMapsLock.unlockForReading();
+	// Retrieve Document FullInfos
+	CString							documentType = (*mInternals->mCollectionByName.get(name))->getDocumentType();
+	TArray<CMDSDocument::FullInfo>	documentFullInfos = mInternals->documentFullInfosGet(documentType, *documentIDs);
 
 	return TVResult<TArray<CMDSDocument::FullInfo> >(documentFullInfos);
 }
 
+//----------------------------------------------------------------------------------------------------------------------
+TVResult<CMDSDocumentStorageServer::DocumentRevisionInfosPage> CMDSEphemeral::collectionGetDocumentRevisionInfosPage(
+		const CString& name, const OV<CString>& continuationToken, UInt32 count) const
+//----------------------------------------------------------------------------------------------------------------------
+{
+	// Validate
+	TVResult<OV<SInt64> >	afterSequence = Internals::getAfterSequence(continuationToken);
+	ReturnValueIfResultError(afterSequence, TVResult<DocumentRevisionInfosPage>(afterSequence.getError()));
+
+	OV<Internals::DocumentIDsPage>	documentIDsPage =
+											mInternals->collectionGetDocumentIDsPage(name, *afterSequence, count);
+	if (!documentIDsPage.hasValue())
+		return TVResult<DocumentRevisionInfosPage>(getUnknownCollectionError(name));
+
+	// Get document IDs
+	const	TArray<CString>&	documentIDs = documentIDsPage->getDocumentIDs();
+
+	// Retrieve Document RevisionInfos
+	CString								documentType = (*mInternals->mCollectionByName.get(name))->getDocumentType();
+	TArray<CMDSDocument::RevisionInfo>	documentRevisionInfos =
+												mInternals->documentRevisionInfosGet(documentType, documentIDs);
+
+	return TVResult<DocumentRevisionInfosPage>(
+			DocumentRevisionInfosPage(documentRevisionInfos, documentIDsPage->getContinuationToken()));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+TVResult<CMDSDocumentStorageServer::DocumentFullInfosPage> CMDSEphemeral::collectionGetDocumentFullInfosPage(
+		const CString& name, const OV<CString>& continuationToken, UInt32 count) const
+//----------------------------------------------------------------------------------------------------------------------
+{
+	// Validate
+	TVResult<OV<SInt64> >	afterSequence = Internals::getAfterSequence(continuationToken);
+	ReturnValueIfResultError(afterSequence, TVResult<DocumentFullInfosPage>(afterSequence.getError()));
+
+	OV<Internals::DocumentIDsPage>	documentIDsPage =
+											mInternals->collectionGetDocumentIDsPage(name, *afterSequence, count);
+	if (!documentIDsPage.hasValue())
+		return TVResult<DocumentFullInfosPage>(getUnknownCollectionError(name));
+
+	// Get document IDs
+	const	TArray<CString>&	documentIDs = documentIDsPage->getDocumentIDs();
+
+	// Retrieve Document FullInfos
+	CString							documentType = (*mInternals->mCollectionByName.get(name))->getDocumentType();
+	TArray<CMDSDocument::FullInfo>	documentFullInfos = mInternals->documentFullInfosGet(documentType, documentIDs);
+
+	return TVResult<DocumentFullInfosPage>(
+			DocumentFullInfosPage(documentFullInfos, documentIDsPage->getContinuationToken()));
+}
+
 //----------------------------------------------------------------------------------------------------------------------
 TVResult<TArray<CMDSDocument::RevisionInfo> > CMDSEphemeral::documentRevisionInfos(const CString& documentType,
 		const TArray<CString>& documentIDs) const
@@ -2467,7 +3488,7 @@ OV<SInt64> CMDSEphemeral::documentIntegerValue(const CString& documentType, cons
 //----------------------------------------------------------------------------------------------------------------------
 {
 	// Check for batch
-	const	OR<I<Internals::Batch> >	batch = mInternals->mBatchByThreadRef[CThread::getCurrentRefAsString()];
+	const	OR<I<Internals::Batch> >	batch = mInternals->mBatchByThread.get();
 	if (batch.hasReference()) {
 		// In batch
 		const	OR<Internals::BatchDocumentInfo>	batchDocumentInfo = (*batch)->documentInfoGet(document->getID());
@@ -2493,9 +3514,10 @@ OV<SInt64> CMDSEphemeral::documentIntegerValue(const CString& documentType, cons
 	}
 
 	// "Idle"
-	mInternals->mDocumentMapsLock.lockForReading();
+	Internals::DocumentTypePartition&	documentTypePartition = *mInternals->documentTypePartitionGet(documentType);
+	documentTypePartition.mLock.lockForReading();
 	const	OR<I<Internals::DocumentBacking> >	documentBacking =
-														mInternals->mDocumentBackingByDocumentID[document->getID()];
+														documentTypePartition.getDocumentBacking(document->getID());
 			OV<SValue>							value =
 														(documentBacking.hasReference() &&
 																		(*documentBacking)->getPropertyMap().contains(
@@ -2504,7 +3526,7 @@ OV<SInt64> CMDSEphemeral::documentIntegerValue(const CString& documentType, cons
 																		(*documentBacking)->getPropertyMap().getValue(
 																				property)) :
 																OV<SValue>();
-	mInternals->mDocumentMapsLock.unlockForReading();
+	documentTypePartition.mLock.unlockForReading();
 
 	return (value.hasValue() && value->canCoerceToType(SValue::kTypeSInt64)) ?
 			OV<SInt64>(value->getSInt64()) : OV<SInt64>();
@@ -2516,7 +3538,7 @@ OV<CString> CMDSEphemeral::documentStringValue(const CString& documentType, cons
 //----------------------------------------------------------------------------------------------------------------------
 {
 	// Get value
-	OV<SValue>	value = documentValue(property, document);
+	OV<SValue>	value = documentValue(property, *document);
 
 	return (value.hasValue() && (value->getType() == SValue::kTypeString)) ?
 			OV<CString>(value->getString()) : OV<CString>();
@@ -2528,10 +3550,8 @@ TVResult<TArray<CMDSDocument::FullInfo> > CMDSEphemeral::documentUpdate(const CS
 //----------------------------------------------------------------------------------------------------------------------
 {
 	// Validate
-	mInternals->mDocumentMapsLock.lockForReading();
-	bool	isKnownDocumentType = mInternals->mDocumentIDsByDocumentType.contains(documentType);
-	mInternals->mDocumentMapsLock.unlockForReading();
-	if (!isKnownDocumentType)
+	OR<Internals::DocumentTypePartition>	documentTypePartition = mInternals->documentTypePartitionGet(documentType);
+	if (!documentTypePartition.hasReference())
 		return TVResult<TArray<CMDSDocument::FullInfo> >(getUnknownDocumentTypeError(documentType));
 
 	// Setup
@@ -2546,16 +3566,17 @@ TVResult<TArray<CMDSDocument::FullInfo> > CMDSEphemeral::documentUpdate(const CS
 		// Check active
 		if (iterator->getActive()) {
 			// Update document
-			mInternals->mDocumentMapsLock.lockForWriting();
+			documentTypePartition->mLock.lockForWriting();
 
 			// Retrieve existing document backing
 			OR<I<Internals::DocumentBacking> >	documentBacking =
-														mInternals->mDocumentBackingByDocumentID.get(
+														documentTypePartition->getDocumentBacking(
 																iterator->getDocumentID());
 			if (documentBacking.hasReference()) {
 				// Update document backing
-				(*documentBacking)->update(mInternals->nextRevision(documentType), iterator->getUpdated(),
+				(*documentBacking)->update(documentTypePartition->nextRevision(), iterator->getUpdated(),
 						iterator->getRemoved());
+				documentTypePartition->noteRevision(**documentBacking);
 
 				// Create document
 				I<CMDSDocument>	document = documentInfo.create(iterator->getDocumentID(), *this);
@@ -2573,17 +3594,17 @@ TVResult<TArray<CMDSDocument::FullInfo> > CMDSEphemeral::documentUpdate(const CS
 			}
 
 			// Done
-			mInternals->mDocumentMapsLock.unlockForWriting();
+			documentTypePartition->mLock.unlockForWriting();
 		} else {
 			// Remove document
 			removedDocumentIDs += iterator->getDocumentID();
 
 			// Update document backing
-			mInternals->mDocumentMapsLock.lockForWriting();
+			documentTypePartition->mLock.lockForWriting();
 
 			// Retrieve existing document backing
 			OR<I<Internals::DocumentBacking> >	documentBacking =
-														mInternals->mDocumentBackingByDocumentID.get(
+														documentTypePartition->getDocumentBacking(
 																iterator->getDocumentID());
 			if (documentBacking.hasReference()) {
 				// Update active
@@ -2603,27 +3624,33 @@ TVResult<TArray<CMDSDocument::FullInfo> > CMDSEphemeral::documentUpdate(const CS
 			}
 
 			// Done
-			mInternals->mDocumentMapsLock.unlockForWriting();
+			documentTypePartition->mLock.unlockForWriting();
 		}
 	}
 
 	// Update stuffs
-	mInternals->noteRemoved(removedDocumentIDs);
+	mInternals->noteRemoved(documentType, removedDocumentIDs);
 	mInternals->update(documentType, updateInfos);
 
 	return TVResult<TArray<CMDSDocument::FullInfo> >(documentFullInfos);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
-OV<SError> CMDSEphemeral::indexGetStatus(const CString& name) const
+TVResult<CMDSDocumentStorageServer::Status> CMDSEphemeral::indexGetStatus(const CString& name) const
 //----------------------------------------------------------------------------------------------------------------------
 {
 	// Validate
 	OR<I<MDSIndex> >	index = mInternals->mIndexByName.get(name);
 	if (!index.hasReference())
-		return OV<SError>(getUnknownIndexError(name));
+		return TVResult<Status>(getUnknownIndexError(name));
 
-	return OV<SError>();
+	// Indexes are brought up to date when registered
+	OR<Internals::DocumentTypePartition>	documentTypePartition =
+													mInternals->documentTypePartitionGet((*index)->getDocumentType());
+
+	return TVResult<Status>(
+			Status(true, (*index)->getLastRevision(),
+					documentTypePartition.hasReference() ? documentTypePartition->getLastRevision() : 0));
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -2632,26 +3659,25 @@ TVResult<TDictionary<CMDSDocument::RevisionInfo> > CMDSEphemeral::indexGetDocume
 //----------------------------------------------------------------------------------------------------------------------
 {
 	// Validate
-	const	OR<TDictionary<CString> >	items = mInternals->mIndexValuesByName[name];
-	if (!items.hasReference())
+	OV<TNDictionary<CString> >	items = mInternals->indexGetDocumentIDByKey(name);
+	if (!items.hasValue())
 		return TVResult<TDictionary<CMDSDocument::RevisionInfo> >(getUnknownIndexError(name));
 
 	// Iterate keys
 	OV<SError>	error;
 	TNDictionary<CMDSDocument::RevisionInfo>	documentRevisionInfos;
-	mInternals->mDocumentMapsLock.lockForReading();
+	CString	documentType = (*mInternals->mIndexByName.get(name))->getDocumentType();
 	for (TArray<CString>::Iterator iterator = keys.getIterator(); iterator && !error.hasValue(); iterator++) {
 		// Get documentID
 		const	OR<CString>	documentID = (*items)[*iterator];
 		if (documentID.hasReference())
 			// Success
 			documentRevisionInfos.set(*iterator,
-					(*mInternals->mDocumentBackingByDocumentID[*documentID])->getDocumentRevisionInfo());
+					(*mInternals->documentBackingGet(documentType, *documentID))->getDocumentRevisionInfo());
 		else
 			// documentID not found
 			error.setValue(getMissingFromIndexError(*iterator));
 	}
-	mInternals->mDocumentMapsLock.unlockForReading();
 
 	return !error.hasValue() ?
 			TVResult<TDictionary<CMDSDocument::RevisionInfo> >(documentRevisionInfos) :
@@ -2664,26 +3690,25 @@ TVResult<TDictionary<CMDSDocument::FullInfo> > CMDSEphemeral::indexGetDocumentFu
 //----------------------------------------------------------------------------------------------------------------------
 {
 	// Validate
-	const	OR<TDictionary<CString> >	items = mInternals->mIndexValuesByName[name];
-	if (!items.hasReference())
+	OV<TNDictionary<CString> >	items = mInternals->indexGetDocumentIDByKey(name);
+	if (!items.hasValue())
 		return TVResult<TDictionary<CMDSDocument::FullInfo> >(getUnknownIndexError(name));
 
 	// Iterate keys
 	OV<SError>	error;
 	TNDictionary<CMDSDocument::FullInfo>	documentFullInfos;
-	mInternals->mDocumentMapsLock.lockForReading();
+	CString	documentType = (*mInternals->mIndexByName.get(name))->getDocumentType();
 	for (TArray<CString>::Iterator iterator = keys.getIterator(); iterator && !error.hasValue(); iterator++) {
 		// Get documentID
 		const	OR<CString>	documentID = (*items)[*iterator];
 		if (documentID.hasReference())
 			// Success
 			documentFullInfos.set(*iterator,
-					(*mInternals->mDocumentBackingByDocumentID[*documentID])->getDocumentFullInfo());
+					(*mInternals->documentBackingGet(documentType, *documentID))->getDocumentFullInfo());
 		else
 			// documentID not found
 			error.setValue(getMissingFromIndexError(*iterator));
 	}
-	mInternals->mDocumentMapsLock.unlockForReading();
 
 	return !error.hasValue() ?
 			TVResult<TDictionary<CMDSDocument::FullInfo> >(documentFullInfos) :
@@ -71,19 +71,19 @@ class CMDSEphemeral : public CMDSDocumentStorageServer {
 															bool activeOnly, CMDSDocument::Proc proc,
 															void* procUserData) const;
 
-		UniversalTime								documentCreationUniversalTime(const I<CMDSDocument>& document)
+		UniversalTime								documentCreationUniversalTime(const CMDSDocument& document)
 															const;
-		UniversalTime								documentModificationUniversalTime(const I<CMDSDocument>& document)
+		UniversalTime								documentModificationUniversalTime(const CMDSDocument& document)
 															const;
 
 		OV<SValue>									documentValue(const CString& property,
-															const I<CMDSDocument>& document) const;
+															const CMDSDocument& document) const;
 		OV<CData>									documentData(const CString& property,
-															const I<CMDSDocument>& document) const;
+															const CMDSDocument& document) const;
 		OV<UniversalTime>							documentUniversalTime(const CString& property,
-															const I<CMDSDocument>& document) const;
+															const CMDSDocument& document) const;
 		void										documentSet(const CString& property, const OV<SValue>& value,
-															const I<CMDSDocument>& document,
+															const CMDSDocument& document,
 															SetValueKind setValueKind = kSetValueKindNothingSpecial);
 
 		DocumentAttachmentInfoResult				documentAttachmentAdd(const CString& documentType,
@@ -100,7 +100,7 @@ class CMDSEphemeral : public CMDSDocumentStorageServer {
 		OV<SError>									documentAttachmentRemove(const CString& documentType,
 															const CString& documentID, const CString& attachmentID);
 
-		OV<SError>									documentRemove(const I<CMDSDocument>& document);
+		OV<SError>									documentRemove(const CMDSDocument& document);
 
 		OV<SError>									indexRegister(const CString& name, const CString& documentType,
 															const TArray<CString>& relevantProperties,
@@ -133,13 +133,29 @@ class CMDSEphemeral : public CMDSDocumentStorageServer {
 		DocumentFullInfosWithTotalCountResult		associationGetDocumentFullInfosTo(const CString& name,
 															const CString& toDocumentID, UInt32 startIndex,
 															const OV<UInt32>& count) const;
+		DocumentRevisionInfosPageResult				associationGetDocumentRevisionInfosPageFrom(const CString& name,
+															const CString& fromDocumentID,
+															const OV<CString>& continuationToken, UInt32 count) const;
+		DocumentRevisionInfosPageResult				associationGetDocumentRevisionInfosPageTo(const CString& name,
+															const CString& toDocumentID,
+															const OV<CString>& continuationToken, UInt32 count) const;
+		DocumentFullInfosPageResult					associationGetDocumentFullInfosPageFrom(const CString& name,
+															const CString& fromDocumentID,
+															const OV<CString>& continuationToken, UInt32 count) const;
+		DocumentFullInfosPageResult					associationGetDocumentFullInfosPageTo(const CString& name,
+															const CString& toDocumentID,
+															const OV<CString>& continuationToken, UInt32 count) const;
 
-		OV<SError>									cacheGetStatus(const CString& name) const;
+		StatusResult								cacheGetStatus(const CString& name) const;
 
 		DocumentRevisionInfosResult					collectionGetDocumentRevisionInfos(const CString& name,
 															UInt32 startIndex, const OV<UInt32>& count) const;
 		DocumentFullInfosResult						collectionGetDocumentFullInfos(const CString& name,
 															UInt32 startIndex, const OV<UInt32>& count) const;
+		DocumentRevisionInfosPageResult				collectionGetDocumentRevisionInfosPage(const CString& name,
+															const OV<CString>& continuationToken, UInt32 count) const;
+		DocumentFullInfosPageResult					collectionGetDocumentFullInfosPage(const CString& name,
+															const OV<CString>& continuationToken, UInt32 count) const;
 
 		DocumentRevisionInfosResult					documentRevisionInfos(const CString& documentType,
 															const TArray<CString>& documentIDs) const;
@@ -160,7 +176,7 @@ class CMDSEphemeral : public CMDSDocumentStorageServer {
 															const TArray<CMDSDocument::UpdateInfo>&
 																	documentUpdateInfos);
 
-		OV<SError>									indexGetStatus(const CString& name) const;
+		StatusResult								indexGetStatus(const CString& name) const;
 		DocumentRevisionInfoDictionaryResult		indexGetDocumentRevisionInfos(const CString& name,
 															const TArray<CString>& keys) const;
 		DocumentFullInfoDictionaryResult			indexGetDocumentFullInfos(const CString& name,
@@ -6,6 +6,8 @@
 
 #include "CMDSSQLiteDatabaseManager.h"
 #include "CMDSSQLiteDocumentBacking.h"
+#include "CMDSWorkerPool.h"
+#include "ConcurrencyPrimitives.h"
 #include "CThread.h"
 #include "TBatchQueue.h"
 #include "TLockingDictionary.h"
@@ -20,6 +22,8 @@ typedef	CMDSSQLiteDatabaseManager::AssociationInfo			DMAssociationInfo;
 typedef	CMDSSQLiteDatabaseManager::CacheInfo				DMCacheInfo;
 typedef	CMDSSQLiteDatabaseManager::CacheValueInfo			DMCacheValueInfo;
 typedef	CMDSSQLiteDatabaseManager::CollectionInfo			DMCollectionInfo;
+typedef	CMDSSQLiteDatabaseManager::DocumentAttachmentInfoByIDByID
+															DMDocumentAttachmentInfoByIDByID;
 typedef	CMDSSQLiteDatabaseManager::DocumentContentInfo		DMDocumentContentInfo;
 typedef	CMDSSQLiteDatabaseManager::DocumentInfo				DMDocumentInfo;
 typedef	CMDSSQLiteDatabaseManager::IDArray					DMIDArray;
@@ -312,17 +316,28 @@ class CMDSSQLite::Internals {
 												{ return mBatch; }
 
 						void				addUpdateInfo(const I<CMDSSQLiteDocumentBacking>& documentBacking)
-												{ mUpdateInfos +=
-														MDSUpdateInfo(
-																mDocumentInfo.create(documentBacking->getDocumentID(),
-																		mDocumentStorage),
-																documentBacking->getRevision(),
-																documentBacking->getID()); }
+												{
+													// Add
+													mUpdateInfos +=
+															MDSUpdateInfo(
+																	mDocumentInfo.create(
+																			documentBacking->getDocumentID(),
+																			mDocumentStorage),
+																	documentBacking->getRevision(),
+																	documentBacking->getID());
+													mLastRevision.setValue(documentBacking->getRevision());
+												}
 						void				noteRemoved(const I<CMDSSQLiteDocumentBacking>& documentBacking)
-												{ mRemovedIDs += documentBacking->getID(); }
+												{
+													// Add
+													mRemovedIDs += documentBacking->getID();
+													mLastRevision.setValue(documentBacking->getRevision());
+												}
 
 						UpdatesInfo			getUpdatesInfo() const
 												{ return UpdatesInfo(mUpdateInfos, mRemovedIDs); }
+				const	OV<UInt32>&			getLastRevision() const
+												{ return mLastRevision; }
 
 			private:
 						CMDSDocumentStorage&	mDocumentStorage;
@@ -331,13 +346,353 @@ class CMDSSQLite::Internals {
 
 						TNArray<MDSUpdateInfo>	mUpdateInfos;
 						DMIDArray				mRemovedIDs;
+						OV<UInt32>				mLastRevision;
+		};
+
+	public:
+		class ViewBuilder : public CThread {
+			public:
+				enum Kind {
+					kKindCache,
+					kKindCollection,
+					kKindIndex,
+				};
+
+				struct Item {
+					public:
+										Item(const I<MDSCache>& cache, UInt32 sinceRevision) :
+											mKind(kKindCache), mName(cache->getName()),
+													mDocumentType(cache->getDocumentType()), mCache(cache),
+													mSinceRevision(sinceRevision), mIsRestarted(false)
+											{}
+										Item(const I<MDSCollection>& collection, UInt32 sinceRevision) :
+											mKind(kKindCollection), mName(collection->getName()),
+													mDocumentType(collection->getDocumentType()),
+													mCollection(collection), mSinceRevision(sinceRevision),
+													mIsRestarted(false)
+											{}
+										Item(const I<MDSIndex>& index, UInt32 sinceRevision) :
+											mKind(kKindIndex), mName(index->getName()),
+													mDocumentType(index->getDocumentType()), mIndex(index),
+													mSinceRevision(sinceRevision), mIsRestarted(false)
+											{}
+										Item(const Item& other) :
+											mKind(other.mKind), mName(other.mName),
+													mDocumentType(other.mDocumentType), mCache(other.mCache),
+													mCollection(other.mCollection), mIndex(other.mIndex),
+													mSinceRevision(other.mSinceRevision),
+													mIsRestarted(other.mIsRestarted)
+											{}
+
+						CString			getKey() const
+											{ return ViewBuilder::getKey(mKind, mName); }
+
+						Kind					mKind;
+						CString					mName;
+						CString					mDocumentType;
+						OV<I<MDSCache> >		mCache;
+						OV<I<MDSCollection> >	mCollection;
+						OV<I<MDSIndex> >		mIndex;
+						UInt32					mSinceRevision;
+						bool					mIsRestarted;
+				};
+
+			public:
+								ViewBuilder(Internals& internals) :
+									CThread(CString(OSSTR("MDS SQLite View Builder"))), mInternals(internals),
+											mShouldStop(false)
+									{ start(); }
+
+						void	add(const Item& item)
+									{
+										// Add, or restart if already building this view
+										mLock.lock();
+										bool	isRestart = mItemByKey.contains(item.getKey());
+										mItemByKey.set(item.getKey(), item);
+										if (isRestart)
+											// Restart with this view
+											mItemByKey.get(item.getKey())->mIsRestarted = true;
+										else
+											// Queue
+											mQueuedKeys += item.getKey();
+										mLock.unlock();
+
+										// Wake up
+										mSemaphore.signal();
+									}
+						bool	isBuilding(Kind kind, const CString& name)
+									{
+										// Check
+										mLock.lock();
+										bool	isBuilding = mItemByKey.contains(getKey(kind, name));
+										mLock.unlock();
+
+										return isBuilding;
+									}
+						void	noteComplete(const Item& item)
+									{
+										// Check if restarted while this step was in progress
+										mLock.lock();
+										if (mItemByKey.get(item.getKey())->mIsRestarted)
+											// Go again
+											mQueuedKeys += item.getKey();
+										else
+											// Done
+											mItemByKey.remove(item.getKey());
+										mLock.unlock();
+									}
+						void	stop()
+									{
+										// Signal and wait until done
+										mLock.lock();
+										mShouldStop = true;
+										mLock.unlock();
+
+										mSemaphore.signal();
+										mStoppedSemaphore.waitFor();
+									}
+
+				static	CString	getKey(Kind kind, const CString& name)
+									{
+										// Check kind
+										switch (kind) {
+											case kKindCache:		return CString(OSSTR("cache/")) + name;
+											case kKindCollection:	return CString(OSSTR("collection/")) + name;
+											case kKindIndex:		return CString(OSSTR("index/")) + name;
+#if defined(TARGET_OS_WINDOWS)
+											default:				return CString::mEmpty;
+#endif
+										}
+									}
+
+			protected:
+						void	run()
+									{
+										// Loop until stopped
+										while (true) {
+											// Take the next view.  Views take turns a step at a time.
+											mLock.lock();
+											bool		shouldStop = mShouldStop;
+											OV<Item>	item;
+											if (!shouldStop && !mQueuedKeys.isEmpty()) {
+												// Dequeue
+												CString		key = mQueuedKeys[0];
+												OR<Item>	queuedItem = mItemByKey.get(key);
+												queuedItem->mIsRestarted = false;
+												item.setValue(*queuedItem);
+												mQueuedKeys -= key;
+											}
+											mLock.unlock();
+											if (shouldStop)
+												break;
+											if (!item.hasValue()) {
+												// Wait for a view to be added
+												mSemaphore.waitFor();
+												continue;
+											}
+
+											// Build a step
+											OV<UInt32>	nextRevision = mInternals.viewBuild(*this, *item);
+											if (nextRevision.hasValue()) {
+												// More to do
+												mLock.lock();
+												OR<Item>	queuedItem = mItemByKey.get(item->getKey());
+												if (!queuedItem->mIsRestarted)
+													// Continue from here
+													queuedItem->mSinceRevision = *nextRevision;
+												mQueuedKeys += item->getKey();
+												mLock.unlock();
+											}
+										}
+
+										// Done
+										mStoppedSemaphore.signal();
+									}
+
+			private:
+				Internals&			mInternals;
+
+				CLock				mLock;
+				TNDictionary<Item>	mItemByKey;
+				TNArray<CString>	mQueuedKeys;
+				bool				mShouldStop;
+				CSemaphore			mSemaphore;
+				CSemaphore			mStoppedSemaphore;
+		};
+
+	private:
+		struct ViewBuildInfo {
+			public:
+												ViewBuildInfo(Internals& internals, ViewBuilder& viewBuilder,
+														const ViewBuilder::Item& item) :
+													mInternals(internals), mViewBuilder(viewBuilder), mItem(item)
+													{}
+
+						Internals&				mInternals;
+						ViewBuilder&			mViewBuilder;
+				const	ViewBuilder::Item&		mItem;
+						OV<UInt32>				mNextRevision;
+		};
+
+	private:
+		template <typename T> struct ViewUpdate {
+			public:
+												ViewUpdate(const I<T>& view) : mView(view) {}
+
+				I<T>							mView;
+				OV<typename T::UpdateResults>	mUpdateResults;
+		};
+
+	private:
+		struct ViewsUpdate {
+			public:
+											ViewsUpdate(const OR<TNArray<I<MDSCache> > >& caches,
+													const OR<TNArray<I<MDSCollection> > >& collections,
+													const OR<TNArray<I<MDSIndex> > >& indexes,
+													ViewBuilder& viewBuilder,
+													TMDSBatchByThread<I<MDSBatch> >& batchByThread,
+													const UpdatesInfo& updatesInfo) :
+												mUpdatesInfo(updatesInfo), mBatchByThread(batchByThread),
+														mBatch(batchByThread.get())
+												{
+													// Setup.  Views being built are skipped as the ViewBuilder will
+													//	reach these documents itself.
+													if (caches.hasReference())
+														// Iterate caches
+														for (TArray<I<MDSCache> >::Iterator iterator =
+																		caches->getIterator();
+																iterator; iterator++) {
+															// Check if building
+															if (!viewBuilder.isBuilding(ViewBuilder::kKindCache,
+																	(*iterator)->getName()))
+																// Add
+																mCacheUpdates +=
+																		I<ViewUpdate<MDSCache> >(
+																				new ViewUpdate<MDSCache>(*iterator));
+														}
+													if (collections.hasReference())
+														// Iterate collections
+														for (TArray<I<MDSCollection> >::Iterator iterator =
+																		collections->getIterator();
+																iterator; iterator++) {
+															// Check if building
+															if (!viewBuilder.isBuilding(ViewBuilder::kKindCollection,
+																	(*iterator)->getName()))
+																// Add
+																mCollectionUpdates +=
+																		I<ViewUpdate<MDSCollection> >(
+																				new ViewUpdate<MDSCollection>(
+																						*iterator));
+														}
+													if (indexes.hasReference())
+														// Iterate indexes
+														for (TArray<I<MDSIndex> >::Iterator iterator =
+																		indexes->getIterator();
+																iterator; iterator++) {
+															// Check if building
+															if (!viewBuilder.isBuilding(ViewBuilder::kKindIndex,
+																	(*iterator)->getName()))
+																// Add
+																mIndexUpdates +=
+																		I<ViewUpdate<MDSIndex> >(
+																				new ViewUpdate<MDSIndex>(*iterator));
+														}
+												}
+
+				UInt32						getCount() const
+												{ return mCacheUpdates.getCount() + mCollectionUpdates.getCount() +
+														mIndexUpdates.getCount(); }
+
+		static	void						perform(UInt32 index, ViewsUpdate* viewsUpdate)
+												{
+													// Performers may read document properties, so a batch being
+													//	committed must be visible on this thread as it is on the
+													//	committing thread
+													bool	setBatch =
+																	viewsUpdate->mBatch.hasReference() &&
+																			!viewsUpdate->mBatchByThread.get()
+																					.hasReference();
+													if (setBatch)
+														// Set batch
+														viewsUpdate->mBatchByThread.set(*viewsUpdate->mBatch);
+
+													// Perform
+													performUpdate(index, viewsUpdate);
+
+													// Check if set batch
+													if (setBatch)
+														// Remove batch
+														viewsUpdate->mBatchByThread.remove();
+												}
+
+		static	void						performUpdate(UInt32 index, ViewsUpdate* viewsUpdate)
+												{
+													// Compute the results for the cache, collection or index at this
+													//	index
+													const	TArray<MDSUpdateInfo>&	updateInfos =
+																							viewsUpdate->mUpdatesInfo
+																									.getUpdateInfos();
+													if (index < viewsUpdate->mCacheUpdates.getCount()) {
+														// Update cache
+														ViewUpdate<MDSCache>&	cacheUpdate =
+																						*viewsUpdate->mCacheUpdates[
+																								index];
+														cacheUpdate.mUpdateResults.setValue(
+																cacheUpdate.mView->update(updateInfos));
+
+														return;
+													}
+													index -= viewsUpdate->mCacheUpdates.getCount();
+
+													if (index < viewsUpdate->mCollectionUpdates.getCount()) {
+														// Update collection
+														ViewUpdate<MDSCollection>&	collectionUpdate =
+																							*viewsUpdate->
+																									mCollectionUpdates[
+																											index];
+														collectionUpdate.mUpdateResults.setValue(
+																collectionUpdate.mView->update(updateInfos));
+
+														return;
+													}
+													index -= viewsUpdate->mCollectionUpdates.getCount();
+
+													// Update index
+													ViewUpdate<MDSIndex>&	indexUpdate =
+																					*viewsUpdate->mIndexUpdates[index];
+													indexUpdate.mUpdateResults.setValue(
+															indexUpdate.mView->update(updateInfos));
+												}
+
+			public:
+				const	UpdatesInfo&						mUpdatesInfo;
+						TMDSBatchByThread<I<MDSBatch> >&		mBatchByThread;
+				const	OR<I<MDSBatch> >						mBatch;
+						TNArray<I<ViewUpdate<MDSCache> > >		mCacheUpdates;
+						TNArray<I<ViewUpdate<MDSCollection> > >	mCollectionUpdates;
+						TNArray<I<ViewUpdate<MDSIndex> > >		mIndexUpdates;
 		};
 
 	public:
 											Internals(CMDSDocumentStorage& documentStorage, const CFolder& folder,
-													const CString& name) :
-												mDocumentStorage(documentStorage), mDatabaseManager(folder, name)
+													const CString& name, CMDSSQLite::DurabilityMode durabilityMode,
+													const OV<CMDSSQLite::WALCheckpointInfo>& walCheckpointInfo,
+													CMDSSQLite::PropertyMapEncoding propertyMapEncoding,
+													CMDSSQLite::DateEncoding dateEncoding,
+													UInt32 documentBackingCacheLimit,
+													const OV<UInt64>& documentBackingCacheByteLimit) :
+												mDocumentStorage(documentStorage),
+														mPropertyMapEncoding(propertyMapEncoding),
+														mDatabaseManager(folder, name, durabilityMode,
+																walCheckpointInfo, propertyMapEncoding,
+																dateEncoding),
+														mDocumentBackingByDocumentID(documentBackingCacheLimit,
+																documentBackingCacheByteLimit,
+																getDocumentBackingByteCount),
+														mViewBuilder(*this)
 												{}
+											~Internals()
+												{ mViewBuilder.stop(); }
 
 				OV<I<CMDSAssociation> >		associationGet(const CString& name)
 												{
@@ -465,22 +820,38 @@ class CMDSSQLite::Internals {
 
 													return OV<I<MDSCache> >();
 												}
-				void						cacheUpdate(const I<MDSCache>& cache, const UpdatesInfo& updatesInfo)
+				OV<SError>					cacheUpdate(const I<MDSCache>& cache, const UpdatesInfo& updatesInfo)
+												{ return cacheStore(cache, cache->update(updatesInfo.getUpdateInfos()),
+														updatesInfo); }
+				OV<SError>					cacheStore(const I<MDSCache>& cache,
+													const MDSCache::UpdateResults& cacheUpdateResults,
+													const UpdatesInfo& updatesInfo)
 												{
-													// Update Cache
-													MDSCache::UpdateResults	cacheUpdateResults =
-																					cache->update(
-																							updatesInfo
-																									.getUpdateInfos());
-
 													// Check if have updates
 													if (cacheUpdateResults.getValueInfoByID().hasValue() ||
 															!updatesInfo.getRemovedIDs().isEmpty())
 														// Update database
-														mDatabaseManager.cacheUpdate(cache->getName(),
+														return mDatabaseManager.cacheUpdate(cache->getName(),
 																cacheUpdateResults.getValueInfoByID(),
 																updatesInfo.getRemovedIDs(),
 																cacheUpdateResults.getLastRevision());
+													else
+														// No updates
+														return OV<SError>();
+												}
+				OV<SError>					cacheBringUpToDate(const I<MDSCache>& cache)
+												{
+													// Check if building.  A view being built only has partial
+													//	contents, so report that instead.
+													OV<SError>	error =
+																		checkIsBuilt(ViewBuilder::kKindCache,
+																				cache->getName());
+													ReturnErrorIfError(error);
+
+													// Update
+													return cacheUpdate(cache,
+															getUpdatesInfo(cache->getDocumentType(),
+																	cache->getLastRevision()));
 												}
 
 				OV<I<MDSCollection> >		collectionGet(const CString& name)
@@ -545,13 +916,13 @@ class CMDSSQLite::Internals {
 												}
 				void						collectionUpdate(const I<MDSCollection>& collection,
 													const UpdatesInfo& updatesInfo)
+												{ collectionStore(collection,
+														collection->update(updatesInfo.getUpdateInfos()),
+														updatesInfo); }
+				void						collectionStore(const I<MDSCollection>& collection,
+													const MDSCollection::UpdateResults& collectionUpdateResults,
+													const UpdatesInfo& updatesInfo)
 												{
-													// Update Collection
-													MDSCollection::UpdateResults	collectionUpdateResults =
-																							collection->update(
-																									updatesInfo
-																											.getUpdateInfos());
-
 													// Check if have updates
 													if (collectionUpdateResults.getIncludedIDs().hasValue() ||
 															collectionUpdateResults.getNotIncludedIDs().hasValue() ||
@@ -567,14 +938,30 @@ class CMDSSQLite::Internals {
 																						updatesInfo.getRemovedIDs())),
 																collectionUpdateResults.getLastRevision());
 												}
+				OV<SError>					collectionBringUpToDate(const I<MDSCollection>& collection)
+												{
+													// Check if building.  A view being built only has partial
+													//	contents, so report that instead.
+													OV<SError>	error =
+																		checkIsBuilt(ViewBuilder::kKindCollection,
+																				collection->getName());
+													ReturnErrorIfError(error);
+
+													// Update
+													collectionUpdate(collection,
+															getUpdatesInfo(collection->getDocumentType(),
+																	collection->getLastRevision()));
+
+													return OV<SError>();
+												}
 
 				MDSDocumentBackingResult	documentBackingGet(const CString& documentType, const CString& documentID)
 												{
 													// Try to retrieve from cache
-													OR<I<CMDSSQLiteDocumentBacking> >	documentBacking =
+													OV<I<CMDSSQLiteDocumentBacking> >	documentBacking =
 																								mDocumentBackingByDocumentID[
 																										documentID];
-													if (documentBacking.hasReference())
+													if (documentBacking.hasValue())
 														return MDSDocumentBackingResult(*documentBacking);
 
 													// Try to retrieve from database
@@ -626,6 +1013,24 @@ class CMDSSQLite::Internals {
 																			addDocumentInfoToKeyAndDocumentInfoArray,
 																	&keyAndDocumentInfos));
 
+													// Iterate document backings
+													documentBackingsIterate(documentType, keyAndDocumentInfos,
+															documentBackingKeyProc, userData);
+												}
+				void						documentBackingsIterate(const CString& documentType,
+													const TArray<DMDocumentInfo>& documentInfos,
+													CMDSSQLiteDocumentBacking::KeyProc documentBackingKeyProc,
+													void* userData)
+												{
+													// Collect KeyAndDocumentInfos
+													TNArray<KeyAndDocumentInfo>	keyAndDocumentInfos;
+													for (TArray<DMDocumentInfo>::Iterator iterator =
+																	documentInfos.getIterator();
+															iterator; iterator++)
+														// Add
+														keyAndDocumentInfos +=
+																KeyAndDocumentInfo(CString::mEmpty, *iterator);
+
 													// Iterate document backings
 													documentBackingsIterate(documentType, keyAndDocumentInfos,
 															documentBackingKeyProc, userData);
@@ -646,10 +1051,10 @@ class CMDSSQLite::Internals {
 																											iterator->
 																													getDocumentInfo()
 																													.getDocumentID();
-														const	OR<I<CMDSSQLiteDocumentBacking> >	documentBacking =
+														const	OV<I<CMDSSQLiteDocumentBacking> >	documentBacking =
 																											mDocumentBackingByDocumentID[
 																													documentID];
-														if (documentBacking.hasReference())
+														if (documentBacking.hasValue())
 															// Have in cache
 															documentBackingKeyProc(iterator->getKey(), *documentBacking,
 																	userData);
@@ -670,6 +1075,17 @@ class CMDSSQLite::Internals {
 																			addDocumentContentInfoToDictionary,
 																	&documentContentInfoByID));
 
+													// Collect attachment infos
+													DMIDArray							ids(documentInfosNotFound,
+																								(DMIDArray::MapProc)
+																										DMDocumentInfo::
+																												getIDFromDocumentInfo);
+													DMDocumentAttachmentInfoByIDByID	documentAttachmentInfoByIDByID =
+																								mDatabaseManager
+																										.documentAttachmentInfoByIDByID(
+																												documentType,
+																												ids);
+
 													// Iterate infos not found
 													for (TArray<KeyAndDocumentInfo>::Iterator iterator =
 																	keyAndDocumentInfosNotFound.getIterator();
@@ -683,12 +1099,18 @@ class CMDSSQLite::Internals {
 																									*documentContentInfoByID[
 																											id];
 
-														// Load attachment info map
+														// Get attachment info map
+														const	OR<TNDictionary<CMDSDocument::AttachmentInfo> >
+																							attachmentInfoByID =
+																									documentAttachmentInfoByIDByID[
+																											id];
 														CMDSDocument::AttachmentInfoByID	documentAttachmentInfoByID =
-																									mDatabaseManager
-																											.documentAttachmentInfoByID(
-																													documentType,
-																													id);
+																									attachmentInfoByID
+																													.hasReference() ?
+																											*attachmentInfoByID :
+																											TNDictionary<
+																													CMDSDocument::
+																															AttachmentInfo>();
 
 														// Create document backing
 														I<CMDSSQLiteDocumentBacking>		documentBacking(
@@ -715,6 +1137,27 @@ class CMDSSQLite::Internals {
 																userData);
 													}
 												}
+				CDictionary					documentPropertyMapForStorage(const CDictionary& propertyMap) const
+												{
+													// Check encoding
+													if (mPropertyMapEncoding != CMDSSQLite::kPropertyMapEncodingJSON)
+														// Binary stores Data as is
+														return propertyMap;
+
+													// JSON has no representation for raw bytes so keep Data as
+													//	Base64 strings
+													CDictionary	storedPropertyMap(propertyMap);
+													for (CDictionary::Iterator iterator = propertyMap.getIterator();
+															iterator; iterator++)
+														// Check type
+														if (iterator.getValue().getType() == SValue::kTypeData)
+															// Data
+															storedPropertyMap.set(iterator.getKey(),
+																	SValue(iterator.getValue().getData()
+																			.getBase64String()));
+
+													return storedPropertyMap;
+												}
 
 				OV<I<MDSIndex> >			indexGet(const CString& name)
 												{
@@ -762,33 +1205,51 @@ class CMDSSQLite::Internals {
 													documentBackingsIterate(documentType, keyAndDocumentInfos,
 															documentBackingKeyProc, userData);
 												}
-				void						indexUpdate(const I<MDSIndex>& index, const UpdatesInfo& updatesInfo)
+				OV<SError>					indexUpdate(const I<MDSIndex>& index, const UpdatesInfo& updatesInfo)
+												{ return indexStore(index, index->update(updatesInfo.getUpdateInfos()),
+														updatesInfo); }
+				OV<SError>					indexStore(const I<MDSIndex>& index,
+													const MDSIndex::UpdateResults& indexUpdateResults,
+													const UpdatesInfo& updatesInfo)
 												{
-													// Update Index
-													MDSIndex::UpdateResults	indexUpdateResults =
-																					index->update(
-																							updatesInfo
-																									.getUpdateInfos());
-
 													// Check if have updates
 													if (indexUpdateResults.getKeysInfos().hasValue() ||
 															!updatesInfo.getRemovedIDs().isEmpty())
 														// Update database
-														mDatabaseManager.indexUpdate(index->getName(),
+														return mDatabaseManager.indexUpdate(index->getName(),
 																indexUpdateResults.getKeysInfos(),
 																updatesInfo.getRemovedIDs(),
 																indexUpdateResults.getLastRevision());
+													else
+														// No updates
+														return OV<SError>();
+												}
+				OV<SError>					indexBringUpToDate(const I<MDSIndex>& index)
+												{
+													// Check if building.  A view being built only has partial
+													//	contents, so report that instead.
+													OV<SError>	error =
+																		checkIsBuilt(ViewBuilder::kKindIndex,
+																				index->getName());
+													ReturnErrorIfError(error);
+
+													// Update
+													return indexUpdate(index,
+															getUpdatesInfo(index->getDocumentType(),
+																	index->getLastRevision()));
 												}
 
+				OV<SError>					checkIsBuilt(ViewBuilder::Kind kind, const CString& name)
+												{ return mViewBuilder.isBuilding(kind, name) ?
+														OV<SError>(getNotUpToDateError(name)) : OV<SError>(); }
+
 				UpdatesInfo					getUpdatesInfo(const CString& documentType, UInt32 sinceRevision)
 												{
 													// Collect update infos
 													UpdatesInfoBuilder	updatesInfoBuilder(mDocumentStorage,
 																				mDocumentStorage.documentCreateInfo(
 																						documentType),
-																				mBatchByThreadRef[
-																						CThread::
-																								getCurrentRefAsString()]);
+																				mBatchByThread.get());
 													documentBackingsIterate(documentType, sinceRevision, OV<UInt32>(),
 															false,
 															(CMDSSQLiteDocumentBacking::KeyProc)
@@ -800,41 +1261,53 @@ class CMDSSQLite::Internals {
 
 				void						update(const CString& documentType, const UpdatesInfo& updatesInfo)
 												{
-													// Get caches
-													const	OR<TNArray<I<MDSCache> > >	caches =
-																								mCachesByDocumentType[
-																										documentType];
-													if (caches.hasReference())
-														// Iterate caches
-														for (TArray<I<MDSCache> >::Iterator iterator =
-																		caches->getIterator();
-																iterator; iterator++)
-															// Update cache
-															cacheUpdate(*iterator, updatesInfo);
-
-													// Get collections
-													const	OR<TNArray<I<MDSCollection> > >	collections =
-																									mCollectionsByDocumentType[
-																											documentType];
-													if (collections.hasReference())
-														// Iterate collections
-														for (TArray<I<MDSCollection> >::Iterator iterator =
-																		collections->getIterator();
-																iterator; iterator++)
-															// Update collection
-															collectionUpdate(*iterator, updatesInfo);
-
-													// Get indexes
-													const	OR<TNArray<I<MDSIndex> > >	indexes =
-																								mIndexesByDocumentType[
-																										documentType];
-													if (indexes.hasReference())
-														// Iterate indexes
-														for (TArray<I<MDSIndex> >::Iterator iterator =
-																		indexes->getIterator();
-																iterator; iterator++)
-															// Update index
-															indexUpdate(*iterator, updatesInfo);
+													// Setup
+													ViewsUpdate	viewsUpdate(mCachesByDocumentType[documentType],
+																		mCollectionsByDocumentType[documentType],
+																		mIndexesByDocumentType[documentType],
+																		mViewBuilder, mBatchByThread, updatesInfo);
+
+													// Compute cache, collection and index updates.  This only calls
+													//	into the document performers, so it is spread across the
+													//	shared worker pool.
+													CMDSWorkerPool::getShared().perform(viewsUpdate.getCount(),
+															(CMDSWorkerPool::Proc) ViewsUpdate::perform, &viewsUpdate);
+
+													// Store results.  Database writes stay on this thread.
+													for (TArray<I<ViewUpdate<MDSCache> > >::Iterator iterator =
+																	viewsUpdate.mCacheUpdates.getIterator();
+															iterator; iterator++)
+														// Store cache update
+														cacheStore((*iterator)->mView, *(*iterator)->mUpdateResults,
+																updatesInfo);
+													for (TArray<I<ViewUpdate<MDSCollection> > >::Iterator iterator =
+																	viewsUpdate.mCollectionUpdates.getIterator();
+															iterator; iterator++)
+														// Store collection update
+														collectionStore((*iterator)->mView,
+																*(*iterator)->mUpdateResults, updatesInfo);
+													for (TArray<I<ViewUpdate<MDSIndex> > >::Iterator iterator =
+																	viewsUpdate.mIndexUpdates.getIterator();
+															iterator; iterator++)
+														// Store index update
+														indexStore((*iterator)->mView, *(*iterator)->mUpdateResults,
+																updatesInfo);
+												}
+				OV<UInt32>					viewBuild(ViewBuilder& viewBuilder, const ViewBuilder::Item& item)
+												{
+													// Process the next documents as a single transaction so the
+													//	view's contents and lastRevision are stored together
+													ViewBuildInfo	viewBuildInfo(*this, viewBuilder, item);
+													OV<SError>		error =
+																			mDatabaseManager.batch(
+																				(CMDSSQLiteDatabaseManager::BatchProc)
+																						viewBuildStep,
+																				&viewBuildInfo);
+
+													// The view stays marked as building when the step could not be
+													//	stored, so queries keep reporting it as not up to date.
+													return !error.hasValue() ?
+															viewBuildInfo.mNextRevision : OV<UInt32>();
 												}
 
 				void						process(const CString& documentID,
@@ -899,6 +1372,9 @@ class CMDSSQLite::Internals {
 																iterator->getContent(),
 																mDatabaseManager);
 
+													// Re-account in cache
+													mDocumentBackingByDocumentID.update(documentBacking);
+
 													// Call document changed procs
 													for (TArray<CMDSDocument::ChangedInfo>::Iterator iterator =
 																	documentChangedInfos.getIterator();
@@ -938,6 +1414,14 @@ class CMDSSQLite::Internals {
 															CMDSDocument::RevisionInfo(documentInfo.getDocumentID(),
 																	documentInfo.getRevision()));
 
+													return OV<SError>();
+												}
+		static	OV<SError>					addDocumentInfoToDocumentInfoArray(const DMDocumentInfo& documentInfo,
+													TNArray<DMDocumentInfo>* documentInfos)
+												{
+													// Add
+													(*documentInfos) += documentInfo;
+
 													return OV<SError>();
 												}
 		static	OV<SError>					addDocumentInfoToKeyAndDocumentInfoArray(const DMDocumentInfo& documentInfo,
@@ -958,6 +1442,47 @@ class CMDSSQLite::Internals {
 
 													return OV<SError>();
 												}
+		static	TArray<CMDSDocument::RevisionInfo>	getDocumentRevisionInfos(const TArray<DMDocumentInfo>& documentInfos)
+												{
+													// Collect CMDSDocument RevisionInfos
+													TNArray<CMDSDocument::RevisionInfo>	documentRevisionInfos;
+													for (TArray<DMDocumentInfo>::Iterator iterator =
+																	documentInfos.getIterator();
+															iterator; iterator++)
+														// Add
+														documentRevisionInfos += iterator->getDocumentRevisionInfo();
+
+													return documentRevisionInfos;
+												}
+		static	TVResult<OV<SInt64> >		getAfterID(const OV<CString>& continuationToken)
+												{
+													// Check for token
+													if (!continuationToken.hasValue())
+														// First page
+														return TVResult<OV<SInt64> >(OV<SInt64>());
+
+													// Tokens are ids written out in full, so anything that does not
+													//	survive the round trip did not come from us
+													SInt64	id = continuationToken->getSInt64();
+													if (CString(id) != *continuationToken)
+														return TVResult<OV<SInt64> >(
+																getInvalidContinuationTokenError(*continuationToken));
+
+													return TVResult<OV<SInt64> >(OV<SInt64>(id));
+												}
+		static	OV<CString>					getContinuationToken(const TArray<DMDocumentInfo>& documentInfos,
+													UInt32 count)
+												{
+													// A short page is the last page.  Otherwise the token is the id of
+													//	the last row returned, which is what the next query seeks past.
+													if ((count == 0) || (documentInfos.getCount() < count))
+														return OV<CString>();
+
+													UInt32					index = documentInfos.getCount() - 1;
+													const	DMDocumentInfo&	documentInfo = documentInfos[index];
+
+													return OV<CString>(CString(documentInfo.getID()));
+												}
 		static	OV<SError>					addDocumentContentInfoToDictionary(
 													const DMDocumentContentInfo& documentContentInfo,
 													TNKeyConvertibleDictionary<SInt64, DMDocumentContentInfo>*
@@ -973,6 +1498,9 @@ class CMDSSQLite::Internals {
 													const I<CMDSSQLiteDocumentBacking>& documentBacking,
 													TNArray<CString>* documentIDs)
 												{ documentIDs->add(documentBacking->getDocumentID()); }
+		static	UInt64						getDocumentBackingByteCount(
+													const I<CMDSSQLiteDocumentBacking>& documentBacking)
+												{ return documentBacking->getByteCount(); }
 
 		static	void						batch(BatchInfo* batchInfo)
 												{
@@ -1260,6 +1788,11 @@ class CMDSSQLite::Internals {
 														internals.mDocumentsBeingCreatedPropertyMapByDocumentID.remove(
 																documentID);
 
+														// Prepare property map
+														CDictionary	propertyMapUse =
+																			internals.documentPropertyMapForStorage(
+																					iterator->getPropertyMap());
+
 														// Add document
 														UniversalTime					creationUniversalTime =
 																								iterator->
@@ -1277,8 +1810,7 @@ class CMDSSQLite::Internals {
 																										documentID,
 																										creationUniversalTime,
 																										modificationUniversalTime,
-																										iterator->
-																												getPropertyMap(),
+																										propertyMapUse,
 																										internals
 																												.mDatabaseManager));
 														internals.mDocumentBackingByDocumentID.add(
@@ -1325,9 +1857,11 @@ class CMDSSQLite::Internals {
 														// Update document backing
 														documentBacking->update(
 																processDocumentUpdateInfo->getDocumentType(),
-																documentUpdateInfo.getUpdated(),
+																internals.documentPropertyMapForStorage(
+																		documentUpdateInfo.getUpdated()),
 																documentUpdateInfo.getRemoved(),
 																internals.mDatabaseManager);
+														internals.mDocumentBackingByDocumentID.update(documentBacking);
 
 														// Add update
 														processDocumentUpdateInfo->update(
@@ -1398,13 +1932,62 @@ class CMDSSQLite::Internals {
 													const I<CMDSSQLiteDocumentBacking>& documentBacking,
 													OV<I<CMDSSQLiteDocumentBacking> >* documentBackingValue)
 												{ documentBackingValue->setValue(documentBacking); }
+		static	void						viewBuildStep(ViewBuildInfo* viewBuildInfo)
+												{
+													// Setup
+															Internals&			internals = viewBuildInfo->mInternals;
+													const	ViewBuilder::Item&	item = viewBuildInfo->mItem;
+													const	CString&			documentType = item.mDocumentType;
+
+													// Collect the next documents in revision order
+													UpdatesInfoBuilder	updatesInfoBuilder(internals.mDocumentStorage,
+																				internals.mDocumentStorage
+																						.documentCreateInfo(
+																								documentType),
+																				OR<I<MDSBatch> >());
+													internals.documentBackingsIterate(documentType,
+															item.mSinceRevision, OV<UInt32>(kViewBuildStepDocumentCount),
+															false,
+															(CMDSSQLiteDocumentBacking::KeyProc)
+																	processDocumentInfoForGetUpdatesInfo,
+															&updatesInfoBuilder);
+
+													// Check if have reached the end
+													if (!updatesInfoBuilder.getLastRevision().hasValue()) {
+														// Up to date.  This is noted while still in the transaction
+														//	so that no document update can land between here and the
+														//	view going back to being updated with each change.
+														viewBuildInfo->mViewBuilder.noteComplete(item);
+
+														return;
+													}
+
+													// Update view
+													UpdatesInfo	updatesInfo = updatesInfoBuilder.getUpdatesInfo();
+													switch (item.mKind) {
+														case ViewBuilder::kKindCache:
+															internals.cacheUpdate(*item.mCache, updatesInfo);
+															break;
+
+														case ViewBuilder::kKindCollection:
+															internals.collectionUpdate(*item.mCollection, updatesInfo);
+															break;
+
+														case ViewBuilder::kKindIndex:
+															internals.indexUpdate(*item.mIndex, updatesInfo);
+															break;
+													}
+
+													viewBuildInfo->mNextRevision = updatesInfoBuilder.getLastRevision();
+												}
 
 	public:
 		CMDSDocumentStorage&									mDocumentStorage;
+		CMDSSQLite::PropertyMapEncoding							mPropertyMapEncoding;
 
 		TNLockingDictionary<I<CMDSAssociation> >				mAssociationByName;
 
-		TNLockingDictionary<I<MDSBatch> >						mBatchByThreadRef;
+		TMDSBatchByThread<I<MDSBatch> >							mBatchByThread;
 
 		TNLockingDictionary<I<MDSCache> >						mCacheByName;
 		TNLockingArrayDictionary<I<MDSCache> >					mCachesByDocumentType;
@@ -1419,8 +2002,15 @@ class CMDSSQLite::Internals {
 
 		TNLockingDictionary<I<MDSIndex> >						mIndexByName;
 		TNLockingArrayDictionary<I<MDSIndex> >					mIndexesByDocumentType;
+
+		ViewBuilder												mViewBuilder;
+
+	private:
+		static	const	UInt32									kViewBuildStepDocumentCount = 1000;
 };
 
+const	UInt32	CMDSSQLite::Internals::kViewBuildStepDocumentCount;
+
 //----------------------------------------------------------------------------------------------------------------------
 //----------------------------------------------------------------------------------------------------------------------
 // MARK: - CMDSSQLite
@@ -1428,10 +2018,14 @@ class CMDSSQLite::Internals {
 // MARK: Lifecycle methods
 
 //----------------------------------------------------------------------------------------------------------------------
-CMDSSQLite::CMDSSQLite(const CFolder& folder, const CString& name)
+CMDSSQLite::CMDSSQLite(const CFolder& folder, const CString& name, DurabilityMode durabilityMode,
+		const OV<WALCheckpointInfo>& walCheckpointInfo, PropertyMapEncoding propertyMapEncoding,
+		DateEncoding dateEncoding, UInt32 documentBackingCacheLimit, const OV<UInt64>& documentBackingCacheByteLimit)
 //----------------------------------------------------------------------------------------------------------------------
 {
-	mInternals = new Internals(*this, folder, name);
+	mInternals =
+			new Internals(*this, folder, name, durabilityMode, walCheckpointInfo, propertyMapEncoding, dateEncoding,
+					documentBackingCacheLimit, documentBackingCacheByteLimit);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -1476,7 +2070,7 @@ TVResult<TArray<CMDSAssociation::Item> > CMDSSQLite::associationGet(const CStrin
 													(*association)->getToDocumentType());
 
 	// Check for batch
-	const	OR<I<MDSBatch> >	batch = mInternals->mBatchByThreadRef[CThread::getCurrentRefAsString()];
+	const	OR<I<MDSBatch> >	batch = mInternals->mBatchByThread.get();
 	if (batch.hasReference())
 		// Apply batch changes
 		associationItems = (*batch)->associationItemsApplyingChanges(name, associationItems);
@@ -1503,7 +2097,7 @@ OV<SError> CMDSSQLite::associationIterateFrom(const CString& name, const CString
 	TArray<CMDSAssociation::Item>	associationItems = *associationItemsResult;
 
 	// Check for batch
-	const	OR<I<MDSBatch> >	batch = mInternals->mBatchByThreadRef[CThread::getCurrentRefAsString()];
+	const	OR<I<MDSBatch> >	batch = mInternals->mBatchByThread.get();
 	if (batch.hasReference())
 		// Apply batch changes
 		associationItems = (*batch)->associationItemsApplyingChanges(name, associationItems);
@@ -1539,7 +2133,7 @@ OV<SError> CMDSSQLite::associationIterateTo(const CString& name, const CString&
 	TArray<CMDSAssociation::Item>	associationItems = *associationItemsResult;
 
 	// Check for batch
-	const	OR<I<MDSBatch> >	batch = mInternals->mBatchByThreadRef[CThread::getCurrentRefAsString()];
+	const	OR<I<MDSBatch> >	batch = mInternals->mBatchByThread.get();
 	if (batch.hasReference())
 		// Apply batch changes
 		associationItems = (*batch)->associationItemsApplyingChanges(name, associationItems);
@@ -1578,7 +2172,7 @@ TVResult<SValue> CMDSSQLite::associationGetValues(const CString& name, CMDSAssoc
 	TNArray<CString>	fromDocumentIDsUse(fromDocumentIDs);
 
 	// Check for batch
-	const	OR<I<MDSBatch> >	batch = mInternals->mBatchByThreadRef[CThread::getCurrentRefAsString()];
+	const	OR<I<MDSBatch> >	batch = mInternals->mBatchByThread.get();
 	if (batch.hasReference()) {
 		// Get updates
 		TArray<CMDSAssociation::Update>	associationUpdates = (*batch)->associationGetUpdates(name);
@@ -1635,7 +2229,7 @@ OV<SError> CMDSSQLite::associationUpdate(const CString& name, const TArray<CMDSA
 					&updateToDocumentIDs));
 
 	// Check for batch
-	const	OR<I<MDSBatch> >	batch = mInternals->mBatchByThreadRef[CThread::getCurrentRefAsString()];
+	const	OR<I<MDSBatch> >	batch = mInternals->mBatchByThread.get();
 	if (batch.hasReference()) {
 		// In batch
 		// Ensure all update from documentIDs exist
@@ -1658,8 +2252,8 @@ OV<SError> CMDSSQLite::associationUpdate(const CString& name, const TArray<CMDSA
 			return OV<SError>(getUnknownDocumentIDError(updateToDocumentIDs.getArray()[0]));
 
 		// Update
-		mInternals->mDatabaseManager.associationUpdate(name, updates, (*association)->getFromDocumentType(),
-				(*association)->getToDocumentType());
+		return mInternals->mDatabaseManager.associationUpdate(name, updates,
+				(*association)->getFromDocumentType(), (*association)->getToDocumentType());
 	}
 
 	return OV<SError>();
@@ -1695,6 +2289,12 @@ OV<SError> CMDSSQLite::cacheRegister(const CString& name, const CString& documen
 	// Create or re-create
 	I<MDSCache>	cache(new MDSCache(name, documentType, relevantProperties, __cacheValueInfos, lastRevision));
 
+	// Check if need to catch up on existing documents (or replace one being built)
+	if ((lastRevision < mInternals->mDatabaseManager.documentLastRevision(documentType)) ||
+			mInternals->mViewBuilder.isBuilding(Internals::ViewBuilder::kKindCache, name))
+		// Build in the background
+		mInternals->mViewBuilder.add(Internals::ViewBuilder::Item(cache, lastRevision));
+
 	// Add to maps
 	mInternals->mCacheByName.set(name, cache);
 	mInternals->mCachesByDocumentType.add(documentType, cache);
@@ -1722,8 +2322,8 @@ TVResult<TArray<CDictionary> > CMDSSQLite::cacheGetValues(const CString& name, c
 	}
 
 	// Bring up to date
-	mInternals->cacheUpdate(*cache, mInternals->getUpdatesInfo((*cache)->getDocumentType(),
-			(*cache)->getLastRevision()));
+	OV<SError>	error = mInternals->cacheBringUpToDate(*cache);
+	ReturnValueIfError(error, TVResult<TArray<CDictionary> >(*error));
 
 	return mInternals->mDatabaseManager.cacheGetValues(*cache, valueNames, documentIDs);
 }
@@ -1749,6 +2349,12 @@ OV<SError> CMDSSQLite::collectionRegister(const CString& name, const CString& do
 								new MDSCollection(name, documentType, relevantProperties, documentIsIncludedPerformer,
 										checkRelevantProperties, isIncludedInfo, lastRevision));
 
+	// Check if need to catch up on existing documents (or replace one being built)
+	if ((lastRevision < mInternals->mDatabaseManager.documentLastRevision(documentType)) ||
+			mInternals->mViewBuilder.isBuilding(Internals::ViewBuilder::kKindCollection, name))
+		// Build in the background
+		mInternals->mViewBuilder.add(Internals::ViewBuilder::Item(collection, lastRevision));
+
 	// Add to maps
 	mInternals->mCollectionByName.set(name, collection);
 	mInternals->mCollectionsByDocumentType.add(documentType, collection);
@@ -1764,12 +2370,12 @@ TVResult<UInt32> CMDSSQLite::collectionGetDocumentCount(const CString& name) con
 	OV<I<MDSCollection> >	collection = mInternals->collectionGet(name);
 	if (!collection.hasValue())
 		return TVResult<UInt32>(getUnknownCollectionError(name));
-	if (mInternals->mBatchByThreadRef[CThread::getCurrentRefAsString()].hasReference())
+	if (mInternals->mBatchByThread.get().hasReference())
 		return TVResult<UInt32>(getIllegalInBatchError());
 
 	// Bring up to date
-	mInternals->collectionUpdate(*collection, mInternals->getUpdatesInfo((*collection)->getDocumentType(),
-			(*collection)->getLastRevision()));
+	OV<SError>	error = mInternals->collectionBringUpToDate(*collection);
+	ReturnValueIfError(error, TVResult<UInt32>(*error));
 
 	return TVResult<UInt32>(mInternals->mDatabaseManager.collectionGetDocumentCount(name));
 }
@@ -1783,12 +2389,12 @@ OV<SError> CMDSSQLite::collectionIterate(const CString& name, const CString& doc
 	OV<I<MDSCollection> >	collection = mInternals->collectionGet(name);
 	if (!collection.hasValue())
 		return OV<SError>(getUnknownCollectionError(name));
-	if (mInternals->mBatchByThreadRef[CThread::getCurrentRefAsString()].hasReference())
+	if (mInternals->mBatchByThread.get().hasReference())
 		return OV<SError>(getIllegalInBatchError());
 
 	// Bring up to date
-	mInternals->collectionUpdate(*collection, mInternals->getUpdatesInfo((*collection)->getDocumentType(),
-			(*collection)->getLastRevision()));
+	OV<SError>	error = mInternals->collectionBringUpToDate(*collection);
+	ReturnErrorIfError(error);
 
 	// Collect document IDs
 	TNArray<CString>	documentIDs;
@@ -1815,7 +2421,7 @@ TVResult<TArray<CMDSDocument::CreateResultInfo> > CMDSSQLite::documentCreate(
 	TNArray<CMDSDocument::CreateResultInfo>	documentCreateResultInfos;
 
 	// Check for batch
-	const	OR<I<MDSBatch> >	batch = mInternals->mBatchByThreadRef[CThread::getCurrentRefAsString()];
+	const	OR<I<MDSBatch> >	batch = mInternals->mBatchByThread.get();
 	if (batch.hasReference()) {
 		// In batch
 		UniversalTime	universalTime = SUniversalTime::getCurrent();
@@ -1830,15 +2436,28 @@ TVResult<TArray<CMDSDocument::CreateResultInfo> > CMDSSQLite::documentCreate(
 			(*batch)->documentAdd(documentInfoForNew.getDocumentType(), documentID,
 					iterator->getCreationUniversalTime().getValue(universalTime),
 					iterator->getModificationUniversalTime().getValue(universalTime),
-					OV<CDictionary>(iterator->getPropertyMap()));
+					OV<CDictionary>(mInternals->documentPropertyMapForStorage(iterator->getPropertyMap())));
 			documentCreateResultInfos += CMDSDocument::CreateResultInfo(documentInfoForNew.create(documentID, *this));
 		}
 	} else {
 		// Batch
 		Internals::DocumentCreateInfo	documentCreateInfo(*mInternals, documentInfoForNew, documentCreateInfos,
 												documentCreateResultInfos);
-		mInternals->mDatabaseManager.batch((CMDSSQLiteDatabaseManager::BatchProc) Internals::processDocumentCreate,
-				&documentCreateInfo);
+		OV<SError>	error =
+							mInternals->mDatabaseManager.batch(
+									(CMDSSQLiteDatabaseManager::BatchProc) Internals::processDocumentCreate,
+									&documentCreateInfo);
+		if (error.hasValue()) {
+			// Rolled back.  Drop document backings for documents that were never stored.
+			for (TArray<CMDSDocument::CreateResultInfo>::Iterator iterator =
+							documentCreateResultInfos.getIterator();
+					iterator; iterator++)
+				// Remove
+				mInternals->mDocumentBackingByDocumentID.remove(
+						TSArray<CString>(iterator->getDocument()->getID()));
+
+			return TVResult<TArray<CMDSDocument::CreateResultInfo> >(*error);
+		}
 
 		// Call document changed procs
 		for (TArray<CMDSDocument::CreateResultInfo>::Iterator iterator = documentCreateResultInfos.getIterator();
@@ -1857,7 +2476,7 @@ TVResult<UInt32> CMDSSQLite::documentGetCount(const CString& documentType) const
 	// Validate
 	if (!mInternals->mDatabaseManager.documentTypeIsKnown(documentType))
 		return TVResult<UInt32>(getUnknownDocumentTypeError(documentType));
-	if (mInternals->mBatchByThreadRef[CThread::getCurrentRefAsString()].hasReference())
+	if (mInternals->mBatchByThread.get().hasReference())
 		return TVResult<UInt32>(getIllegalInBatchError());
 
 	return TVResult<UInt32>(mInternals->mDatabaseManager.documentCount(documentType));
@@ -1873,7 +2492,7 @@ OV<SError> CMDSSQLite::documentIterate(const CMDSDocument::Info& documentInfo, c
 		return OV<SError>(getUnknownDocumentTypeError(documentInfo.getDocumentType()));
 
 	// Setup
-	const	OR<I<MDSBatch> >	batch = mInternals->mBatchByThreadRef[CThread::getCurrentRefAsString()];
+	const	OR<I<MDSBatch> >	batch = mInternals->mBatchByThread.get();
 
 	// Iterate initial document IDs
 	TNArray<CString>	documentIDsToCache;
@@ -1882,7 +2501,7 @@ OV<SError> CMDSSQLite::documentIterate(const CMDSDocument::Info& documentInfo, c
 		if (batch.hasReference() && (*batch)->documentInfoGet(*iterator).hasReference())
 			// Have document in batch
 			proc(documentInfo.create(*iterator, (CMDSDocumentStorage&) *this), procUserData);
-		else if (mInternals->mDocumentBackingByDocumentID.getDocumentBacking(*iterator).hasReference())
+		else if (mInternals->mDocumentBackingByDocumentID.getDocumentBacking(*iterator).hasValue())
 			// Have documentBacking in cache
 			proc(documentInfo.create(*iterator, (CMDSDocumentStorage&) *this), procUserData);
 		else
@@ -1913,7 +2532,7 @@ OV<SError> CMDSSQLite::documentIterate(const CMDSDocument::Info& documentInfo, b
 	// Validate
 	if (!mInternals->mDatabaseManager.documentTypeIsKnown(documentInfo.getDocumentType()))
 		return OV<SError>(getUnknownDocumentTypeError(documentInfo.getDocumentType()));
-	if (mInternals->mBatchByThreadRef[CThread::getCurrentRefAsString()].hasReference())
+	if (mInternals->mBatchByThread.get().hasReference())
 		return OV<SError>(getIllegalInBatchError());
 
 	// Iterate document backings
@@ -1927,85 +2546,88 @@ OV<SError> CMDSSQLite::documentIterate(const CMDSDocument::Info& documentInfo, b
 }
 
 //----------------------------------------------------------------------------------------------------------------------
-UniversalTime CMDSSQLite::documentCreationUniversalTime(const I<CMDSDocument>& document) const
+UniversalTime CMDSSQLite::documentCreationUniversalTime(const CMDSDocument& document) const
 //----------------------------------------------------------------------------------------------------------------------
 {
 	// Check for batch
-	const	OR<I<MDSBatch> >			batch = mInternals->mBatchByThreadRef[CThread::getCurrentRefAsString()];
+	const	OR<I<MDSBatch> >			batch = mInternals->mBatchByThread.get();
 			OR<MDSBatchDocumentInfo>	batchDocumentInfo =
 												batch.hasReference() ?
-														(*batch)->documentInfoGet(document->getID()) :
+														(*batch)->documentInfoGet(document.getID()) :
 														OR<MDSBatchDocumentInfo>();
 	if (batchDocumentInfo.hasReference())
 		// In batch
 		return batchDocumentInfo->getCreationUniversalTime();
-	else if (mInternals->mDocumentsBeingCreatedPropertyMapByDocumentID.contains(document->getID()))
+	else if (mInternals->mDocumentsBeingCreatedPropertyMapByDocumentID.contains(document.getID()))
 		// Being created
 		return SUniversalTime::getCurrent();
 	else
 		// "Idle"
-		return (*mInternals->documentBackingGet(document->getDocumentType(), document->getID()))->
+		return (*mInternals->documentBackingGet(document.getDocumentType(), document.getID()))->
 				getCreationUniversalTime();
 }
 
 //----------------------------------------------------------------------------------------------------------------------
-UniversalTime CMDSSQLite::documentModificationUniversalTime(const I<CMDSDocument>& document) const
+UniversalTime CMDSSQLite::documentModificationUniversalTime(const CMDSDocument& document) const
 //----------------------------------------------------------------------------------------------------------------------
 {
 	// Check for batch
-	const	OR<I<MDSBatch> >			batch = mInternals->mBatchByThreadRef[CThread::getCurrentRefAsString()];
+	const	OR<I<MDSBatch> >			batch = mInternals->mBatchByThread.get();
 			OR<MDSBatchDocumentInfo>	batchDocumentInfo =
 												batch.hasReference() ?
-														(*batch)->documentInfoGet(document->getID()) :
+														(*batch)->documentInfoGet(document.getID()) :
 														OR<MDSBatchDocumentInfo>();
 	if (batchDocumentInfo.hasReference())
 		// In batch
 		return batchDocumentInfo->getModificationUniversalTime();
-	else if (mInternals->mDocumentsBeingCreatedPropertyMapByDocumentID.contains(document->getID()))
+	else if (mInternals->mDocumentsBeingCreatedPropertyMapByDocumentID.contains(document.getID()))
 		// Being created
 		return SUniversalTime::getCurrent();
 	else
 		// "Idle"
-		return (*mInternals->documentBackingGet(document->getDocumentType(), document->getID()))->
+		return (*mInternals->documentBackingGet(document.getDocumentType(), document.getID()))->
 				getModificationUniversalTime();
 }
 
 //----------------------------------------------------------------------------------------------------------------------
-OV<SValue> CMDSSQLite::documentValue(const CString& property, const I<CMDSDocument>& document) const
+OV<SValue> CMDSSQLite::documentValue(const CString& property, const CMDSDocument& document) const
 //----------------------------------------------------------------------------------------------------------------------
 {
 	// Check for batch
-	const	OR<I<MDSBatch> >			batch = mInternals->mBatchByThreadRef[CThread::getCurrentRefAsString()];
+	const	OR<I<MDSBatch> >			batch = mInternals->mBatchByThread.get();
 			OR<MDSBatchDocumentInfo>	batchDocumentInfo =
 												batch.hasReference() ?
-														(*batch)->documentInfoGet(document->getID()) :
+														(*batch)->documentInfoGet(document.getID()) :
 														OR<MDSBatchDocumentInfo>();
 	if (batchDocumentInfo.hasReference())
 		// In batch
 		return batchDocumentInfo->getValue(property);
-	else if (mInternals->mDocumentsBeingCreatedPropertyMapByDocumentID.contains(document->getID()))
+	else if (mInternals->mDocumentsBeingCreatedPropertyMapByDocumentID.contains(document.getID()))
 		// Being created
-		return mInternals->mDocumentsBeingCreatedPropertyMapByDocumentID[document->getID()]->getOValue(property);
+		return mInternals->mDocumentsBeingCreatedPropertyMapByDocumentID[document.getID()]->getOValue(property);
 	else
 		// "Idle"
-		return (*mInternals->documentBackingGet(document->getDocumentType(), document->getID()))->
-				getPropertyMap().getOValue(property);
+		return (*mInternals->documentBackingGet(document.getDocumentType(), document.getID()))->getValue(property);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
-OV<CData> CMDSSQLite::documentData(const CString& property, const I<CMDSDocument>& document) const
+OV<CData> CMDSSQLite::documentData(const CString& property, const CMDSDocument& document) const
 //----------------------------------------------------------------------------------------------------------------------
 {
-	// Retrieve Base64-encoded string
+	// Get value
 	OV<SValue>	value = documentValue(property, document);
 	if (!value.hasValue())
 		return OV<CData>();
-
-	return OV<CData>(CData::fromBase64String(value->getString()));
+	else if (value->getType() == SValue::kTypeData)
+		// Raw bytes
+		return OV<CData>(value->getData());
+	else
+		// Base64-encoded string (JSON property maps and binary property maps written before raw data was supported)
+		return OV<CData>(CData::fromBase64String(value->getString()));
 }
 
 //----------------------------------------------------------------------------------------------------------------------
-OV<UniversalTime> CMDSSQLite::documentUniversalTime(const CString& property, const I<CMDSDocument>& document) const
+OV<UniversalTime> CMDSSQLite::documentUniversalTime(const CString& property, const CMDSDocument& document) const
 //----------------------------------------------------------------------------------------------------------------------
 {
 	// Get value
@@ -2021,17 +2643,19 @@ OV<UniversalTime> CMDSSQLite::documentUniversalTime(const CString& property, con
 }
 
 //----------------------------------------------------------------------------------------------------------------------
-void CMDSSQLite::documentSet(const CString& property, const OV<SValue>& value, const I<CMDSDocument>& document,
+void CMDSSQLite::documentSet(const CString& property, const OV<SValue>& value, const CMDSDocument& document,
 		SetValueKind setValueKind)
 //----------------------------------------------------------------------------------------------------------------------
 {
 	// Setup
-	const	CString&	documentType = document->getDocumentType();
-	const	CString&	documentID = document->getID();
+	const	CString&	documentType = document.getDocumentType();
+	const	CString&	documentID = document.getID();
 
-	// Transform
+	// Transform.  JSON has no representation for raw bytes so Data is kept as a Base64 string when property maps are
+	//	stored as JSON.  This way document backings hold the same values whether cached or loaded from the database.
 	OV<SValue>	valueUse;
-	if (value.hasValue() && (value->getType() == SValue::kTypeData))
+	if (value.hasValue() && (value->getType() == SValue::kTypeData) &&
+			(mInternals->mPropertyMapEncoding == kPropertyMapEncodingJSON))
 		// Data
 		valueUse = OV<SValue>(value->getData().getBase64String());
 	else if (value.hasValue() && (setValueKind == kSetValueKindUniversalTime))
@@ -2042,7 +2666,7 @@ void CMDSSQLite::documentSet(const CString& property, const OV<SValue>& value, c
 		valueUse = value;
 
 	// Check for batch
-	const	OR<I<MDSBatch> >	batch = mInternals->mBatchByThreadRef[CThread::getCurrentRefAsString()];
+	const	OR<I<MDSBatch> >	batch = mInternals->mBatchByThread.get();
 	if (batch.hasReference()) {
 		// In batch
 		OR<MDSBatchDocumentInfo>	batchDocumentInfo = (*batch)->documentInfoGet(documentID);
@@ -2067,16 +2691,18 @@ void CMDSSQLite::documentSet(const CString& property, const OV<SValue>& value, c
 			I<CMDSSQLiteDocumentBacking>	documentBacking =
 													mInternals->documentBackingGet(documentType, documentID).getValue();
 			documentBacking->set(property, valueUse, documentType, mInternals->mDatabaseManager);
+			mInternals->mDocumentBackingByDocumentID.update(documentBacking);
 
 			// Update stuffs
+			I<CMDSDocument>	documentInstance = document.makeI();
 			mInternals->update(documentType,
 					Internals::UpdatesInfo(
 							TSArray<MDSUpdateInfo>(
-									MDSUpdateInfo(document, documentBacking->getRevision(), documentBacking->getID(),
-											TNSet<CString>(property)))));
+									MDSUpdateInfo(documentInstance, documentBacking->getRevision(),
+											documentBacking->getID(), TNSet<CString>(property)))));
 
 			// Call document changed procs
-			notifyDocumentChanged(document, CMDSDocument::kChangeKindUpdated);
+			notifyDocumentChanged(documentInstance, CMDSDocument::kChangeKindUpdated);
 		}
 	}
 }
@@ -2091,7 +2717,7 @@ TVResult<CMDSDocument::AttachmentInfo> CMDSSQLite::documentAttachmentAdd(const C
 		return TVResult<CMDSDocument::AttachmentInfo>(getUnknownDocumentTypeError(documentType));
 
 	// Check for batch
-	const	OR<I<MDSBatch> >	batch = mInternals->mBatchByThreadRef[CThread::getCurrentRefAsString()];
+	const	OR<I<MDSBatch> >	batch = mInternals->mBatchByThread.get();
 	if (batch.hasReference()) {
 		// In batch
 		OR<MDSBatchDocumentInfo>	batchDocumentInfo = (*batch)->documentInfoGet(documentID);
@@ -2109,11 +2735,16 @@ TVResult<CMDSDocument::AttachmentInfo> CMDSSQLite::documentAttachmentAdd(const C
 	} else {
 		// Not in batch
 		MDSDocumentBackingResult	documentBacking = mInternals->documentBackingGet(documentType, documentID);
+		if (!documentBacking.hasValue())
+			return TVResult<CMDSDocument::AttachmentInfo>(getUnknownDocumentIDError(documentID));
 
-		return documentBacking.hasValue() ?
-				TVResult<CMDSDocument::AttachmentInfo>(
-						(*documentBacking)->attachmentAdd(documentType, info, content, mInternals->mDatabaseManager)) :
-				TVResult<CMDSDocument::AttachmentInfo>(getUnknownDocumentIDError(documentID));
+		// Add attachment
+		CMDSDocument::AttachmentInfo	documentAttachmentInfo =
+												(*documentBacking)->attachmentAdd(documentType, info, content,
+														mInternals->mDatabaseManager);
+		mInternals->mDocumentBackingByDocumentID.update(*documentBacking);
+
+		return TVResult<CMDSDocument::AttachmentInfo>(documentAttachmentInfo);
 	}
 }
 
@@ -2127,7 +2758,7 @@ TVResult<CMDSDocument::AttachmentInfoByID> CMDSSQLite::documentAttachmentInfoByI
 		return TVResult<CMDSDocument::AttachmentInfoByID>(getUnknownDocumentTypeError(documentType));
 
 	// Check for batch
-	const	OR<I<MDSBatch> >			batch = mInternals->mBatchByThreadRef[CThread::getCurrentRefAsString()];
+	const	OR<I<MDSBatch> >			batch = mInternals->mBatchByThread.get();
 			OR<MDSBatchDocumentInfo>	batchDocumentInfo =
 												batch.hasReference() ?
 														(*batch)->documentInfoGet(documentID) :
@@ -2164,7 +2795,7 @@ TVResult<CData> CMDSSQLite::documentAttachmentContent(const CString& documentTyp
 		return TVResult<CData>(getUnknownDocumentTypeError(documentType));
 
 	// Check for batch
-	const	OR<I<MDSBatch> >			batch = mInternals->mBatchByThreadRef[CThread::getCurrentRefAsString()];
+	const	OR<I<MDSBatch> >			batch = mInternals->mBatchByThread.get();
 			OR<MDSBatchDocumentInfo>	batchDocumentInfo =
 												batch.hasReference() ?
 														(*batch)->documentInfoGet(documentID) :
@@ -2201,7 +2832,7 @@ TVResult<OV<UInt32> > CMDSSQLite::documentAttachmentUpdate(const CString& docume
 		return TVResult<OV<UInt32> >(getUnknownDocumentTypeError(documentType));
 
 	// Check for batch
-	const	OR<I<MDSBatch> >	batch = mInternals->mBatchByThreadRef[CThread::getCurrentRefAsString()];
+	const	OR<I<MDSBatch> >	batch = mInternals->mBatchByThread.get();
 	if (batch.hasReference()) {
 		// In batch
 		OR<MDSBatchDocumentInfo>	batchDocumentInfo = (*batch)->documentInfoGet(documentID);
@@ -2253,9 +2884,12 @@ TVResult<OV<UInt32> > CMDSSQLite::documentAttachmentUpdate(const CString& docume
 			return TVResult<OV<UInt32> >(getUnknownAttachmentIDError(attachmentID));
 
 		// Update attachment
-		return TVResult<OV<UInt32> >(
-				(*documentBacking)->attachmentUpdate(documentType, attachmentID, updatedInfo, updatedContent,
-						mInternals->mDatabaseManager));
+		UInt32	revision =
+						(*documentBacking)->attachmentUpdate(documentType, attachmentID, updatedInfo, updatedContent,
+								mInternals->mDatabaseManager);
+		mInternals->mDocumentBackingByDocumentID.update(*documentBacking);
+
+		return TVResult<OV<UInt32> >(OV<UInt32>(revision));
 	}
 }
 
@@ -2269,7 +2903,7 @@ OV<SError> CMDSSQLite::documentAttachmentRemove(const CString& documentType, con
 		return OV<SError>(getUnknownDocumentTypeError(documentType));
 
 	// Check for batch
-	const	OR<I<MDSBatch> >	batch = mInternals->mBatchByThreadRef[CThread::getCurrentRefAsString()];
+	const	OR<I<MDSBatch> >	batch = mInternals->mBatchByThread.get();
 	if (batch.hasReference()) {
 		// In batch
 		OR<MDSBatchDocumentInfo>	batchDocumentInfo = (*batch)->documentInfoGet(documentID);
@@ -2309,21 +2943,22 @@ OV<SError> CMDSSQLite::documentAttachmentRemove(const CString& documentType, con
 
 		// Remove attachment
 		(*documentBacking)->attachmentRemove(documentType, attachmentID, mInternals->mDatabaseManager);
+		mInternals->mDocumentBackingByDocumentID.update(*documentBacking);
 	}
 
 	return OV<SError>();
 }
 
 //----------------------------------------------------------------------------------------------------------------------
-OV<SError> CMDSSQLite::documentRemove(const I<CMDSDocument>& document)
+OV<SError> CMDSSQLite::documentRemove(const CMDSDocument& document)
 //----------------------------------------------------------------------------------------------------------------------
 {
 	// Setup
-	const	CString&	documentType = document->getDocumentType();
-	const	CString&	documentID = document->getID();
+	const	CString&	documentType = document.getDocumentType();
+	const	CString&	documentID = document.getID();
 
 	// Check for batch
-	const	OR<I<MDSBatch> >	batch = mInternals->mBatchByThreadRef[CThread::getCurrentRefAsString()];
+	const	OR<I<MDSBatch> >	batch = mInternals->mBatchByThread.get();
 	if (batch.hasReference()) {
 		// In batch
 		OR<MDSBatchDocumentInfo>	batchDocumentInfo = (*batch)->documentInfoGet(documentID);
@@ -2352,7 +2987,7 @@ OV<SError> CMDSSQLite::documentRemove(const I<CMDSDocument>& document)
 		mInternals->mDocumentBackingByDocumentID.remove(TSArray<CString>(documentID));
 
 		// Call document changed procs
-		notifyDocumentChanged(document, CMDSDocument::kChangeKindRemoved);
+		notifyDocumentChanged(document.makeI(), CMDSDocument::kChangeKindRemoved);
 	}
 
 	return OV<SError>();
@@ -2379,6 +3014,12 @@ OV<SError> CMDSSQLite::indexRegister(const CString& name, const CString& documen
 						new MDSIndex(name, documentType, relevantProperties, documentKeysPerformer, keysInfo,
 								lastRevision));
 
+	// Check if need to catch up on existing documents (or replace one being built)
+	if ((lastRevision < mInternals->mDatabaseManager.documentLastRevision(documentType)) ||
+			mInternals->mViewBuilder.isBuilding(Internals::ViewBuilder::kKindIndex, name))
+		// Build in the background
+		mInternals->mViewBuilder.add(Internals::ViewBuilder::Item(index, lastRevision));
+
 	// Add to maps
 	mInternals->mIndexByName.set(name, index);
 	mInternals->mIndexesByDocumentType.add(documentType, index);
@@ -2395,11 +3036,12 @@ OV<SError> CMDSSQLite::indexIterate(const CString& name, const CString& document
 	OV<I<MDSIndex> >	index = mInternals->indexGet(name);
 	if (!index.hasValue())
 		return OV<SError>(getUnknownIndexError(name));
-	if (mInternals->mBatchByThreadRef[CThread::getCurrentRefAsString()].hasReference())
+	if (mInternals->mBatchByThread.get().hasReference())
 		return OV<SError>(getIllegalInBatchError());
 
 	// Bring up to date
-	mInternals->indexUpdate(*index, mInternals->getUpdatesInfo(documentType, (*index)->getLastRevision()));
+	OV<SError>	error = mInternals->indexBringUpToDate(*index);
+	ReturnErrorIfError(error);
 
 	// Compose map
 	TNDictionary<CString>	documentIDByKey;
@@ -2486,23 +3128,32 @@ OV<SError> CMDSSQLite::batch(BatchProc batchProc, void* userData)
 	I<MDSBatch>	batch(new MDSBatch());
 
 	// Store
-	mInternals->mBatchByThreadRef.set(CThread::getCurrentRefAsString(), batch);
+	mInternals->mBatchByThread.set(batch);
 
 	// Call proc
 	TVResult<EMDSBatchResult>	batchResult = batchProc(userData);
-	ReturnErrorIfResultError(batchResult);
 
 	// Check result
-	if (*batchResult == kMDSBatchResultCommit) {
-		// Batch changes
+	OV<SError>	error;
+	if (batchResult.hasError())
+		// Error
+		error.setValue(batchResult.getError());
+	else if (*batchResult == kMDSBatchResultCommit) {
+		// Batch changes.  The batch stays registered until the changes are committed as processing them reads
+		//	document properties through it.
 		Internals::BatchInfo	batchInfo(*mInternals, *batch);
-		mInternals->mDatabaseManager.batch((CMDSSQLiteDatabaseManager::BatchProc) Internals::batch, &batchInfo);
+		error =
+				mInternals->mDatabaseManager.batch((CMDSSQLiteDatabaseManager::BatchProc) Internals::batch,
+						&batchInfo);
+		if (error.hasValue())
+			// Rolled back.  Document backings changed in place no longer match the database, so drop them.
+			mInternals->mDocumentBackingByDocumentID.remove((*batch)->documentIDsGet());
 	}
 
 	// Remove
-	mInternals->mBatchByThreadRef.remove(CThread::getCurrentRefAsString());
+	mInternals->mBatchByThread.remove();
 
-	return OV<SError>();
+	return error;
 }
 
 // MARK: CMDSDocumentStorageServer methods
@@ -2639,15 +3290,150 @@ TVResult<CMDSDocumentStorageServer::DocumentFullInfosWithTotalCount> CMDSSQLite:
 }
 
 //----------------------------------------------------------------------------------------------------------------------
-OV<SError> CMDSSQLite::cacheGetStatus(const CString& name) const
+TVResult<CMDSDocumentStorageServer::DocumentRevisionInfosPage> CMDSSQLite::associationGetDocumentRevisionInfosPageFrom(
+		const CString& name, const CString& fromDocumentID, const OV<CString>& continuationToken, UInt32 count) const
+//----------------------------------------------------------------------------------------------------------------------
+{
+	// Validate
+	OV<I<CMDSAssociation> >	association = mInternals->associationGet(name);
+	if (!association.hasValue())
+		return TVResult<DocumentRevisionInfosPage>(getUnknownAssociationError(name));
+
+	TVResult<OV<SInt64> >	afterID = Internals::getAfterID(continuationToken);
+	ReturnValueIfResultError(afterID, TVResult<DocumentRevisionInfosPage>(afterID.getError()));
+
+	// Collect DocumentInfos
+	TNArray<DMDocumentInfo>	documentInfos;
+	OV<SError>				error =
+									mInternals->mDatabaseManager.associationIterateDocumentInfosFrom(name,
+											fromDocumentID, (*association)->getFromDocumentType(),
+											(*association)->getToDocumentType(),
+											*afterID, count,
+											DMDocumentInfo::ProcInfo(
+													(DMDocumentInfo::ProcInfo::Proc)
+															Internals::addDocumentInfoToDocumentInfoArray,
+													&documentInfos));
+	ReturnValueIfError(error, TVResult<DocumentRevisionInfosPage>(*error));
+
+	return TVResult<DocumentRevisionInfosPage>(
+			DocumentRevisionInfosPage(Internals::getDocumentRevisionInfos(documentInfos),
+					Internals::getContinuationToken(documentInfos, count)));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+TVResult<CMDSDocumentStorageServer::DocumentRevisionInfosPage> CMDSSQLite::associationGetDocumentRevisionInfosPageTo(
+		const CString& name, const CString& toDocumentID, const OV<CString>& continuationToken, UInt32 count) const
+//----------------------------------------------------------------------------------------------------------------------
+{
+	// Validate
+	OV<I<CMDSAssociation> >	association = mInternals->associationGet(name);
+	if (!association.hasValue())
+		return TVResult<DocumentRevisionInfosPage>(getUnknownAssociationError(name));
+
+	TVResult<OV<SInt64> >	afterID = Internals::getAfterID(continuationToken);
+	ReturnValueIfResultError(afterID, TVResult<DocumentRevisionInfosPage>(afterID.getError()));
+
+	// Collect DocumentInfos
+	TNArray<DMDocumentInfo>	documentInfos;
+	OV<SError>				error =
+									mInternals->mDatabaseManager.associationIterateDocumentInfosTo(name,
+											toDocumentID, (*association)->getToDocumentType(),
+											(*association)->getFromDocumentType(),
+											*afterID, count,
+											DMDocumentInfo::ProcInfo(
+													(DMDocumentInfo::ProcInfo::Proc)
+															Internals::addDocumentInfoToDocumentInfoArray,
+													&documentInfos));
+	ReturnValueIfError(error, TVResult<DocumentRevisionInfosPage>(*error));
+
+	return TVResult<DocumentRevisionInfosPage>(
+			DocumentRevisionInfosPage(Internals::getDocumentRevisionInfos(documentInfos),
+					Internals::getContinuationToken(documentInfos, count)));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+TVResult<CMDSDocumentStorageServer::DocumentFullInfosPage> CMDSSQLite::associationGetDocumentFullInfosPageFrom(
+		const CString& name, const CString& fromDocumentID, const OV<CString>& continuationToken, UInt32 count) const
+//----------------------------------------------------------------------------------------------------------------------
+{
+	// Validate
+	OV<I<CMDSAssociation> >	association = mInternals->associationGet(name);
+	if (!association.hasValue())
+		return TVResult<DocumentFullInfosPage>(getUnknownAssociationError(name));
+
+	TVResult<OV<SInt64> >	afterID = Internals::getAfterID(continuationToken);
+	ReturnValueIfResultError(afterID, TVResult<DocumentFullInfosPage>(afterID.getError()));
+
+	// Collect DocumentInfos
+	TNArray<DMDocumentInfo>	documentInfos;
+	OV<SError>				error =
+									mInternals->mDatabaseManager.associationIterateDocumentInfosFrom(name,
+											fromDocumentID, (*association)->getFromDocumentType(),
+											(*association)->getToDocumentType(),
+											*afterID, count,
+											DMDocumentInfo::ProcInfo(
+													(DMDocumentInfo::ProcInfo::Proc)
+															Internals::addDocumentInfoToDocumentInfoArray,
+													&documentInfos));
+	ReturnValueIfError(error, TVResult<DocumentFullInfosPage>(*error));
+
+	// Collect CMDSDocument FullInfos
+	TNArray<CMDSDocument::FullInfo>	documentFullInfos;
+	mInternals->documentBackingsIterate((*association)->getToDocumentType(), documentInfos,
+			(CMDSSQLiteDocumentBacking::KeyProc) Internals::addDocumentInfoToDocumentFullInfoArray, &documentFullInfos);
+
+	return TVResult<DocumentFullInfosPage>(
+			DocumentFullInfosPage(documentFullInfos, Internals::getContinuationToken(documentInfos, count)));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+TVResult<CMDSDocumentStorageServer::DocumentFullInfosPage> CMDSSQLite::associationGetDocumentFullInfosPageTo(
+		const CString& name, const CString& toDocumentID, const OV<CString>& continuationToken, UInt32 count) const
+//----------------------------------------------------------------------------------------------------------------------
+{
+	// Validate
+	OV<I<CMDSAssociation> >	association = mInternals->associationGet(name);
+	if (!association.hasValue())
+		return TVResult<DocumentFullInfosPage>(getUnknownAssociationError(name));
+
+	TVResult<OV<SInt64> >	afterID = Internals::getAfterID(continuationToken);
+	ReturnValueIfResultError(afterID, TVResult<DocumentFullInfosPage>(afterID.getError()));
+
+	// Collect DocumentInfos
+	TNArray<DMDocumentInfo>	documentInfos;
+	OV<SError>				error =
+									mInternals->mDatabaseManager.associationIterateDocumentInfosTo(name,
+											toDocumentID, (*association)->getToDocumentType(),
+											(*association)->getFromDocumentType(),
+											*afterID, count,
+											DMDocumentInfo::ProcInfo(
+													(DMDocumentInfo::ProcInfo::Proc)
+															Internals::addDocumentInfoToDocumentInfoArray,
+													&documentInfos));
+	ReturnValueIfError(error, TVResult<DocumentFullInfosPage>(*error));
+
+	// Collect CMDSDocument FullInfos
+	TNArray<CMDSDocument::FullInfo>	documentFullInfos;
+	mInternals->documentBackingsIterate((*association)->getFromDocumentType(), documentInfos,
+			(CMDSSQLiteDocumentBacking::KeyProc) Internals::addDocumentInfoToDocumentFullInfoArray, &documentFullInfos);
+
+	return TVResult<DocumentFullInfosPage>(
+			DocumentFullInfosPage(documentFullInfos, Internals::getContinuationToken(documentInfos, count)));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+TVResult<CMDSDocumentStorageServer::Status> CMDSSQLite::cacheGetStatus(const CString& name) const
 //----------------------------------------------------------------------------------------------------------------------
 {
 	// Validate
 	OV<I<MDSCache> >	cache = mInternals->cacheGet(name);
 	if (!cache.hasValue())
-		return OV<SError>(getUnknownCacheError(name));
+		return TVResult<Status>(getUnknownCacheError(name));
 
-	return OV<SError>();
+	return TVResult<Status>(
+			Status(!mInternals->mViewBuilder.isBuilding(Internals::ViewBuilder::kKindCache, name),
+					(*cache)->getLastRevision(),
+					mInternals->mDatabaseManager.documentLastRevision((*cache)->getDocumentType())));
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -2658,6 +3444,9 @@ TVResult<TArray<CMDSDocument::RevisionInfo> > CMDSSQLite::collectionGetDocumentR
 	// Setup
 	OV<I<MDSCollection> >	collection = mInternals->collectionGet(name);
 
+	OV<SError>	error = mInternals->checkIsBuilt(Internals::ViewBuilder::kKindCollection, name);
+	ReturnValueIfError(error, TVResult<TArray<CMDSDocument::RevisionInfo> >(*error));
+
 	// Collect CMDSDocument RevisionInfos
 	TNArray<CMDSDocument::RevisionInfo>	documentRevisionInfos;
 	mInternals->mDatabaseManager.collectionIterateDocumentInfos(name, (*collection)->getDocumentType(), startIndex,
@@ -2677,6 +3466,9 @@ TVResult<TArray<CMDSDocument::FullInfo> > CMDSSQLite::collectionGetDocumentFullI
 	// Setup
 	OV<I<MDSCollection> >	collection = mInternals->collectionGet(name);
 
+	OV<SError>	error = mInternals->checkIsBuilt(Internals::ViewBuilder::kKindCollection, name);
+	ReturnValueIfError(error, TVResult<TArray<CMDSDocument::FullInfo> >(*error));
+
 	// Collect CMDSDocument FullInfos
 	TNArray<CMDSDocument::FullInfo>	documentFullInfos;
 	mInternals->collectionIterate(name, (*collection)->getDocumentType(), startIndex, count,
@@ -2685,6 +3477,66 @@ TVResult<TArray<CMDSDocument::FullInfo> > CMDSSQLite::collectionGetDocumentFullI
 	return TVResult<TArray<CMDSDocument::FullInfo> >(documentFullInfos);
 }
 
+//----------------------------------------------------------------------------------------------------------------------
+TVResult<CMDSDocumentStorageServer::DocumentRevisionInfosPage> CMDSSQLite::collectionGetDocumentRevisionInfosPage(
+		const CString& name, const OV<CString>& continuationToken, UInt32 count) const
+//----------------------------------------------------------------------------------------------------------------------
+{
+	// Validate
+	OV<I<MDSCollection> >	collection = mInternals->collectionGet(name);
+	if (!collection.hasValue())
+		return TVResult<DocumentRevisionInfosPage>(getUnknownCollectionError(name));
+
+	OV<SError>	error = mInternals->checkIsBuilt(Internals::ViewBuilder::kKindCollection, name);
+	ReturnValueIfError(error, TVResult<DocumentRevisionInfosPage>(*error));
+
+	TVResult<OV<SInt64> >	afterID = Internals::getAfterID(continuationToken);
+	ReturnValueIfResultError(afterID, TVResult<DocumentRevisionInfosPage>(afterID.getError()));
+
+	// Collect DocumentInfos
+	TNArray<DMDocumentInfo>	documentInfos;
+	mInternals->mDatabaseManager.collectionIterateDocumentInfos(name, (*collection)->getDocumentType(),
+			*afterID, count,
+			DMDocumentInfo::ProcInfo(
+					(DMDocumentInfo::ProcInfo::Proc) Internals::addDocumentInfoToDocumentInfoArray, &documentInfos));
+
+	return TVResult<DocumentRevisionInfosPage>(
+			DocumentRevisionInfosPage(Internals::getDocumentRevisionInfos(documentInfos),
+					Internals::getContinuationToken(documentInfos, count)));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+TVResult<CMDSDocumentStorageServer::DocumentFullInfosPage> CMDSSQLite::collectionGetDocumentFullInfosPage(
+		const CString& name, const OV<CString>& continuationToken, UInt32 count) const
+//----------------------------------------------------------------------------------------------------------------------
+{
+	// Validate
+	OV<I<MDSCollection> >	collection = mInternals->collectionGet(name);
+	if (!collection.hasValue())
+		return TVResult<DocumentFullInfosPage>(getUnknownCollectionError(name));
+
+	OV<SError>	error = mInternals->checkIsBuilt(Internals::ViewBuilder::kKindCollection, name);
+	ReturnValueIfError(error, TVResult<DocumentFullInfosPage>(*error));
+
+	TVResult<OV<SInt64> >	afterID = Internals::getAfterID(continuationToken);
+	ReturnValueIfResultError(afterID, TVResult<DocumentFullInfosPage>(afterID.getError()));
+
+	// Collect DocumentInfos
+	TNArray<DMDocumentInfo>	documentInfos;
+	mInternals->mDatabaseManager.collectionIterateDocumentInfos(name, (*collection)->getDocumentType(),
+			*afterID, count,
+			DMDocumentInfo::ProcInfo(
+					(DMDocumentInfo::ProcInfo::Proc) Internals::addDocumentInfoToDocumentInfoArray, &documentInfos));
+
+	// Collect CMDSDocument FullInfos
+	TNArray<CMDSDocument::FullInfo>	documentFullInfos;
+	mInternals->documentBackingsIterate((*collection)->getDocumentType(), documentInfos,
+			(CMDSSQLiteDocumentBacking::KeyProc) Internals::addDocumentInfoToDocumentFullInfoArray, &documentFullInfos);
+
+	return TVResult<DocumentFullInfosPage>(
+			DocumentFullInfosPage(documentFullInfos, Internals::getContinuationToken(documentInfos, count)));
+}
+
 //----------------------------------------------------------------------------------------------------------------------
 TVResult<TArray<CMDSDocument::RevisionInfo> > CMDSSQLite::documentRevisionInfos(const CString& documentType,
 		const TArray<CString>& documentIDs) const
@@ -2737,10 +3589,10 @@ TVResult<TArray<CMDSDocument::FullInfo> > CMDSSQLite::documentFullInfos(const CS
 	TNArray<CString>				documentIDsToCache;
 	for (TArray<CString>::Iterator iterator = documentIDs.getIterator(); iterator; iterator++) {
 		// Check what we have currently
-		OR<I<CMDSSQLiteDocumentBacking> >	documentBacking =
+		OV<I<CMDSSQLiteDocumentBacking> >	documentBacking =
 													mInternals->mDocumentBackingByDocumentID.getDocumentBacking(
 															*iterator);
-		if (documentBacking.hasReference())
+		if (documentBacking.hasValue())
 			// Have Document Backing in cache
 			documentFullInfos += (*documentBacking)->getDocumentFullInfo();
 		else
@@ -2785,7 +3637,7 @@ OV<SInt64> CMDSSQLite::documentIntegerValue(const CString& documentType, const I
 //----------------------------------------------------------------------------------------------------------------------
 {
 	// Check for batch
-	const	OR<I<MDSBatch> >			batch = mInternals->mBatchByThreadRef[CThread::getCurrentRefAsString()];
+	const	OR<I<MDSBatch> >			batch = mInternals->mBatchByThread.get();
 			OR<MDSBatchDocumentInfo>	batchDocumentInfo =
 												batch.hasReference() ?
 														(*batch)->documentInfoGet(document->getID()) :
@@ -2813,7 +3665,7 @@ OV<CString> CMDSSQLite::documentStringValue(const CString& documentType, const I
 //----------------------------------------------------------------------------------------------------------------------
 {
 	// Check for batch
-	const	OR<I<MDSBatch> >			batch = mInternals->mBatchByThreadRef[CThread::getCurrentRefAsString()];
+	const	OR<I<MDSBatch> >			batch = mInternals->mBatchByThread.get();
 			OR<MDSBatchDocumentInfo>	batchDocumentInfo =
 												batch.hasReference() ?
 														(*batch)->documentInfoGet(document->getID()) :
@@ -2848,22 +3700,36 @@ TVResult<TArray<CMDSDocument::FullInfo> > CMDSSQLite::documentUpdate(const CStri
 	TNArray<CMDSDocument::FullInfo>	documentFullInfos;
 	Internals::DocumentUpdateInfo	documentUpdateInfo(*mInternals, documentType, documentUpdateInfos,
 											documentFullInfos);
-	mInternals->mDatabaseManager.batch((CMDSSQLiteDatabaseManager::BatchProc) Internals::documentUpdate,
-			&documentUpdateInfo);
+	OV<SError>	error =
+						mInternals->mDatabaseManager.batch(
+								(CMDSSQLiteDatabaseManager::BatchProc) Internals::documentUpdate,
+								&documentUpdateInfo);
+	if (error.hasValue()) {
+		// Rolled back.  Document backings changed in place no longer match the database, so drop them.
+		for (TArray<CMDSDocument::UpdateInfo>::Iterator iterator = documentUpdateInfos.getIterator(); iterator;
+				iterator++)
+			// Remove
+			mInternals->mDocumentBackingByDocumentID.remove(TSArray<CString>(iterator->getDocumentID()));
+
+		return TVResult<TArray<CMDSDocument::FullInfo> >(*error);
+	}
 
 	return TVResult<TArray<CMDSDocument::FullInfo> >(documentFullInfos);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
-OV<SError> CMDSSQLite::indexGetStatus(const CString& name) const
+TVResult<CMDSDocumentStorageServer::Status> CMDSSQLite::indexGetStatus(const CString& name) const
 //----------------------------------------------------------------------------------------------------------------------
 {
 	// Validate
 	OV<I<MDSIndex> >	index = mInternals->indexGet(name);
 	if (!index.hasValue())
-		return OV<SError>(getUnknownIndexError(name));
+		return TVResult<Status>(getUnknownIndexError(name));
 
-	return OV<SError>();
+	return TVResult<Status>(
+			Status(!mInternals->mViewBuilder.isBuilding(Internals::ViewBuilder::kKindIndex, name),
+					(*index)->getLastRevision(),
+					mInternals->mDatabaseManager.documentLastRevision((*index)->getDocumentType())));
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -2876,6 +3742,9 @@ TVResult<TDictionary<CMDSDocument::RevisionInfo> > CMDSSQLite::indexGetDocumentR
 	if (!index.hasValue())
 		return TVResult<TDictionary<CMDSDocument::RevisionInfo> >(getUnknownIndexError(name));
 
+	OV<SError>	error = mInternals->checkIsBuilt(Internals::ViewBuilder::kKindIndex, name);
+	ReturnValueIfError(error, TVResult<TDictionary<CMDSDocument::RevisionInfo> >(*error));
+
 	// Compose CMDSDocument RevisionInfo map
 	TNDictionary<CMDSDocument::RevisionInfo>	documentRevisionInfoByKey;
 	mInternals->mDatabaseManager.indexIterateDocumentInfos(name, (*index)->getDocumentType(), keys,
@@ -2896,6 +3765,9 @@ TVResult<TDictionary<CMDSDocument::FullInfo> > CMDSSQLite::indexGetDocumentFullI
 	if (!index.hasValue())
 		return TVResult<TDictionary<CMDSDocument::FullInfo> >(getUnknownIndexError(name));
 
+	OV<SError>	error = mInternals->checkIsBuilt(Internals::ViewBuilder::kKindIndex, name);
+	ReturnValueIfError(error, TVResult<TDictionary<CMDSDocument::FullInfo> >(*error));
+
 	// Compose CMDSDocument FullInfo map
 	TNDictionary<CMDSDocument::FullInfo>	documentFullInfoByKey;
 	mInternals->indexIterate(name, (*index)->getDocumentType(), keys,
@@ -2904,3 +3776,28 @@ TVResult<TDictionary<CMDSDocument::FullInfo> > CMDSSQLite::indexGetDocumentFullI
 
 	return TVResult<TDictionary<CMDSDocument::FullInfo> >(documentFullInfoByKey);
 }
+
+// MARK: Instance methods
+
+//----------------------------------------------------------------------------------------------------------------------
+CMDSSQLite::DocumentBackingCacheInfo CMDSSQLite::getDocumentBackingCacheInfo() const
+//----------------------------------------------------------------------------------------------------------------------
+{
+	// Get info
+	TMDSDocumentBackingCache<I<CMDSSQLiteDocumentBacking> >::Info	info =
+																			mInternals->mDocumentBackingByDocumentID
+																					.getInfo();
+
+	return DocumentBackingCacheInfo(info.getCount(), info.getByteCount(), info.getHitCount(), info.getMissCount(),
+			info.getEvictionCount());
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+CMDSSQLite::IDCacheInfo CMDSSQLite::getIDCacheInfo() const
+//----------------------------------------------------------------------------------------------------------------------
+{
+	// Get info
+	CMDSSQLiteDatabaseManager::IDCacheInfo	info = mInternals->mDatabaseManager.getIDCacheInfo();
+
+	return IDCacheInfo(info.getCount(), info.getHitCount(), info.getMissCount(), info.getEvictionCount());
+}
@@ -11,6 +11,149 @@
 // MARK: CMDSSQLite
 
 class CMDSSQLite : public CMDSDocumentStorageServer {
+	// DurabilityMode
+	public:
+		enum DurabilityMode {
+			// Rollback journal, fsync on every commit
+			kDurabilityModeFullSync,
+
+			// Rollback journal, fsync only at critical moments
+			kDurabilityModeNormalSync,
+
+			// Write-ahead log, fsync deferred to checkpoint
+			kDurabilityModeWAL,
+		};
+
+	// PropertyMapEncoding
+	public:
+		enum PropertyMapEncoding {
+			// JSON, readable by every Mini Document Storage implementation
+			kPropertyMapEncodingJSON,
+
+			// Compact binary with typed numerics and raw data.  Existing JSON rows are still read and are converted
+			//	as they are next written.
+			kPropertyMapEncodingBinary,
+		};
+
+	// DateEncoding
+	public:
+		enum DateEncoding {
+			// Gregorian date text, readable by every Mini Document Storage implementation
+			kDateEncodingText,
+
+			// UniversalTime as REAL.  Existing document types are migrated when first opened.
+			kDateEncodingReal,
+		};
+
+	// WALCheckpointInfo
+	public:
+		struct WALCheckpointInfo {
+			// Procs
+			public:
+				typedef	void	(*ReportProc)(UniversalTimeInterval duration, UInt64 walByteCount, void* userData);
+
+			// Methods
+			public:
+										// Lifecycle methods
+										WALCheckpointInfo(UInt32 pageCountTrigger = 1000,
+												UniversalTimeInterval idleTimeTrigger = 5.0,
+												ReportProc reportProc = nil, void* reportProcUserData = nil) :
+											mPageCountTrigger(pageCountTrigger), mIdleTimeTrigger(idleTimeTrigger),
+													mReportProc(reportProc), mReportProcUserData(reportProcUserData)
+											{}
+										WALCheckpointInfo(const WALCheckpointInfo& other) :
+											mPageCountTrigger(other.mPageCountTrigger),
+													mIdleTimeTrigger(other.mIdleTimeTrigger),
+													mReportProc(other.mReportProc),
+													mReportProcUserData(other.mReportProcUserData)
+											{}
+
+										// Instance methods
+				UInt32					getPageCountTrigger() const
+											{ return mPageCountTrigger; }
+				UniversalTimeInterval	getIdleTimeTrigger() const
+											{ return mIdleTimeTrigger; }
+				void					report(UniversalTimeInterval duration, UInt64 walByteCount) const
+											{ if (mReportProc != nil)
+												mReportProc(duration, walByteCount, mReportProcUserData); }
+
+			// Properties
+			private:
+				UInt32					mPageCountTrigger;
+				UniversalTimeInterval	mIdleTimeTrigger;
+				ReportProc				mReportProc;
+				void*					mReportProcUserData;
+		};
+
+	// DocumentBackingCacheInfo
+	public:
+		struct DocumentBackingCacheInfo {
+			// Methods
+			public:
+						// Lifecycle methods
+						DocumentBackingCacheInfo(UInt32 count, UInt64 byteCount, UInt64 hitCount, UInt64 missCount,
+								UInt64 evictionCount) :
+							mCount(count), mByteCount(byteCount), mHitCount(hitCount), mMissCount(missCount),
+									mEvictionCount(evictionCount)
+							{}
+						DocumentBackingCacheInfo(const DocumentBackingCacheInfo& other) :
+							mCount(other.mCount), mByteCount(other.mByteCount), mHitCount(other.mHitCount),
+									mMissCount(other.mMissCount), mEvictionCount(other.mEvictionCount)
+							{}
+
+						// Instance methods
+				UInt32	getCount() const
+							{ return mCount; }
+				UInt64	getByteCount() const
+							{ return mByteCount; }
+				UInt64	getHitCount() const
+							{ return mHitCount; }
+				UInt64	getMissCount() const
+							{ return mMissCount; }
+				UInt64	getEvictionCount() const
+							{ return mEvictionCount; }
+
+			// Properties
+			private:
+				UInt32	mCount;
+				UInt64	mByteCount;
+				UInt64	mHitCount;
+				UInt64	mMissCount;
+				UInt64	mEvictionCount;
+		};
+
+	// IDCacheInfo
+	public:
+		struct IDCacheInfo {
+			// Methods
+			public:
+						// Lifecycle methods
+						IDCacheInfo(UInt32 count, UInt64 hitCount, UInt64 missCount, UInt64 evictionCount) :
+							mCount(count), mHitCount(hitCount), mMissCount(missCount), mEvictionCount(evictionCount)
+							{}
+						IDCacheInfo(const IDCacheInfo& other) :
+							mCount(other.mCount), mHitCount(other.mHitCount), mMissCount(other.mMissCount),
+									mEvictionCount(other.mEvictionCount)
+							{}
+
+						// Instance methods
+				UInt32	getCount() const
+							{ return mCount; }
+				UInt64	getHitCount() const
+							{ return mHitCount; }
+				UInt64	getMissCount() const
+							{ return mMissCount; }
+				UInt64	getEvictionCount() const
+							{ return mEvictionCount; }
+
+			// Properties
+			private:
+				UInt32	mCount;
+				UInt64	mHitCount;
+				UInt64	mMissCount;
+				UInt64	mEvictionCount;
+		};
+
 	// Classes
 	private:
 		class Internals;
@@ -19,7 +162,17 @@ class CMDSSQLite : public CMDSDocumentStorageServer {
 	public:
 													// Lifecycle methods
 													CMDSSQLite(const CFolder& folder,
-															const CString& name = CString(OSSTR("database")));
+															const CString& name = CString(OSSTR("database")),
+															DurabilityMode durabilityMode =
+																	kDurabilityModeFullSync,
+															const OV<WALCheckpointInfo>& walCheckpointInfo =
+																	OV<WALCheckpointInfo>(),
+															PropertyMapEncoding propertyMapEncoding =
+																	kPropertyMapEncodingJSON,
+															DateEncoding dateEncoding = kDateEncodingText,
+															UInt32 documentBackingCacheLimit = 1000000,
+															const OV<UInt64>& documentBackingCacheByteLimit =
+																	OV<UInt64>());
 													~CMDSSQLite();
 
 													// CMDSDocumentStorage methods
@@ -73,19 +226,19 @@ class CMDSSQLite : public CMDSDocumentStorageServer {
 															bool activeOnly, CMDSDocument::Proc proc,
 															void* procUserData) const;
 
-		UniversalTime								documentCreationUniversalTime(const I<CMDSDocument>& document)
+		UniversalTime								documentCreationUniversalTime(const CMDSDocument& document)
 															const;
-		UniversalTime								documentModificationUniversalTime(const I<CMDSDocument>& document)
+		UniversalTime								documentModificationUniversalTime(const CMDSDocument& document)
 															const;
 
 		OV<SValue>									documentValue(const CString& property,
-															const I<CMDSDocument>& document) const;
+															const CMDSDocument& document) const;
 		OV<CData>									documentData(const CString& property,
-															const I<CMDSDocument>& document) const;
+															const CMDSDocument& document) const;
 		OV<UniversalTime>							documentUniversalTime(const CString& property,
-															const I<CMDSDocument>& document) const;
+															const CMDSDocument& document) const;
 		void										documentSet(const CString& property, const OV<SValue>& value,
-															const I<CMDSDocument>& document,
+															const CMDSDocument& document,
 															SetValueKind setValueKind = kSetValueKindNothingSpecial);
 
 		DocumentAttachmentInfoResult				documentAttachmentAdd(const CString& documentType,
@@ -102,7 +255,7 @@ class CMDSSQLite : public CMDSDocumentStorageServer {
 		OV<SError>									documentAttachmentRemove(const CString& documentType,
 															const CString& documentID, const CString& attachmentID);
 
-		OV<SError>									documentRemove(const I<CMDSDocument>& document);
+		OV<SError>									documentRemove(const CMDSDocument& document);
 
 		OV<SError>									indexRegister(const CString& name, const CString& documentType,
 															const TArray<CString>& relevantProperties,
@@ -135,13 +288,29 @@ class CMDSSQLite : public CMDSDocumentStorageServer {
 		DocumentFullInfosWithTotalCountResult		associationGetDocumentFullInfosTo(const CString& name,
 															const CString& toDocumentID, UInt32 startIndex,
 															const OV<UInt32>& count) const;
+		DocumentRevisionInfosPageResult				associationGetDocumentRevisionInfosPageFrom(const CString& name,
+															const CString& fromDocumentID,
+															const OV<CString>& continuationToken, UInt32 count) const;
+		DocumentRevisionInfosPageResult				associationGetDocumentRevisionInfosPageTo(const CString& name,
+															const CString& toDocumentID,
+															const OV<CString>& continuationToken, UInt32 count) const;
+		DocumentFullInfosPageResult					associationGetDocumentFullInfosPageFrom(const CString& name,
+															const CString& fromDocumentID,
+															const OV<CString>& continuationToken, UInt32 count) const;
+		DocumentFullInfosPageResult					associationGetDocumentFullInfosPageTo(const CString& name,
+															const CString& toDocumentID,
+															const OV<CString>& continuationToken, UInt32 count) const;
 
-		OV<SError>									cacheGetStatus(const CString& name) const;
+		StatusResult								cacheGetStatus(const CString& name) const;
 
 		DocumentRevisionInfosResult					collectionGetDocumentRevisionInfos(const CString& name,
 															UInt32 startIndex, const OV<UInt32>& count) const;
 		DocumentFullInfosResult						collectionGetDocumentFullInfos(const CString& name,
 															UInt32 startIndex, const OV<UInt32>& count) const;
+		DocumentRevisionInfosPageResult				collectionGetDocumentRevisionInfosPage(const CString& name,
+															const OV<CString>& continuationToken, UInt32 count) const;
+		DocumentFullInfosPageResult					collectionGetDocumentFullInfosPage(const CString& name,
+															const OV<CString>& continuationToken, UInt32 count) const;
 
 		DocumentRevisionInfosResult					documentRevisionInfos(const CString& documentType,
 															const TArray<CString>& documentIDs) const;
@@ -162,12 +331,16 @@ class CMDSSQLite : public CMDSDocumentStorageServer {
 															const TArray<CMDSDocument::UpdateInfo>&
 																	documentUpdateInfos);
 
-		OV<SError>									indexGetStatus(const CString& name) const;
+		StatusResult								indexGetStatus(const CString& name) const;
 		DocumentRevisionInfoDictionaryResult		indexGetDocumentRevisionInfos(const CString& name,
 															const TArray<CString>& keys) const;
 		DocumentFullInfoDictionaryResult			indexGetDocumentFullInfos(const CString& name,
 															const TArray<CString>& keys) const;
 
+													// Instance methods
+		DocumentBackingCacheInfo					getDocumentBackingCacheInfo() const;
+		IDCacheInfo									getIDCacheInfo() const;
+
 	// Properties
 	private:
 		Internals*	mInternals;
@@ -6,9 +6,15 @@
 
 #include "CJSON.h"
 #include "CMDSDocumentStorage.h"
+#include "ConcurrencyPrimitives.h"
 #include "CThread.h"
 #include "TLockingDictionary.h"
+#include "TMDSBatch.h"
 #include "TMDSCollection.h"
+#include "TMDSDocumentBackingCache.h"
+
+#include <atomic>
+#include <cstring>
 
 /*
 	See https://docs.google.com/document/d/1zgMAzYLemHA05F_FR4QZP_dn51cYcVfKMcUfai60FXE for overview
@@ -17,7 +23,8 @@
 		Associations table
 			Columns:
 		Association-{ASSOCIATIONNAME}
-			Columns:
+			Columns: fromID, toID
+			Indexes: (fromID, toID), (toID, fromID)
 
 		Caches table
 			Columns:
@@ -25,16 +32,23 @@
 			Columns:
 
 		Collections table
-			Columns: name, version, lastRevision
+			Columns: name, version, lastRevision, documentCount
+			Version 3: documentCount maintained as Collection-{COLLECTIONNAME} is updated
 		Collection-{COLLECTIONNAME}
 			Columns: id
 
 		Documents table
-			Columns: type, lastRevision
+			Columns: type, lastRevision, documentCount
+			Version 2: documentCount maintained as documents are created
 		{DOCUMENTTYPE}s
-			Columns: id, documentID, revision
+			Columns: id, documentID, revision, active
+			Indexes: (revision, active)
 		{DOCUMENTTYPE}Contents
 			Columns: id, creationDate, modificationDate, json
+			Indexes: (modificationDate)
+			Version 2: json may hold either a JSON or a binary property map (see CPropertyMapCoder)
+			Version 3: creationDate and modificationDate hold UniversalTime as REAL instead of Gregorian date text.
+				Only used when opted in with CMDSSQLite::kDateEncodingReal.
 		{DOCUMENTTYPE}Attachments
 			Columns:
 
@@ -74,6 +88,9 @@ typedef	TArray<SSQLiteValue>							SQLiteValues;
 typedef	TNKeyConvertibleDictionary<SInt64, CDictionary>	ValueInfoByID;
 typedef	CMDSSQLiteDatabaseManager::IDArray				IDArray;
 
+typedef	CMDSSQLiteDatabaseManager::DocumentAttachmentInfoByIDByID
+														DocumentAttachmentInfoByIDByID;
+
 typedef	TVResult<TArray<TableColumnAndValue> >			TableColumnAndValuesResult;
 
 typedef	TMDSIndex<SInt64>								Index;
@@ -210,6 +227,155 @@ CSQLiteTableColumn	CInternalsTable::mValueTableColumn(CString(OSSTR("value")), C
 							CSQLiteTableColumn::kOptionsNotNull);
 CSQLiteTableColumn	CInternalsTable::mTableColumns[] = {mKeyTableColumn, mValueTableColumn};
 
+//----------------------------------------------------------------------------------------------------------------------
+//----------------------------------------------------------------------------------------------------------------------
+// MARK: - CMultiRowStatement
+
+// Writes many rows with each statement instead of one.  Each row is a group of placeholders and its values are bound,
+//	row after row, so each statement binds no more values than the variable number limit.
+class CMultiRowStatement {
+	public:
+		static	OV<SError>	insertOrIgnoreRows(CSQLiteDatabase& database, const CSQLiteTable& table,
+									const TArray<CSQLiteTableColumn>& tableColumns, const SQLiteValues& values)
+								{ return insertRows(database, CString(OSSTR("INSERT OR IGNORE")), table, tableColumns,
+										values); }
+		static	OV<SError>	insertOrReplaceRows(CSQLiteDatabase& database, const CSQLiteTable& table,
+									const TArray<CSQLiteTableColumn>& tableColumns, const SQLiteValues& values)
+								{ return insertRows(database, CString(OSSTR("INSERT OR REPLACE")), table, tableColumns,
+										values); }
+		static	OV<SError>	deleteRows(CSQLiteDatabase& database, const CSQLiteTable& table,
+									const TArray<CSQLiteTableColumn>& tableColumns, const SQLiteValues& values)
+								{
+									// Delete rows matching all columns
+									return perform(database,
+											CString(OSSTR("DELETE FROM \"")) + table.getName() +
+													CString(OSSTR("\" WHERE (")) + columnNames(tableColumns) +
+													CString(OSSTR(") IN (VALUES ")),
+											CString(OSSTR(")")), table, tableColumns.getCount(), values);
+								}
+		static	void		deleteRows(CSQLiteTable& table, const CSQLiteTableColumn& tableColumn,
+									const SQLiteValues& values)
+								{
+									// Delete in chunks that fit within the variable number limit
+									UInt32	variableNumberLimit = table.getVariableNumberLimit();
+									for (UInt32 startIndex = 0; startIndex < values.getCount();
+											startIndex += variableNumberLimit)
+										// Delete
+										table.deleteRows(tableColumn,
+												chunk(values, startIndex, variableNumberLimit));
+								}
+		static	void		insertOrReplaceRows(CSQLiteTable& table, const CSQLiteTableColumn& tableColumn,
+									const SQLiteValues& values)
+								{
+									// Insert in chunks that fit within the variable number limit
+									UInt32	variableNumberLimit = table.getVariableNumberLimit();
+									for (UInt32 startIndex = 0; startIndex < values.getCount();
+											startIndex += variableNumberLimit)
+										// Insert or replace
+										table.insertOrReplaceRows(tableColumn,
+												chunk(values, startIndex, variableNumberLimit));
+								}
+		static	UInt32		count(CSQLiteTable& table, const CSQLiteTableColumn& tableColumn,
+									const SQLiteValues& values)
+								{
+									// Count in chunks that fit within the variable number limit
+									UInt32	variableNumberLimit = table.getVariableNumberLimit();
+									UInt32	count = 0;
+									for (UInt32 startIndex = 0; startIndex < values.getCount();
+											startIndex += variableNumberLimit)
+										// Count
+										count +=
+												table.count(
+														CSQLiteWhere(tableColumn,
+																chunk(values, startIndex, variableNumberLimit)));
+
+									return count;
+								}
+
+	private:
+		static	OV<SError>	insertRows(CSQLiteDatabase& database, const CString& insert, const CSQLiteTable& table,
+									const TArray<CSQLiteTableColumn>& tableColumns, const SQLiteValues& values)
+								{
+									// Insert rows
+									return perform(database,
+											insert + CString(OSSTR(" INTO \"")) + table.getName() +
+													CString(OSSTR("\" (")) + columnNames(tableColumns) +
+													CString(OSSTR(") VALUES ")),
+											CString::mEmpty, table, tableColumns.getCount(), values);
+								}
+		static	OV<SError>	perform(CSQLiteDatabase& database, const CString& prefix, const CString& suffix,
+									const CSQLiteTable& table, UInt32 columnCount, const SQLiteValues& values)
+								{
+									// Setup.  Values are given row after row.
+									UInt32	rowCount = values.getCount() / columnCount;
+									UInt32	rowsPerStatement = table.getVariableNumberLimit() / columnCount;
+									if (rowsPerStatement == 0)
+										// At least one
+										rowsPerStatement = 1;
+
+									// Perform in chunks.  All chunks but the last have the same statement.
+									CString	statement;
+									for (UInt32 startRow = 0; startRow < rowCount; startRow += rowsPerStatement) {
+										// Check if need to compose statement
+										UInt32	chunkRowCount = std::min<UInt32>(rowsPerStatement, rowCount - startRow);
+										if ((startRow == 0) || (chunkRowCount < rowsPerStatement))
+											// Compose statement
+											statement = prefix + rows(chunkRowCount, columnCount) + suffix;
+
+										// Execute
+										OV<SError>	error =
+															database.execute(statement,
+																	chunk(values, startRow * columnCount,
+																			chunkRowCount * columnCount));
+										ReturnErrorIfError(error);
+									}
+
+									return OV<SError>();
+								}
+		static	CString		columnNames(const TArray<CSQLiteTableColumn>& tableColumns)
+								{
+									// Compose column names
+									TNArray<CString>	names;
+									for (TArray<CSQLiteTableColumn>::Iterator iterator = tableColumns.getIterator();
+											iterator; iterator++)
+										// Add
+										names += CString(OSSTR("\"")) + iterator->getName() + CString(OSSTR("\""));
+
+									return CString(names, CString(OSSTR(", ")));
+								}
+		static	CString		rows(UInt32 rowCount, UInt32 columnCount)
+								{
+									// Compose a row of placeholders
+									TNArray<CString>	placeholders;
+									for (UInt32 i = 0; i < columnCount; i++)
+										// Add
+										placeholders += CString(OSSTR("?"));
+									CString	row =
+													CString(OSSTR("(")) +
+															CString(placeholders, CString(OSSTR(", "))) +
+															CString(OSSTR(")"));
+
+									// Compose rows
+									TNArray<CString>	rows;
+									for (UInt32 i = 0; i < rowCount; i++)
+										// Add
+										rows += row;
+
+									return CString(rows, CString(OSSTR(", ")));
+								}
+		static	TNArray<SSQLiteValue>	chunk(const SQLiteValues& values, UInt32 startIndex, UInt32 count)
+											{
+												// Compose chunk
+												TNArray<SSQLiteValue>	chunkValues;
+												for (UInt32 i = startIndex;
+														(i < values.getCount()) && (i < (startIndex + count)); i++)
+													// Add
+													chunkValues += values[i];
+
+												return chunkValues;
+											}
+};
+
 //----------------------------------------------------------------------------------------------------------------------
 //----------------------------------------------------------------------------------------------------------------------
 // MARK: - CAssociationsTable
@@ -338,14 +504,21 @@ class CAssociationContentsTable {
 																		CString(OSSTR("Association-")) + name,
 																		TSArray<CSQLiteTableColumn>(mTableColumns, 2));
 
-										// Check if need to create
+										// Check if need to create/migrate
 										OV<UInt32>	version = CInternalsTable::getVersion(table, internalsTable);
 										if (!version.hasValue()) {
 											// Create
 											table.create();
+											createIndexes(database, table);
 
 											// Store version
-											CInternalsTable::set(1, table, internalsTable);
+											CInternalsTable::set(2, table, internalsTable);
+										} else if (*version == 1) {
+											// Migrate to version 2
+											createIndexes(database, table);
+
+											// Store version
+											CInternalsTable::set(2, table, internalsTable);
 										}
 
 										return table;
@@ -370,34 +543,39 @@ class CAssociationContentsTable {
 
 										return items;
 									}
-		static	void			add(const TArray<Item>& items, CSQLiteTable& table)
+		static	OV<SError>		add(const TArray<Item>& items, CSQLiteDatabase& database, CSQLiteTable& table)
+									{ return CMultiRowStatement::insertOrReplaceRows(database, table,
+											TSArray<CSQLiteTableColumn>(mTableColumns, 2), getValues(items)); }
+		static	OV<SError>		remove(const TArray<Item>& items, CSQLiteDatabase& database, CSQLiteTable& table)
+									{ return CMultiRowStatement::deleteRows(database, table,
+											TSArray<CSQLiteTableColumn>(mTableColumns, 2), getValues(items)); }
+
+	private:
+		static	SQLiteValues	getValues(const TArray<Item>& items)
 									{
-										// Iterate items
+										// Compose values, row after row
+										TNArray<SSQLiteValue>	values;
 										for (TArray<Item>::Iterator iterator = items.getIterator(); iterator;
 												iterator++) {
-											// Insert
-											TableColumnAndValue	tableColumnAndValues[] =
-																		{
-																			TableColumnAndValue(mFromIDTableColumn,
-																					iterator->getFromID()),
-																			TableColumnAndValue(mToIDTableColumn,
-																					iterator->getToID()),
-																		};
-											table.insertOrReplaceRow(
-													TSARRAY_FROM_C_ARRAY(TableColumnAndValue, tableColumnAndValues));
+											// Add row
+											values += SSQLiteValue(iterator->getFromID());
+											values += SSQLiteValue(iterator->getToID());
 										}
+
+										return values;
 									}
-		static	void			remove(const TArray<Item>& items, CSQLiteTable& table)
+		static	void			createIndexes(CSQLiteDatabase& database, const CSQLiteTable& table)
 									{
-										// Iterate items
-										for (TArray<Item>::Iterator iterator = items.getIterator(); iterator;
-												iterator++)
-											// Delete
-											table.deleteRow(
-													CSQLiteWhere(mFromIDTableColumn,
-																	SSQLiteValue(iterator->getFromID()))
-															.addAnd(mToIDTableColumn,
-																	SSQLiteValue(iterator->getToID())));
+										// Create covering indexes for each direction so lookups, counts, and
+										//	paging by either ID are index-only
+										database.execute(
+												CString(OSSTR("CREATE INDEX IF NOT EXISTS \"")) + table.getName() +
+														CString(OSSTR("-fromID\" ON \"")) + table.getName() +
+														CString(OSSTR("\" (fromID, toID)")));
+										database.execute(
+												CString(OSSTR("CREATE INDEX IF NOT EXISTS \"")) + table.getName() +
+														CString(OSSTR("-toID\" ON \"")) + table.getName() +
+														CString(OSSTR("\" (toID, fromID)")));
 									}
 
 	public:
@@ -586,39 +764,153 @@ class CCacheContentsTable {
 
 										return table;
 									}
-		static	void			update(const OV<CMDSSQLiteDatabaseManager::ValueInfoByID>& valueInfoByID,
-										const IDArray& removedIDs, CSQLiteTable& table)
+		static	OV<SError>		update(const OV<CMDSSQLiteDatabaseManager::ValueInfoByID>& valueInfoByID,
+										const IDArray& removedIDs, CSQLiteDatabase& database, CSQLiteTable& table)
 									{
 										// Update
 										if (!removedIDs.isEmpty())
 											// Remove IDs
-											table.deleteRows(mIDTableColumn, SSQLiteValue::valuesFrom(removedIDs));
+											CMultiRowStatement::deleteRows(table, mIDTableColumn,
+													SSQLiteValue::valuesFrom(removedIDs));
 
 										// Check if have updates
-										if (valueInfoByID.hasValue() && !valueInfoByID->isEmpty()) {
-											// Update
-											for (CMDSSQLiteDatabaseManager::ValueInfoByID::Iterator
-															valueInfoByIDIterator = valueInfoByID->getIterator();
-													valueInfoByIDIterator; valueInfoByIDIterator++) {
-												// Compose table columns
-												TNArray<TableColumnAndValue>	tableColumnAndValues;
-												tableColumnAndValues +=
-														TableColumnAndValue(mIDTableColumn,
-																valueInfoByIDIterator.getKey());
+										if (!valueInfoByID.hasValue() || valueInfoByID->isEmpty())
+											return OV<SError>();
 
+										// Compose values.  All rows for a cache have the same values, so the first
+										//	row decides the columns.
+										bool							haveTableColumns = false;
+										TNArray<CString>				valueNames;
+										TNArray<CSQLiteTableColumn>		tableColumns(mIDTableColumn);
+										TNArray<SSQLiteValue>			values;
+										for (CMDSSQLiteDatabaseManager::ValueInfoByID::Iterator
+														valueInfoByIDIterator = valueInfoByID->getIterator();
+												valueInfoByIDIterator; valueInfoByIDIterator++) {
+											// Setup
+											const	CDictionary&	valueInfo = valueInfoByIDIterator.getValue();
+											if (!haveTableColumns) {
+												// Use these columns
 												for (CDictionary::Iterator valueInfoIterator =
-																valueInfoByIDIterator.getValue().getIterator();
-														valueInfoIterator; valueInfoIterator++)
+																valueInfo.getIterator();
+														valueInfoIterator; valueInfoIterator++) {
 													// Add
-													tableColumnAndValues +=
-															TableColumnAndValue(
-																	table.getTableColumn(valueInfoIterator.getKey()),
-																	valueInfoIterator.getValue());
+													valueNames += valueInfoIterator.getKey();
+													tableColumns +=
+															table.getTableColumn(valueInfoIterator.getKey());
+												}
+												haveTableColumns = true;
+											}
+
+											// Compose row
+											TNArray<SSQLiteValue>	rowValues;
+											rowValues += SSQLiteValue(valueInfoByIDIterator.getKey());
+											if (valueInfo.getKeyCount() == valueNames.getCount())
+												// Add each value
+												for (TArray<CString>::Iterator iterator = valueNames.getIterator();
+														iterator; iterator++) {
+													// Get value
+													OV<SValue>			value = valueInfo.getOValue(*iterator);
+													OV<SSQLiteValue>	sqliteValue =
+																				value.hasValue() ?
+																						getSQLiteValue(*value) :
+																						OV<SSQLiteValue>();
+													if (!sqliteValue.hasValue())
+														break;
+													rowValues += *sqliteValue;
+												}
 
-												// Insert or replace row for this id
-												table.insertOrReplaceRow(tableColumnAndValues);
+											// Check if have all values
+											if (rowValues.getCount() == tableColumns.getCount())
+												// Add row
+												values += rowValues;
+											else {
+												// Insert or replace row for this id on its own
+												OV<SError>	error =
+																	insertOrReplaceRow(valueInfoByIDIterator.getKey(),
+																			valueInfo, database, table);
+												ReturnErrorIfError(error);
 											}
 										}
+
+										// Insert or replace rows
+										return CMultiRowStatement::insertOrReplaceRows(database, table, tableColumns,
+												values);
+									}
+
+	private:
+		static	OV<SSQLiteValue>	getSQLiteValue(const SValue& value)
+										{
+											// Check type
+											switch (value.getType()) {
+												case SValue::kTypeBool:
+													// Bool
+													return OV<SSQLiteValue>(
+															SSQLiteValue((SInt64) (value.getBool() ? 1 : 0)));
+
+												case SValue::kTypeSInt32:
+													// SInt32
+													return OV<SSQLiteValue>(SSQLiteValue((SInt64) value.getSInt32()));
+
+												case SValue::kTypeSInt64:
+													// SInt64
+													return OV<SSQLiteValue>(SSQLiteValue(value.getSInt64()));
+
+												case SValue::kTypeUInt8:
+													// UInt8
+													return OV<SSQLiteValue>(SSQLiteValue((SInt64) value.getUInt8()));
+
+												case SValue::kTypeUInt16:
+													// UInt16
+													return OV<SSQLiteValue>(SSQLiteValue((SInt64) value.getUInt16()));
+
+												case SValue::kTypeUInt32:
+													// UInt32
+													return OV<SSQLiteValue>(SSQLiteValue((SInt64) value.getUInt32()));
+
+												default:
+													// Not bound here (including UInt64, which may not fit)
+													return OV<SSQLiteValue>();
+											}
+										}
+		static	OV<SError>		insertOrReplaceRow(SInt64 id, const CDictionary& valueInfo,
+										CSQLiteDatabase& database, CSQLiteTable& table)
+									{
+										// Compose table columns and values
+										TNArray<CSQLiteTableColumn>		tableColumns(mIDTableColumn);
+										TNArray<SSQLiteValue>			values;
+										TNArray<TableColumnAndValue>	tableColumnAndValues;
+										bool							canBindAll = true;
+										values += SSQLiteValue(id);
+										tableColumnAndValues += TableColumnAndValue(mIDTableColumn, id);
+										for (CDictionary::Iterator iterator = valueInfo.getIterator(); iterator;
+												iterator++) {
+											// Add
+											const	CSQLiteTableColumn&	tableColumn =
+																				table.getTableColumn(iterator.getKey());
+													OV<SSQLiteValue>	sqliteValue =
+																				getSQLiteValue(iterator.getValue());
+											tableColumns += tableColumn;
+											if (sqliteValue.hasValue())
+												// Can bind
+												values += *sqliteValue;
+											else
+												// Can't bind
+												canBindAll = false;
+											tableColumnAndValues +=
+													TableColumnAndValue(tableColumn, iterator.getValue());
+										}
+
+										// Check if can bind all values
+										if (canBindAll)
+											// Insert or replace row so any error is reported
+											return CMultiRowStatement::insertOrReplaceRows(database, table,
+													tableColumns, values);
+
+										// Insert or replace row through the table, which converts values itself but
+										//	does not report errors
+										table.insertOrReplaceRow(tableColumnAndValues);
+
+										return OV<SError>();
 									}
 
 	public:
@@ -643,7 +935,7 @@ class CCollectionsTable {
 																			database.getTable(
 																					CString(OSSTR("Collections")),
 																					TSArray<CSQLiteTableColumn>(
-																							mTableColumns, 6));
+																							mTableColumns, 7));
 
 													// Check if need to create/migrate
 													OV<UInt32>	version =
@@ -659,13 +951,23 @@ class CCollectionsTable {
 														table.create();
 
 														// Store version
-														CInternalsTable::set(2, table, internalsTable);
+														CInternalsTable::set(3, table, internalsTable);
 													} else if (*version == 1) {
-														// Migrate to version 2
+														// Migrate to version 3
 														table.migrate((CSQLiteTable::ResultsRowMigrationProc) migrate);
 
 														// Store version
-														CInternalsTable::set(2, table, internalsTable);
+														CInternalsTable::set(3, table, internalsTable);
+													} else if (*version == 2) {
+														// Migrate to version 3.  Counts are left NULL and computed
+														//	once when each collection is next loaded.
+														database.execute(
+																CString(OSSTR("ALTER TABLE \"")) + table.getName() +
+																		CString(OSSTR(
+																				"\" ADD COLUMN documentCount INTEGER")));
+
+														// Store version
+														CInternalsTable::set(3, table, internalsTable);
 													}
 
 													return table;
@@ -687,6 +989,18 @@ class CCollectionsTable {
 
 													return collectionInfo;
 												}
+		static	OV<UInt32>					getDocumentCount(const CString& name, CSQLiteTable& table)
+												{
+													// Query
+													CSQLiteTableColumn	tableColumns[] = { mDocumentCountTableColumn };
+													OV<UInt32>			documentCount;
+													table.select(TSARRAY_FROM_C_ARRAY(CSQLiteTableColumn, tableColumns),
+															CSQLiteWhere(mNameTableColumn, SSQLiteValue(name)),
+															(CSQLiteResultsRow::Proc) processDocumentCountResultsRow,
+															&documentCount);
+
+													return documentCount;
+												}
 		static	void						addOrUpdate(const CString& name, const CString& documentType,
 													const TArray<CString>& relevantProperties,
 													const CString& isIncludedSelector,
@@ -715,15 +1029,32 @@ class CCollectionsTable {
 																					TableColumnAndValue(
 																							mLastRevisionTableColumn,
 																							lastRevision),
+																					TableColumnAndValue(
+																							mDocumentCountTableColumn,
+																							(UInt32) 0),
 																				};
 													table.insertOrReplaceRow(
 															TSARRAY_FROM_C_ARRAY(TableColumnAndValue,
 																	tableColumnAndValues));
 												}
-		static	void						update(const CString& name, UInt32 lastRevision, CSQLiteTable& table)
-												{ table.update(
-														TableColumnAndValue(mLastRevisionTableColumn, lastRevision),
-														CSQLiteWhere(mNameTableColumn, SSQLiteValue(name))); }
+		static	void						update(const CString& name, const OV<UInt32>& lastRevision,
+													UInt32 documentCount, CSQLiteTable& table)
+												{
+													// Setup
+													TNArray<TableColumnAndValue>	tableColumnAndValues;
+													if (lastRevision.hasValue())
+														// Add last revision
+														tableColumnAndValues +=
+																TableColumnAndValue(mLastRevisionTableColumn,
+																		*lastRevision);
+													tableColumnAndValues +=
+															TableColumnAndValue(mDocumentCountTableColumn,
+																	documentCount);
+
+													// Update
+													table.update(tableColumnAndValues,
+															CSQLiteWhere(mNameTableColumn, SSQLiteValue(name)));
+												}
 
 		static	OV<SError>					processCollectionInfoResultsRow(const CSQLiteResultsRow& resultsRow,
 													OV<CollectionInfo>* collectionInfo)
@@ -750,6 +1081,14 @@ class CCollectionsTable {
 
 													return OV<SError>();
 												}
+		static	OV<SError>					processDocumentCountResultsRow(const CSQLiteResultsRow& resultsRow,
+													OV<UInt32>* documentCount)
+												{
+													// Process results
+													*documentCount = resultsRow.getUInt32(mDocumentCountTableColumn);
+
+													return OV<SError>();
+												}
 
 	private:
 		static	TableColumnAndValuesResult	migrate(const CSQLiteResultsRow& resultsRow, void* userData)
@@ -791,6 +1130,7 @@ class CCollectionsTable {
 		static	CSQLiteTableColumn	mIsIncludedSelectorTableColumn;
 		static	CSQLiteTableColumn	mIsIncludedSelectorInfoTableColumn;
 		static	CSQLiteTableColumn	mLastRevisionTableColumn;
+		static	CSQLiteTableColumn	mDocumentCountTableColumn;
 		static	CSQLiteTableColumn	mTableColumns[];
 
 		static	CSQLiteTableColumn	mVersionTableColumn;
@@ -809,10 +1149,12 @@ CSQLiteTableColumn	CCollectionsTable::mIsIncludedSelectorInfoTableColumn(CString
 							CSQLiteTableColumn::kKindBlob, CSQLiteTableColumn::kOptionsNotNull);
 CSQLiteTableColumn	CCollectionsTable::mLastRevisionTableColumn(CString(OSSTR("lastRevision")),
 							CSQLiteTableColumn::kKindInteger, CSQLiteTableColumn::kOptionsNotNull);
+CSQLiteTableColumn	CCollectionsTable::mDocumentCountTableColumn(CString(OSSTR("documentCount")),
+							CSQLiteTableColumn::kKindInteger, CSQLiteTableColumn::kOptionsNone);
 CSQLiteTableColumn	CCollectionsTable::mTableColumns[] =
 							{mNameTableColumn, mTypeTableColumn, mRelevantPropertiesTableColumn,
 									mIsIncludedSelectorTableColumn, mIsIncludedSelectorInfoTableColumn,
-									mLastRevisionTableColumn};
+									mLastRevisionTableColumn, mDocumentCountTableColumn};
 
 CSQLiteTableColumn	CCollectionsTable::mVersionTableColumn(CString(OSSTR("version")), CSQLiteTableColumn::kKindInteger,
 							CSQLiteTableColumn::kOptionsNotNull);
@@ -843,17 +1185,32 @@ class CCollectionContentsTable {
 
 										return table;
 									}
-		static	void			update(const OV<IDArray >& includedIDs, const OV<IDArray >& notIncludedIDs,
+		static	SInt32			update(const OV<IDArray >& includedIDs, const OV<IDArray >& notIncludedIDs,
 										CSQLiteTable& table)
 									{
-										// Update
-										if (notIncludedIDs.hasValue() && !notIncludedIDs->isEmpty())
+										// Setup
+										SInt32	documentCountDelta = 0;
+
+										// Update.  Only IDs that are actually present (or absent) change the count, and
+										//	those are found with primary key lookups.
+										if (notIncludedIDs.hasValue() && !notIncludedIDs->isEmpty()) {
 											// Delete
-											table.deleteRows(mIDTableColumn, SSQLiteValue::valuesFrom(*notIncludedIDs));
-										if (includedIDs.hasValue() && !includedIDs->isEmpty())
+											TArray<SSQLiteValue>	values = SSQLiteValue::valuesFrom(*notIncludedIDs);
+											documentCountDelta -=
+													(SInt32) CMultiRowStatement::count(table, mIDTableColumn, values);
+											CMultiRowStatement::deleteRows(table, mIDTableColumn, values);
+										}
+										if (includedIDs.hasValue() && !includedIDs->isEmpty()) {
 											// Update
-											table.insertOrReplaceRows(mIDTableColumn,
-													SSQLiteValue::valuesFrom(*includedIDs));
+											TArray<SSQLiteValue>	values = SSQLiteValue::valuesFrom(*includedIDs);
+											documentCountDelta +=
+													(SInt32) includedIDs->getCount() -
+															(SInt32) CMultiRowStatement::count(table, mIDTableColumn,
+																	values);
+											CMultiRowStatement::insertOrReplaceRows(table, mIDTableColumn, values);
+										}
+
+										return documentCountDelta;
 									}
 
 	// Properties
@@ -876,25 +1233,27 @@ class CDocumentsTable {
 	public:
 		struct Info {
 			public:
-										Info(const CString& documentType, UInt32 lastRevision) :
-											mDocumentType(documentType), mLastRevision(lastRevision)
-											{}
 										Info(const CSQLiteResultsRow& resultsRow) :
 											mDocumentType(*resultsRow.getText(mTypeTableColumn)),
-													mLastRevision(*resultsRow.getUInt32(mLastRevisionTableColumn))
+													mLastRevision(*resultsRow.getUInt32(mLastRevisionTableColumn)),
+													mDocumentCount(resultsRow.getUInt32(mDocumentCountTableColumn))
 											{}
 										Info(const Info& other) :
-											mDocumentType(other.mDocumentType), mLastRevision(other.mLastRevision)
+											mDocumentType(other.mDocumentType), mLastRevision(other.mLastRevision),
+													mDocumentCount(other.mDocumentCount)
 											{}
 
 					const	CString&	getDocumentType() const
 											{ return mDocumentType; }
 							UInt32		getLastRevision() const
 											{ return mLastRevision; }
+					const	OV<UInt32>&	getDocumentCount() const
+											{ return mDocumentCount; }
 
 			private:
-				CString	mDocumentType;
-				UInt32	mLastRevision;
+				CString		mDocumentType;
+				UInt32		mLastRevision;
+				OV<UInt32>	mDocumentCount;
 		};
 
 	public:
@@ -903,27 +1262,39 @@ class CDocumentsTable {
 										// Create table
 										CSQLiteTable	table =
 																database.getTable(CString(OSSTR("Documents")),
-																		TSArray<CSQLiteTableColumn>(mTableColumns, 2));
+																		TSArray<CSQLiteTableColumn>(mTableColumns, 3));
 
-										// Check if need to create
+										// Check if need to create/migrate
 										OV<UInt32>	version = CInternalsTable::getVersion(table, internalsTable);
 										if (!version.hasValue()) {
 											// Create
 											table.create();
 
 											// Store version
-											CInternalsTable::set(1, table, internalsTable);
+											CInternalsTable::set(2, table, internalsTable);
+										} else if (*version == 1) {
+											// Migrate to version 2.  Counts are left NULL and computed once when the
+											//	document types are loaded.
+											database.execute(
+													CString(OSSTR("ALTER TABLE \"")) + table.getName() +
+															CString(OSSTR("\" ADD COLUMN documentCount INTEGER")));
+
+											// Store version
+											CInternalsTable::set(2, table, internalsTable);
 										}
 
 										return table;
 									}
-		static	void			set(UInt32 lastRevision, const CString& documentType, CSQLiteTable& table)
+		static	void			set(UInt32 lastRevision, UInt32 documentCount, const CString& documentType,
+										CSQLiteTable& table)
 									{
 										// Setup
 										TNArray<TableColumnAndValue>	tableColumnAndValues;
 										tableColumnAndValues += TableColumnAndValue(mTypeTableColumn, documentType);
 										tableColumnAndValues +=
 												TableColumnAndValue(mLastRevisionTableColumn, lastRevision);
+										tableColumnAndValues +=
+												TableColumnAndValue(mDocumentCountTableColumn, documentCount);
 
 										// Insert or replace row
 										table.insertOrReplaceRow(tableColumnAndValues);
@@ -932,6 +1303,7 @@ class CDocumentsTable {
 	private:
 		static	CSQLiteTableColumn	mTypeTableColumn;
 		static	CSQLiteTableColumn	mLastRevisionTableColumn;
+		static	CSQLiteTableColumn	mDocumentCountTableColumn;
 		static	CSQLiteTableColumn	mTableColumns[];
 };
 
@@ -939,7 +1311,10 @@ CSQLiteTableColumn	CDocumentsTable::mTypeTableColumn(CString(OSSTR("type")), CSQ
 							(CSQLiteTableColumn::Options) (CSQLiteTableColumn::kOptionsNotNull | CSQLiteTableColumn::kOptionsUnique));
 CSQLiteTableColumn	CDocumentsTable::mLastRevisionTableColumn(CString(OSSTR("lastRevision")),
 							CSQLiteTableColumn::kKindInteger, CSQLiteTableColumn::kOptionsNotNull);
-CSQLiteTableColumn	CDocumentsTable::mTableColumns[] = {mTypeTableColumn, mLastRevisionTableColumn};
+CSQLiteTableColumn	CDocumentsTable::mDocumentCountTableColumn(CString(OSSTR("documentCount")),
+							CSQLiteTableColumn::kKindInteger, CSQLiteTableColumn::kOptionsNone);
+CSQLiteTableColumn	CDocumentsTable::mTableColumns[] =
+							{mTypeTableColumn, mLastRevisionTableColumn, mDocumentCountTableColumn};
 
 //----------------------------------------------------------------------------------------------------------------------
 //----------------------------------------------------------------------------------------------------------------------
@@ -1055,16 +1430,23 @@ class CDocumentTypeInfoTable {
 																						nameRoot + CString(OSSTR("s")),
 																						tableColumns());
 
-														// Check if need to create
+														// Check if need to create/migrate
 														OV<UInt32>	version =
 																			CInternalsTable::getVersion(table,
 																					internalsTable);
 														if (!version.hasValue()) {
 															// Create
 															table.create();
+															createIndexes(database, table);
+
+															// Store version
+															CInternalsTable::set(2, table, internalsTable);
+														} else if (*version == 1) {
+															// Migrate to version 2
+															createIndexes(database, table);
 
 															// Store version
-															CInternalsTable::set(1, table, internalsTable);
+															CInternalsTable::set(2, table, internalsTable);
 														}
 
 														return table;
@@ -1188,6 +1570,19 @@ class CDocumentTypeInfoTable {
 														DocumentInfo::ProcInfo* documentInfoProcInfo)
 													{ return documentInfoProcInfo->call(getDocumentInfo(resultsRow)); }
 
+	private:
+		static	void							createIndexes(CSQLiteDatabase& database, const CSQLiteTable& table)
+													{
+														// Sync queries select revision > ? (optionally active only)
+														//	ordered by revision
+														database.execute(
+																CString(OSSTR("CREATE INDEX IF NOT EXISTS \"")) +
+																		table.getName() +
+																		CString(OSSTR("-revision\" ON \"")) +
+																		table.getName() +
+																		CString(OSSTR("\" (revision, active)")));
+													}
+
 	public:
 		static	const	CSQLiteTableColumn	mIDTableColumn;
 		static	const	CSQLiteTableColumn	mDocumentIDTableColumn;
@@ -1222,6 +1617,467 @@ const	CSQLiteTableColumn	CDocumentTypeInfoTable::mIDDocumentIDTableColumns[] =
 const	CSQLiteTableColumn	CDocumentTypeInfoTable::mIDDocumentIDRevisionTableColumns[] =
 									{mIDTableColumn, mDocumentIDTableColumn, mRevisionTableColumn};
 
+//----------------------------------------------------------------------------------------------------------------------
+//----------------------------------------------------------------------------------------------------------------------
+// MARK: - CPropertyMapCoder
+
+/*
+	Binary property map encoding.  All integers are little-endian.
+
+		UInt8		format (kFormatBinaryV1).  JSON property maps always start with '{' so rows in either encoding
+						can live side by side in the same table.
+		UInt32		key count
+		Key[]		UInt32 byte count followed by UTF-8 bytes
+		Dictionary	the property map
+
+	A Dictionary is a UInt32 item count followed by (UInt32 key index, Value) pairs.  A Value is a UInt8 type followed by
+	1, 2, 4 or 8 bytes for bools and numerics, a UInt32 byte count and bytes for strings and data, a Dictionary, or a
+	UInt32 count and items for arrays.  Nested dictionaries share the key table.
+
+	Data values are stored as raw bytes in the binary encoding.  JSON has no representation for raw bytes so CMDSSQLite
+	keeps Data values as Base64 strings when using the JSON encoding.
+*/
+
+class CPropertyMapCoder {
+	// Types
+	private:
+		enum {
+			kFormatBinaryV1 = 0x01,
+		};
+
+		enum Type {
+			kTypeBoolFalse				= 0x00,
+			kTypeBoolTrue				= 0x01,
+			kTypeSInt32					= 0x02,
+			kTypeSInt64					= 0x03,
+			kTypeUInt8					= 0x04,
+			kTypeUInt16					= 0x05,
+			kTypeUInt32					= 0x06,
+			kTypeUInt64					= 0x07,
+			kTypeFloat32				= 0x08,
+			kTypeFloat64				= 0x09,
+			kTypeString					= 0x0A,
+			kTypeData					= 0x0B,
+			kTypeDictionary				= 0x0C,
+			kTypeArrayOfStrings			= 0x0D,
+			kTypeArrayOfDictionaries	= 0x0E,
+		};
+
+		// Encoder
+		struct Encoder {
+			public:
+								Encoder() {}
+
+						void	writeUInt8(UInt8 value)
+									{ mBody.appendBytes(&value, 1); }
+						void	writeUInt16(UInt16 value)
+									{
+										// Write
+										UInt8	bytes[] = {(UInt8) value, (UInt8) (value >> 8)};
+										mBody.appendBytes(bytes, sizeof(bytes));
+									}
+						void	writeUInt32(UInt32 value)
+									{ writeUInt32(value, mBody); }
+						void	writeUInt64(UInt64 value)
+									{
+										// Write
+										writeUInt32((UInt32) value);
+										writeUInt32((UInt32) (value >> 32));
+									}
+						void	writeBytes(const CData& data)
+									{
+										// Write
+										writeUInt32((UInt32) data.getByteCount());
+										mBody.appendBytes(data.getBytePtr(), data.getByteCount());
+									}
+						void	writeKey(const CString& key)
+									{
+										// Check if already in key table
+										const	OR<TNumber<UInt32> >	index = mKeyIndexByKey[key];
+										if (index.hasReference())
+											// Have key
+											writeUInt32(**index);
+										else {
+											// Add key
+											mKeyIndexByKey.set(key, TNumber<UInt32>(mKeys.getCount()));
+											writeUInt32(mKeys.getCount());
+											mKeys += key;
+										}
+									}
+						void	writeDictionary(const CDictionary& dictionary)
+									{
+										// Write
+										writeUInt32(dictionary.getKeyCount());
+										for (CDictionary::Iterator iterator = dictionary.getIterator(); iterator;
+												iterator++) {
+											// Write item
+											writeKey(iterator.getKey());
+											writeValue(iterator.getValue());
+										}
+									}
+						void	writeValue(const SValue& value)
+									{
+										// Check type
+										switch (value.getType()) {
+											case SValue::kTypeBool:
+												// Bool
+												writeUInt8(value.getBool() ? kTypeBoolTrue : kTypeBoolFalse);
+												break;
+
+											case SValue::kTypeSInt32:
+												// SInt32
+												writeUInt8(kTypeSInt32);
+												writeUInt32((UInt32) value.getSInt32());
+												break;
+
+											case SValue::kTypeSInt64:
+												// SInt64
+												writeUInt8(kTypeSInt64);
+												writeUInt64((UInt64) value.getSInt64());
+												break;
+
+											case SValue::kTypeUInt8:
+												// UInt8
+												writeUInt8(kTypeUInt8);
+												writeUInt8(value.getUInt8());
+												break;
+
+											case SValue::kTypeUInt16:
+												// UInt16
+												writeUInt8(kTypeUInt16);
+												writeUInt16(value.getUInt16());
+												break;
+
+											case SValue::kTypeUInt32:
+												// UInt32
+												writeUInt8(kTypeUInt32);
+												writeUInt32(value.getUInt32());
+												break;
+
+											case SValue::kTypeUInt64:
+												// UInt64
+												writeUInt8(kTypeUInt64);
+												writeUInt64(value.getUInt64());
+												break;
+
+											case SValue::kTypeFloat32: {
+												// Float32
+												Float32	float32 = value.getFloat32();
+												UInt32	bits;
+												::memcpy(&bits, &float32, sizeof(UInt32));
+												writeUInt8(kTypeFloat32);
+												writeUInt32(bits);
+												break; }
+
+											case SValue::kTypeFloat64: {
+												// Float64
+												Float64	float64 = value.getFloat64();
+												UInt64	bits;
+												::memcpy(&bits, &float64, sizeof(UInt64));
+												writeUInt8(kTypeFloat64);
+												writeUInt64(bits);
+												break; }
+
+											case SValue::kTypeString:
+												// String
+												writeUInt8(kTypeString);
+												writeBytes(*value.getString().getData(CString::kEncodingUTF8));
+												break;
+
+											case SValue::kTypeData:
+												// Data
+												writeUInt8(kTypeData);
+												writeBytes(value.getData());
+												break;
+
+											case SValue::kTypeDictionary:
+												// Dictionary
+												writeUInt8(kTypeDictionary);
+												writeDictionary(value.getDictionary());
+												break;
+
+											case SValue::kTypeArrayOfStrings: {
+												// Array of strings
+												const	TArray<CString>&	strings = value.getArrayOfStrings();
+												writeUInt8(kTypeArrayOfStrings);
+												writeUInt32(strings.getCount());
+												for (TArray<CString>::Iterator iterator = strings.getIterator();
+														iterator; iterator++)
+													// Write string
+													writeBytes(*iterator->getData(CString::kEncodingUTF8));
+												break; }
+
+											case SValue::kTypeArrayOfDictionaries: {
+												// Array of dictionaries
+												const	TArray<CDictionary>&	dictionaries =
+																						value.getArrayOfDictionaries();
+												writeUInt8(kTypeArrayOfDictionaries);
+												writeUInt32(dictionaries.getCount());
+												for (TArray<CDictionary>::Iterator iterator =
+																dictionaries.getIterator();
+														iterator; iterator++)
+													// Write dictionary
+													writeDictionary(*iterator);
+												break; }
+
+											default:
+												// Not supported in a property map
+												AssertFailUnimplemented();
+										}
+									}
+						CData	getData() const
+									{
+										// Compose header
+										UInt8	format = kFormatBinaryV1;
+										CData	data(&format, 1);
+										writeUInt32(mKeys.getCount(), data);
+										for (TArray<CString>::Iterator iterator = mKeys.getIterator(); iterator;
+												iterator++) {
+											// Add key
+											CData	keyData = *iterator->getData(CString::kEncodingUTF8);
+											writeUInt32((UInt32) keyData.getByteCount(), data);
+											data.appendBytes(keyData.getBytePtr(), keyData.getByteCount());
+										}
+
+										// Add body
+										data.appendBytes(mBody.getBytePtr(), mBody.getByteCount());
+
+										return data;
+									}
+
+				static	void	writeUInt32(UInt32 value, CData& data)
+									{
+										// Write
+										UInt8	bytes[] =
+														{(UInt8) value, (UInt8) (value >> 8), (UInt8) (value >> 16),
+																(UInt8) (value >> 24)};
+										data.appendBytes(bytes, sizeof(bytes));
+									}
+
+			private:
+				TNArray<CString>					mKeys;
+				TNDictionary<TNumber<UInt32> >		mKeyIndexByKey;
+				CData								mBody;
+		};
+
+		// Decoder.  Every read is checked against the end of the data and the key table.  Once anything is out of
+		//	range the decoder is marked corrupt and all further reads return empty values.
+		struct Decoder {
+			public:
+										Decoder(const CData& data) :
+											mBytePtr((const UInt8*) data.getBytePtr()),
+													mEndBytePtr(mBytePtr + data.getByteCount()), mIsCorrupt(false)
+											{}
+
+						bool			isCorrupt() const
+											{ return mIsCorrupt; }
+
+						UInt8			readUInt8()
+											{
+												// Check
+												if (!canRead(1))
+													return 0;
+
+												return *mBytePtr++;
+											}
+						UInt16			readUInt16()
+											{
+												// Check
+												if (!canRead(2))
+													return 0;
+
+												// Read
+												UInt16	value = (UInt16) (mBytePtr[0] | (mBytePtr[1] << 8));
+												mBytePtr += 2;
+
+												return value;
+											}
+						UInt32			readUInt32()
+											{
+												// Check
+												if (!canRead(4))
+													return 0;
+
+												// Read
+												UInt32	value =
+																(UInt32) mBytePtr[0] | ((UInt32) mBytePtr[1] << 8) |
+																		((UInt32) mBytePtr[2] << 16) |
+																		((UInt32) mBytePtr[3] << 24);
+												mBytePtr += 4;
+
+												return value;
+											}
+						UInt64			readUInt64()
+											{
+												// Read
+												UInt64	low = readUInt32();
+												UInt64	high = readUInt32();
+
+												return low | (high << 32);
+											}
+						CData			readData()
+											{
+												// Check
+												UInt32	byteCount = readUInt32();
+												if (!canRead(byteCount))
+													return CData();
+
+												// Read
+												CData	data(mBytePtr, byteCount);
+												mBytePtr += byteCount;
+
+												return data;
+											}
+						CString			readString()
+											{ return CString(readData(), CString::kEncodingUTF8); }
+						void			readKeys()
+											{
+												// Read
+												UInt32	count = readUInt32();
+												for (UInt32 i = 0; (i < count) && !mIsCorrupt; i++)
+													// Read key
+													mKeys += readString();
+											}
+						CDictionary		readDictionary()
+											{
+												// Read
+												CDictionary	dictionary;
+												UInt32		count = readUInt32();
+												for (UInt32 i = 0; (i < count) && !mIsCorrupt; i++) {
+													// Read key index
+													UInt32	keyIndex = readUInt32();
+													if (keyIndex >= mKeys.getCount()) {
+														// Out of range
+														mIsCorrupt = true;
+														break;
+													}
+
+													// Read value
+													SValue	value = readValue();
+													if (!mIsCorrupt)
+														// Add item
+														dictionary.set(mKeys[keyIndex], value);
+												}
+
+												return dictionary;
+											}
+						SValue			readValue()
+											{
+												// Check type
+												switch (readUInt8()) {
+													case kTypeBoolFalse:	return SValue(false);
+													case kTypeBoolTrue:		return SValue(true);
+													case kTypeSInt32:		return SValue((SInt32) readUInt32());
+													case kTypeSInt64:		return SValue((SInt64) readUInt64());
+													case kTypeUInt8:		return SValue(readUInt8());
+													case kTypeUInt16:		return SValue(readUInt16());
+													case kTypeUInt32:		return SValue(readUInt32());
+													case kTypeUInt64:		return SValue(readUInt64());
+
+													case kTypeFloat32: {
+														// Float32
+														UInt32	bits = readUInt32();
+														Float32	float32;
+														::memcpy(&float32, &bits, sizeof(Float32));
+
+														return SValue(float32); }
+
+													case kTypeFloat64: {
+														// Float64
+														UInt64	bits = readUInt64();
+														Float64	float64;
+														::memcpy(&float64, &bits, sizeof(Float64));
+
+														return SValue(float64); }
+
+													case kTypeString:		return SValue(readString());
+													case kTypeData:			return SValue(readData());
+													case kTypeDictionary:	return SValue(readDictionary());
+
+													case kTypeArrayOfStrings: {
+														// Array of strings
+														TNArray<CString>	strings;
+														UInt32				count = readUInt32();
+														for (UInt32 i = 0; (i < count) && !mIsCorrupt; i++)
+															// Read string
+															strings += readString();
+
+														return SValue(strings); }
+
+													case kTypeArrayOfDictionaries: {
+														// Array of dictionaries
+														TNArray<CDictionary>	dictionaries;
+														UInt32					count = readUInt32();
+														for (UInt32 i = 0; (i < count) && !mIsCorrupt; i++)
+															// Read dictionary
+															dictionaries += readDictionary();
+
+														return SValue(dictionaries); }
+
+													default:
+														// Unknown type
+														mIsCorrupt = true;
+
+														return SValue(false);
+												}
+											}
+
+			private:
+						bool			canRead(UInt32 byteCount)
+											{
+												// Check
+												if (!mIsCorrupt && ((UInt64) (mEndBytePtr - mBytePtr) < byteCount))
+													// Past the end
+													mIsCorrupt = true;
+
+												return !mIsCorrupt;
+											}
+
+			private:
+				const	UInt8*				mBytePtr;
+				const	UInt8*				mEndBytePtr;
+						bool				mIsCorrupt;
+						TNArray<CString>	mKeys;
+		};
+
+	public:
+		static	CData		dataFrom(const CDictionary& propertyMap,
+									CMDSSQLite::PropertyMapEncoding propertyMapEncoding)
+								{
+									// Check encoding
+									if (propertyMapEncoding == CMDSSQLite::kPropertyMapEncodingJSON)
+										// JSON
+										return *CJSON::dataFrom(propertyMap);
+
+									// Binary
+									Encoder	encoder;
+									encoder.writeDictionary(propertyMap);
+
+									return encoder.getData();
+								}
+		static	TVResult<CDictionary>	dictionaryFrom(const CData& data)
+											{
+												// Check format
+												if ((data.getByteCount() == 0) ||
+														(*((const UInt8*) data.getBytePtr()) != kFormatBinaryV1))
+													// JSON
+													return TVResult<CDictionary>(*CJSON::dictionaryFrom(data));
+
+												// Binary
+												Decoder		decoder(data);
+												decoder.readUInt8();
+												decoder.readKeys();
+												CDictionary	dictionary = decoder.readDictionary();
+												if (decoder.isCorrupt())
+													// Corrupt
+													return TVResult<CDictionary>(
+															SError(CString(OSSTR("MDSSQLiteDatabaseManager")), 1,
+																	CString(OSSTR("Corrupt binary property map"))));
+
+												return TVResult<CDictionary>(dictionary);
+											}
+};
+
 //----------------------------------------------------------------------------------------------------------------------
 //----------------------------------------------------------------------------------------------------------------------
 // MARK: - CDocumentTypeContentsTable
@@ -1231,116 +2087,333 @@ class CDocumentTypeContentsTable {
 	public:
 		typedef	CMDSSQLiteDatabaseManager::DocumentContentInfo	DocumentContentInfo;
 
+	private:
+		struct MigrateDatesInfo {
+			public:
+				MigrateDatesInfo(CSQLiteTable& table) : mTable(table) {}
+
+				CSQLiteTable&	mTable;
+				OV<SError>		mError;
+		};
+
 	public:
-		static	CSQLiteTable		in(CSQLiteDatabase& database, const CString& nameRoot,
-											const CSQLiteTable& infoTable, CSQLiteTable& internalsTable)
-										{
-											// Create table
-											CSQLiteTableColumn::Reference	tableColumnReference(mIDTableColumn,
-																					infoTable,
-																					CDocumentTypeInfoTable::
-																							mIDTableColumn);
-											CSQLiteTable					table =
-																					database.getTable(
-																							nameRoot +
-																									CString(OSSTR("Contents")),
-																							TSArray<CSQLiteTableColumn>(
-																									mTableColumns, 4),
-																							TNArray<CSQLiteTableColumn::
-																											Reference>(
-																									tableColumnReference));
-
-											// Check if need to create
-											OV<UInt32>	version =
-																CInternalsTable::getVersion(table,
-																		internalsTable);
-											if (!version.hasValue()) {
-												// Create
-												table.create();
-
-												// Store version
-												CInternalsTable::set(1, table, internalsTable);
+		static	CSQLiteTable			in(CSQLiteDatabase& database, const CString& nameRoot,
+												const CSQLiteTable& infoTable, CSQLiteTable& internalsTable,
+												CMDSSQLite::PropertyMapEncoding propertyMapEncoding,
+												CMDSSQLite::DateEncoding dateEncoding)
+											{
+												// Setup.  Both layouts share a name, they only differ in how the
+												//	date columns are created.
+												CSQLiteTable	textDatesTable =
+																		getTable(database, nameRoot, infoTable,
+																				mTextDatesTableColumns);
+												CSQLiteTable	realDatesTable =
+																		getTable(database, nameRoot, infoTable,
+																				mRealDatesTableColumns);
+
+												// Check if need to create/migrate
+												OV<UInt32>	version =
+																	CInternalsTable::getVersion(textDatesTable,
+																			internalsTable);
+												if (!version.hasValue()) {
+													// Create
+													if (dateEncoding == CMDSSQLite::kDateEncodingReal) {
+														// Real dates
+														realDatesTable.create();
+														createIndexes(database, realDatesTable);
+
+														// Store version
+														CInternalsTable::set(3, realDatesTable, internalsTable);
+
+														return realDatesTable;
+													}
+
+													// Text dates
+													textDatesTable.create();
+													createIndexes(database, textDatesTable);
+
+													// Store version
+													version.setValue(
+															(propertyMapEncoding ==
+																			CMDSSQLite::kPropertyMapEncodingBinary) ?
+																	2 : 1);
+													CInternalsTable::set(*version, textDatesTable, internalsTable);
+												} else if (*version >= 3)
+													// Already real dates, which stay in use whatever is requested
+													return realDatesTable;
+												else if (dateEncoding == CMDSSQLite::kDateEncodingReal) {
+													// Migrate to version 3.  Rows written as JSON or binary (version
+													//	2) continue to be read as-is.  If any date does not parse, the
+													//	migration is rolled back and the table stays on text dates.
+													if (migrateDates(database, textDatesTable, realDatesTable)) {
+														// Success
+														createIndexes(database, realDatesTable);
+
+														// Store version
+														CInternalsTable::set(3, realDatesTable, internalsTable);
+
+														return realDatesTable;
+													}
+												}
+
+												// Check if need to note binary property maps
+												if ((*version == 1) &&
+														(propertyMapEncoding == CMDSSQLite::kPropertyMapEncodingBinary))
+													// Migrate to version 2.  Existing JSON rows are re-encoded as
+													//	they are next written.
+													CInternalsTable::set(2, textDatesTable, internalsTable);
+
+												return textDatesTable;
 											}
+		static	CMDSSQLite::DateEncoding	getDateEncoding(const CSQLiteTable& table, CSQLiteTable& internalsTable)
+											{
+												// Version 3 and later store real dates
+												OV<UInt32>	version = CInternalsTable::getVersion(table, internalsTable);
 
-											return table;
-										}
-		static	DocumentContentInfo	getDocumentContentInfo(const CSQLiteResultsRow& resultsRow)
-										{ return DocumentContentInfo(*resultsRow.getInteger(mIDTableColumn),
-												*SGregorianDate::getFrom(*resultsRow.getText(mCreationDateTableColumn)),
-												*SGregorianDate::getFrom(
-														*resultsRow.getText(mModificationDateTableColumn)),
-												*CJSON::dictionaryFrom(*resultsRow.getBlob(mJSONTableColumn))); }
-		static	void				add(SInt64 id, UniversalTime creationUniversalTime,
-											UniversalTime modificationUniversalTime, const CDictionary& propertyMap,
-											CSQLiteTable& table)
-										{
-											// Insert
-											TNArray<TableColumnAndValue>	tableColumnAndValues;
-											tableColumnAndValues += TableColumnAndValue(mIDTableColumn, id);
-											tableColumnAndValues +=
-													TableColumnAndValue(mCreationDateTableColumn,
-															SGregorianDate(creationUniversalTime).getString());
-											tableColumnAndValues +=
-													TableColumnAndValue(mModificationDateTableColumn,
-															SGregorianDate(modificationUniversalTime).getString());
-											tableColumnAndValues +=
-													TableColumnAndValue(mJSONTableColumn,
-															*CJSON::dataFrom(propertyMap));
+												return (version.hasValue() && (*version >= 3)) ?
+														CMDSSQLite::kDateEncodingReal : CMDSSQLite::kDateEncodingText;
+											}
+		static	void					add(SInt64 id, UniversalTime creationUniversalTime,
+												UniversalTime modificationUniversalTime, const CDictionary& propertyMap,
+												CMDSSQLite::PropertyMapEncoding propertyMapEncoding,
+												CMDSSQLite::DateEncoding dateEncoding, CSQLiteTable& table)
+											{
+												// Insert
+												TNArray<TableColumnAndValue>	tableColumnAndValues;
+												tableColumnAndValues += TableColumnAndValue(mIDTableColumn, id);
+												tableColumnAndValues +=
+														getTableColumnAndValue(mCreationDateTableColumn,
+																creationUniversalTime, dateEncoding);
+												tableColumnAndValues +=
+														getTableColumnAndValue(mModificationDateTableColumn,
+																modificationUniversalTime, dateEncoding);
+												tableColumnAndValues +=
+														TableColumnAndValue(mJSONTableColumn,
+																CPropertyMapCoder::dataFrom(propertyMap,
+																		propertyMapEncoding));
 
-											table.insertRow(tableColumnAndValues);
-										}
-		static	void				update(SInt64 id, UniversalTime modificationUniversalTime,
-											const CDictionary& propertyMap, CSQLiteTable& table)
-										{
-											// Update
-											TNArray<TableColumnAndValue>	tableColumnAndValues;
-											tableColumnAndValues +=
-													TableColumnAndValue(mModificationDateTableColumn,
-															SGregorianDate(modificationUniversalTime).getString());
-											tableColumnAndValues +=
-													TableColumnAndValue(mJSONTableColumn,
-															*CJSON::dataFrom(propertyMap));
+												table.insertRow(tableColumnAndValues);
+											}
+		static	void					update(SInt64 id, UniversalTime modificationUniversalTime,
+												const CDictionary& propertyMap,
+												CMDSSQLite::PropertyMapEncoding propertyMapEncoding,
+												CMDSSQLite::DateEncoding dateEncoding, CSQLiteTable& table)
+											{
+												// Update
+												TNArray<TableColumnAndValue>	tableColumnAndValues;
+												tableColumnAndValues +=
+														getTableColumnAndValue(mModificationDateTableColumn,
+																modificationUniversalTime, dateEncoding);
+												tableColumnAndValues +=
+														TableColumnAndValue(mJSONTableColumn,
+																CPropertyMapCoder::dataFrom(propertyMap,
+																		propertyMapEncoding));
 
-											table.update(tableColumnAndValues,
-													CSQLiteWhere(mIDTableColumn, SSQLiteValue(id)));
-										}
-		static	void				update(SInt64 id, UniversalTime modificationUniversalTime, CSQLiteTable& table)
-										{
-											// Update
-											TNArray<TableColumnAndValue>	tableColumnAndValues;
-											tableColumnAndValues +=
-													TableColumnAndValue(mModificationDateTableColumn,
-															SGregorianDate(modificationUniversalTime).getString());
+												table.update(tableColumnAndValues,
+														CSQLiteWhere(mIDTableColumn, SSQLiteValue(id)));
+											}
+		static	void					update(SInt64 id, UniversalTime modificationUniversalTime,
+												CMDSSQLite::DateEncoding dateEncoding, CSQLiteTable& table)
+											{
+												// Update
+												TNArray<TableColumnAndValue>	tableColumnAndValues;
+												tableColumnAndValues +=
+														getTableColumnAndValue(mModificationDateTableColumn,
+																modificationUniversalTime, dateEncoding);
 
-											table.update(tableColumnAndValues,
-													CSQLiteWhere(mIDTableColumn, SSQLiteValue(id)));
-										}
-		static	void				remove(SInt64 id, CSQLiteTable& table)
-										{
-											// Update
-											TNArray<TableColumnAndValue>	tableColumnAndValues;
-											tableColumnAndValues +=
-													TableColumnAndValue(mModificationDateTableColumn,
-															SGregorianDate().getString());
-											tableColumnAndValues +=
-													TableColumnAndValue(mJSONTableColumn,
-															*CJSON::dataFrom(CDictionary()));
+												table.update(tableColumnAndValues,
+														CSQLiteWhere(mIDTableColumn, SSQLiteValue(id)));
+											}
+		static	void					remove(SInt64 id, CMDSSQLite::PropertyMapEncoding propertyMapEncoding,
+												CMDSSQLite::DateEncoding dateEncoding, CSQLiteTable& table)
+											{
+												// Update
+												TNArray<TableColumnAndValue>	tableColumnAndValues;
+												tableColumnAndValues +=
+														getTableColumnAndValue(mModificationDateTableColumn,
+																SUniversalTime::getCurrent(), dateEncoding);
+												tableColumnAndValues +=
+														TableColumnAndValue(mJSONTableColumn,
+																CPropertyMapCoder::dataFrom(CDictionary(),
+																		propertyMapEncoding));
 
-											table.update(tableColumnAndValues,
-													CSQLiteWhere(mIDTableColumn, SSQLiteValue(id)));
-										}
+												table.update(tableColumnAndValues,
+														CSQLiteWhere(mIDTableColumn, SSQLiteValue(id)));
+											}
+
+		static	CSQLiteResultsRow::Proc	getDocumentContentInfoProc(CMDSSQLite::DateEncoding dateEncoding)
+											{ return (dateEncoding == CMDSSQLite::kDateEncodingReal) ?
+													(CSQLiteResultsRow::Proc) callDocumentContentInfoProcInfoRealDates :
+													(CSQLiteResultsRow::Proc)
+															callDocumentContentInfoProcInfoTextDates; }
+
+	private:
+		static	CSQLiteTable			getTable(CSQLiteDatabase& database, const CString& nameRoot,
+												const CSQLiteTable& infoTable, CSQLiteTableColumn tableColumns[])
+											{
+												// Setup
+												CSQLiteTableColumn::Reference	tableColumnReference(mIDTableColumn,
+																						infoTable,
+																						CDocumentTypeInfoTable::
+																								mIDTableColumn);
+
+												return database.getTable(nameRoot + CString(OSSTR("Contents")),
+														TSArray<CSQLiteTableColumn>(tableColumns, 4),
+														TNArray<CSQLiteTableColumn::Reference>(
+																tableColumnReference));
+											}
+		static	TableColumnAndValue		getTableColumnAndValue(const CSQLiteTableColumn& tableColumn,
+												UniversalTime universalTime, CMDSSQLite::DateEncoding dateEncoding)
+											{ return (dateEncoding == CMDSSQLite::kDateEncodingReal) ?
+													TableColumnAndValue(tableColumn, universalTime) :
+													TableColumnAndValue(tableColumn,
+															SGregorianDate(universalTime).getString()); }
+		static	OV<SError>				callDocumentContentInfoProcInfo(const CSQLiteResultsRow& resultsRow,
+												UniversalTime creationUniversalTime,
+												UniversalTime modificationUniversalTime,
+												DocumentContentInfo::ProcInfo* documentContentInfoProcInfo)
+											{
+												// Decode property map
+												TVResult<CDictionary>	propertyMap =
+																				CPropertyMapCoder::dictionaryFrom(
+																						*resultsRow.getBlob(
+																								mJSONTableColumn));
+												ReturnErrorIfResultError(propertyMap);
+
+												return documentContentInfoProcInfo->call(
+														DocumentContentInfo(*resultsRow.getInteger(mIDTableColumn),
+																creationUniversalTime, modificationUniversalTime,
+																*propertyMap));
+											}
+		static	OV<SError>				callDocumentContentInfoProcInfoRealDates(
+												const CSQLiteResultsRow& resultsRow,
+												DocumentContentInfo::ProcInfo* documentContentInfoProcInfo)
+											{ return callDocumentContentInfoProcInfo(resultsRow,
+													*resultsRow.getReal(mCreationDateTableColumn),
+													*resultsRow.getReal(mModificationDateTableColumn),
+													documentContentInfoProcInfo); }
+		static	OV<SError>				callDocumentContentInfoProcInfoTextDates(
+												const CSQLiteResultsRow& resultsRow,
+												DocumentContentInfo::ProcInfo* documentContentInfoProcInfo)
+											{
+												// Parse dates
+												OV<SGregorianDate>	creationDate =
+																			SGregorianDate::getFrom(
+																					*resultsRow.getText(
+																							mCreationDateTableColumn));
+												OV<SGregorianDate>	modificationDate =
+																			SGregorianDate::getFrom(
+																					*resultsRow.getText(
+																						mModificationDateTableColumn));
+												if (!creationDate.hasValue() || !modificationDate.hasValue())
+													return OV<SError>(getInvalidDateError(resultsRow));
+
+												return callDocumentContentInfoProcInfo(resultsRow,
+														creationDate->getUniversalTime(),
+														modificationDate->getUniversalTime(),
+														documentContentInfoProcInfo);
+											}
+		static	void					createIndexes(CSQLiteDatabase& database, const CSQLiteTable& table)
+											{
+												// Modification date range queries
+												database.execute(
+														CString(OSSTR("CREATE INDEX IF NOT EXISTS \"")) +
+																table.getName() +
+																CString(OSSTR("-modificationDate\" ON \"")) +
+																table.getName() +
+																CString(OSSTR("\" (modificationDate)")));
+											}
+		static	bool					migrateDates(CSQLiteDatabase& database, CSQLiteTable& textDatesTable,
+												CSQLiteTable& realDatesTable)
+											{
+												// Setup.  SQLite cannot change a column's type in place, so move the
+												//	existing table aside, recreate it and copy the rows over.
+												CString			previousName =
+																		textDatesTable.getName() +
+																				CString(OSSTR("-v2"));
+												CSQLiteTable	previousTable =
+																		database.getTable(previousName,
+																				TSArray<CSQLiteTableColumn>(
+																						mTextDatesTableColumns, 4));
+
+												database.execute(CString(OSSTR("SAVEPOINT migrateDates")));
+												database.execute(
+														CString(OSSTR("ALTER TABLE \"")) + textDatesTable.getName() +
+																CString(OSSTR("\" RENAME TO \"")) + previousName +
+																CString(OSSTR("\"")));
+												realDatesTable.create();
+
+												// Copy rows, converting dates with the same parser used for reads
+												MigrateDatesInfo	migrateDatesInfo(realDatesTable);
+												previousTable.select((CSQLiteResultsRow::Proc) migrateDates_,
+														&migrateDatesInfo);
+												if (migrateDatesInfo.mError.hasValue()) {
+													// Undo
+													database.execute(CString(OSSTR("ROLLBACK TO migrateDates")));
+													database.execute(CString(OSSTR("RELEASE migrateDates")));
+
+													return false;
+												}
 
-		static	OV<SError>			callDocumentContentInfoProcInfo(const CSQLiteResultsRow& resultsRow,
-											DocumentContentInfo::ProcInfo* documentContentInfoProcInfo)
-										{ return documentContentInfoProcInfo->call(getDocumentContentInfo(
-												resultsRow)); }
+												// Cleanup
+												database.execute(CString(OSSTR("DROP TABLE \"")) + previousName +
+														CString(OSSTR("\"")));
+												database.execute(CString(OSSTR("RELEASE migrateDates")));
+
+												return true;
+											}
+		static	OV<SError>				migrateDates_(const CSQLiteResultsRow& resultsRow,
+												MigrateDatesInfo* migrateDatesInfo)
+											{
+												// Parse dates
+												OV<SGregorianDate>	creationDate =
+																			SGregorianDate::getFrom(
+																					*resultsRow.getText(
+																							mCreationDateTableColumn));
+												OV<SGregorianDate>	modificationDate =
+																			SGregorianDate::getFrom(
+																					*resultsRow.getText(
+																						mModificationDateTableColumn));
+												if (!creationDate.hasValue() || !modificationDate.hasValue()) {
+													// Invalid
+													migrateDatesInfo->mError.setValue(getInvalidDateError(resultsRow));
+
+													return migrateDatesInfo->mError;
+												}
+
+												// Insert
+												TNArray<TableColumnAndValue>	tableColumnAndValues;
+												tableColumnAndValues +=
+														TableColumnAndValue(mIDTableColumn,
+																*resultsRow.getInteger(mIDTableColumn));
+												tableColumnAndValues +=
+														TableColumnAndValue(mRealCreationDateTableColumn,
+																creationDate->getUniversalTime());
+												tableColumnAndValues +=
+														TableColumnAndValue(mRealModificationDateTableColumn,
+																modificationDate->getUniversalTime());
+												tableColumnAndValues +=
+														TableColumnAndValue(mJSONTableColumn,
+																*resultsRow.getBlob(mJSONTableColumn));
+												migrateDatesInfo->mTable.insertRow(tableColumnAndValues);
+
+												return OV<SError>();
+											}
+		static	SError					getInvalidDateError(const CSQLiteResultsRow& resultsRow)
+											{ return SError(CString(OSSTR("MDSSQLiteDatabaseManager")), 2,
+													CString(OSSTR("Invalid date for id ")) +
+															CString(*resultsRow.getInteger(mIDTableColumn))); }
 
 	private:
 		static	CSQLiteTableColumn	mIDTableColumn;
 		static	CSQLiteTableColumn	mCreationDateTableColumn;
 		static	CSQLiteTableColumn	mModificationDateTableColumn;
 		static	CSQLiteTableColumn	mJSONTableColumn;
-		static	CSQLiteTableColumn	mTableColumns[];
+		static	CSQLiteTableColumn	mTextDatesTableColumns[];
+
+		static	CSQLiteTableColumn	mRealCreationDateTableColumn;
+		static	CSQLiteTableColumn	mRealModificationDateTableColumn;
+		static	CSQLiteTableColumn	mRealDatesTableColumns[];
 };
 
 CSQLiteTableColumn	CDocumentTypeContentsTable::mIDTableColumn(CString(OSSTR("id")), CSQLiteTableColumn::kKindInteger,
@@ -1351,9 +2424,17 @@ CSQLiteTableColumn	CDocumentTypeContentsTable::mModificationDateTableColumn(CStr
 							CSQLiteTableColumn::kKindText, CSQLiteTableColumn::kOptionsNotNull);
 CSQLiteTableColumn	CDocumentTypeContentsTable::mJSONTableColumn(CString(OSSTR("json")), CSQLiteTableColumn::kKindBlob,
 							CSQLiteTableColumn::kOptionsNotNull);
-CSQLiteTableColumn	CDocumentTypeContentsTable::mTableColumns[] =
+CSQLiteTableColumn	CDocumentTypeContentsTable::mTextDatesTableColumns[] =
 							{mIDTableColumn, mCreationDateTableColumn, mModificationDateTableColumn,
 									mJSONTableColumn};
+CSQLiteTableColumn	CDocumentTypeContentsTable::mRealCreationDateTableColumn(CString(OSSTR("creationDate")),
+							CSQLiteTableColumn::kKindReal, CSQLiteTableColumn::kOptionsNotNull);
+CSQLiteTableColumn	CDocumentTypeContentsTable::mRealModificationDateTableColumn(
+							CString(OSSTR("modificationDate")), CSQLiteTableColumn::kKindReal,
+							CSQLiteTableColumn::kOptionsNotNull);
+CSQLiteTableColumn	CDocumentTypeContentsTable::mRealDatesTableColumns[] =
+							{mIDTableColumn, mRealCreationDateTableColumn, mRealModificationDateTableColumn,
+									mJSONTableColumn};
 
 //----------------------------------------------------------------------------------------------------------------------
 //----------------------------------------------------------------------------------------------------------------------
@@ -1425,6 +2506,22 @@ class CDocumentTypeAttachmentsTable {
 
 													return documentAttachmentInfoByID;
 												}
+		static	void						addDocumentAttachmentInfos(const IDArray& ids,
+													const CSQLiteTable& table,
+													DocumentAttachmentInfoByIDByID& documentAttachmentInfoByIDByID)
+												{
+													// Get info
+													CSQLiteTableColumn	tableColumns[] =
+																				{ mIDTableColumn,
+																						mAttachmentIDTableColumn,
+																						mRevisionTableColumn,
+																						mInfoTableColumn };
+													table.select(TSARRAY_FROM_C_ARRAY(CSQLiteTableColumn, tableColumns),
+															CSQLiteWhere(mIDTableColumn, SSQLiteValue::valuesFrom(ids)),
+															(CSQLiteResultsRow::Proc)
+																	updateDocumentAttachmentInfoByIDByID,
+															&documentAttachmentInfoByIDByID);
+												}
 		static	OV<SError>					getContent(const CSQLiteResultsRow& resultsRow, OV<CData>* data)
 												{ data->setValue(*resultsRow.getBlob(mContentTableColumn));
 														return OV<SError>(); }
@@ -1461,17 +2558,39 @@ class CDocumentTypeAttachmentsTable {
 		static	void						remove(SInt64 id, CSQLiteTable& table)
 												{ table.deleteRows(mIDTableColumn, SSQLiteValue(id)); }
 
-	private:
-		static	OV<SError>					updateDocumentAttachmentInfoByID(const CSQLiteResultsRow& resultsRow,
-													TNDictionary<CMDSDocument::AttachmentInfo>*
-															documentAttachmentInfoByID)
+	private:
+		static	OV<SError>					updateDocumentAttachmentInfoByID(const CSQLiteResultsRow& resultsRow,
+													TNDictionary<CMDSDocument::AttachmentInfo>*
+															documentAttachmentInfoByID)
+												{
+													// Setup
+													CString	attachmentID =
+																	*resultsRow.getText(mAttachmentIDTableColumn);
+
+													// Process values
+													documentAttachmentInfoByID->set(attachmentID,
+															CMDSDocument::AttachmentInfo(attachmentID,
+																	*resultsRow.getUInt32(mRevisionTableColumn),
+																	*CJSON::dictionaryFrom(
+																			*resultsRow.getBlob(mInfoTableColumn))));
+
+													return OV<SError>();
+												}
+		static	OV<SError>					updateDocumentAttachmentInfoByIDByID(
+													const CSQLiteResultsRow& resultsRow,
+													DocumentAttachmentInfoByIDByID* documentAttachmentInfoByIDByID)
 												{
 													// Setup
+													SInt64	id = *resultsRow.getInteger(mIDTableColumn);
 													CString	attachmentID =
 																	*resultsRow.getText(mAttachmentIDTableColumn);
 
 													// Process values
-													documentAttachmentInfoByID->set(attachmentID,
+													if (!(*documentAttachmentInfoByIDByID)[id].hasReference())
+														// First attachment for this document
+														documentAttachmentInfoByIDByID->set(id,
+																TNDictionary<CMDSDocument::AttachmentInfo>());
+													(*documentAttachmentInfoByIDByID)[id]->set(attachmentID,
 															CMDSDocument::AttachmentInfo(attachmentID,
 																	*resultsRow.getUInt32(mRevisionTableColumn),
 																	*CJSON::dictionaryFrom(
@@ -1746,8 +2865,8 @@ class CIndexContentsTable {
 													SSQLiteValue::valuesFrom(includedIDs));
 									}
 
-		static	void			update(const OV<TArray<IndexKeysInfo> >& indexKeysInfos, const OV<IDArray>& removedIDs,
-										CSQLiteTable& table)
+		static	OV<SError>		update(const OV<TArray<IndexKeysInfo> >& indexKeysInfos, const OV<IDArray>& removedIDs,
+										CSQLiteDatabase& database, CSQLiteTable& table)
 									{
 										// Setup
 										TNArray<SSQLiteValue>	idsToRemove;
@@ -1766,33 +2885,30 @@ class CIndexContentsTable {
 										// Remove
 										if (!idsToRemove.isEmpty())
 											// Remove
-											table.deleteRows(mIDTableColumn, idsToRemove);
-
+											CMultiRowStatement::deleteRows(table, mIDTableColumn, idsToRemove);
 
 										// Check if have info to add
-										if (indexKeysInfos.hasValue()) {
-											// Iterate info
-											for (TArray<IndexKeysInfo>::Iterator indexKeysInfoIterator =
-															indexKeysInfos->getIterator();
-													indexKeysInfoIterator; indexKeysInfoIterator++)
-												// Insert new keys
-												for (TArray<CString>::Iterator keyIterator =
-																indexKeysInfoIterator->getKeys().getIterator();
-														keyIterator; keyIterator++) {
-													// Insert this key
-													TableColumnAndValue	tableColumnAndValues[] =
-																				{
-																					TableColumnAndValue(mKeyTableColumn,
-																							*keyIterator),
-																					TableColumnAndValue(mIDTableColumn,
-																							indexKeysInfoIterator->
-																									getID()),
-																				};
-													table.insertRow(
-															TSARRAY_FROM_C_ARRAY(TableColumnAndValue,
-																	tableColumnAndValues));
-												}
-										}
+										if (!indexKeysInfos.hasValue())
+											return OV<SError>();
+
+										// Compose values, row after row
+										TNArray<SSQLiteValue>	values;
+										for (TArray<IndexKeysInfo>::Iterator indexKeysInfoIterator =
+														indexKeysInfos->getIterator();
+												indexKeysInfoIterator; indexKeysInfoIterator++)
+											// Add row for each key
+											for (TArray<CString>::Iterator keyIterator =
+															indexKeysInfoIterator->getKeys().getIterator();
+													keyIterator; keyIterator++) {
+												// Add row for this key
+												values += SSQLiteValue(*keyIterator);
+												values += SSQLiteValue(indexKeysInfoIterator->getID());
+											}
+
+										// Insert.  A key already claimed by another document keeps that document,
+										//	as when each row was inserted on its own.
+										return CMultiRowStatement::insertOrIgnoreRows(database, table,
+												TSArray<CSQLiteTableColumn>(mTableColumns, 2), values);
 									}
 
 		static	OV<SError>		callDocumentInfoKeyProcInfo(const CSQLiteResultsRow& resultsRow,
@@ -1876,6 +2992,148 @@ CSQLiteTableColumn	CInternalTable::mValueTableColumn(CString(OSSTR("value")), CS
 							CSQLiteTableColumn::kOptionsNotNull);
 CSQLiteTableColumn	CInternalTable::mTableColumns[] = {mKeyTableColumn, mValueTableColumn};
 
+//----------------------------------------------------------------------------------------------------------------------
+//----------------------------------------------------------------------------------------------------------------------
+// MARK: - CWALCheckpointThread
+
+class CWALCheckpointThread : public CThread {
+	public:
+				CWALCheckpointThread(const CFolder& folder, const CString& name,
+						const CMDSSQLite::WALCheckpointInfo& walCheckpointInfo) :
+					CThread(CString(OSSTR("MDS SQLite WAL Checkpoint"))),
+							mDatabase(folder, name),
+							mWALFile(folder.getFilesystemPath().appendingComponent(
+									name + CString(OSSTR(".sqlite-wal")))),
+							mWALCheckpointInfo(walCheckpointInfo), mWALFrameByteCount(getPageByteCount() + 24),
+							mLastWALByteCount(mWALFile.getByteCount()),
+							mLastWriteUniversalTime(SUniversalTime::getCurrent()), mHasPendingWrites(false),
+							mShouldStop(false)
+					{ start(); }
+
+		void	noteWrite()
+					{
+						// Update
+						mLock.lock();
+						mLastWriteUniversalTime = SUniversalTime::getCurrent();
+						mHasPendingWrites = true;
+						mLock.unlock();
+
+						// Wake up to check the page count trigger
+						mSemaphore.signal();
+					}
+		void	stop()
+					{
+						// Signal and wait until done
+						mLock.lock();
+						mShouldStop = true;
+						mLock.unlock();
+
+						mSemaphore.signal();
+						mStoppedSemaphore.waitFor();
+					}
+
+	protected:
+		void	run()
+					{
+						// Loop until stopped
+						while (true) {
+							// Wait for a write or for the idle time to elapse
+							mSemaphore.waitFor(mWALCheckpointInfo.getIdleTimeTrigger());
+
+							// Check if the log has grown.  Not every write path notes its write, so a log that has
+							//	changed since the last look counts as a pending write.
+							UInt64	walByteCount = mWALFile.getByteCount();
+							if (walByteCount != mLastWALByteCount) {
+								// Log has changed
+								mLastWALByteCount = walByteCount;
+
+								mLock.lock();
+								mLastWriteUniversalTime = SUniversalTime::getCurrent();
+								mHasPendingWrites = true;
+								mLock.unlock();
+							}
+
+							// Check state
+							mLock.lock();
+							bool			shouldStop = mShouldStop;
+							bool			hasPendingWrites = mHasPendingWrites;
+							UniversalTime	lastWriteUniversalTime = mLastWriteUniversalTime;
+							mLock.unlock();
+							if (shouldStop)
+								break;
+							if (!hasPendingWrites)
+								continue;
+
+							// Check triggers
+							UInt64	walPageCount =
+											(walByteCount > kWALHeaderByteCount) ?
+													(walByteCount - kWALHeaderByteCount) / mWALFrameByteCount : 0;
+							bool	isIdle =
+											(SUniversalTime::getCurrent() - lastWriteUniversalTime) >=
+													mWALCheckpointInfo.getIdleTimeTrigger();
+							if ((walPageCount < mWALCheckpointInfo.getPageCountTrigger()) && !isIdle)
+								continue;
+
+							// Checkpoint
+							mLock.lock();
+							mHasPendingWrites = false;
+							mLock.unlock();
+
+							UniversalTime	startUniversalTime = SUniversalTime::getCurrent();
+							mDatabase.execute(CString(OSSTR("PRAGMA wal_checkpoint(TRUNCATE)")));
+							mWALCheckpointInfo.report(SUniversalTime::getCurrent() - startUniversalTime,
+									walByteCount);
+							mLastWALByteCount = mWALFile.getByteCount();
+						}
+
+						// Done
+						mStoppedSemaphore.signal();
+					}
+
+	private:
+		UInt64	getPageByteCount()
+					{
+						// Query
+						CSQLiteTable	table =
+												mDatabase.getTable(CString(OSSTR("pragma_page_size")),
+														TSArray<CSQLiteTableColumn>(mPageSizeTableColumn));
+						OV<UInt32>		pageByteCount;
+						table.select((CSQLiteResultsRow::Proc) getPageByteCount_, &pageByteCount);
+
+						return pageByteCount.hasValue() ? *pageByteCount : 4096;
+					}
+
+		static	OV<SError>	getPageByteCount_(const CSQLiteResultsRow& resultsRow, OV<UInt32>* pageByteCount)
+								{
+									// Process results
+									pageByteCount->setValue(resultsRow.getUInt32(mPageSizeTableColumn));
+
+									return OV<SError>();
+								}
+
+	private:
+		// WAL frames are a page plus a 24 byte frame header, following a 32 byte file header
+		static	const	UInt64								kWALHeaderByteCount = 32;
+
+		static	const	CSQLiteTableColumn					mPageSizeTableColumn;
+
+						CSQLiteDatabase						mDatabase;
+						CFile								mWALFile;
+				const	CMDSSQLite::WALCheckpointInfo		mWALCheckpointInfo;
+				const	UInt64								mWALFrameByteCount;
+						UInt64								mLastWALByteCount;
+
+						CLock								mLock;
+						UniversalTime						mLastWriteUniversalTime;
+						bool								mHasPendingWrites;
+						bool								mShouldStop;
+						CSemaphore							mSemaphore;
+						CSemaphore							mStoppedSemaphore;
+};
+
+const	CSQLiteTableColumn	CWALCheckpointThread::mPageSizeTableColumn(CString(OSSTR("page_size")),
+									CSQLiteTableColumn::kKindInteger, CSQLiteTableColumn::kOptionsNone);
+
 //----------------------------------------------------------------------------------------------------------------------
 //----------------------------------------------------------------------------------------------------------------------
 // MARK: - CMDSSQLiteDatabaseManager::Internals
@@ -2108,27 +3366,65 @@ class CMDSSQLiteDatabaseManager::Internals {
 		// DocumentTables
 		struct DocumentTables {
 			public:
-								DocumentTables(const CSQLiteTable& infoTable, const CSQLiteTable& contentsTable,
-										const CSQLiteTable& attachmentsTable) :
-									mInfoTable(infoTable), mContentsTable(contentsTable),
-											mAttachmentsTable(attachmentsTable)
-									{}
-								DocumentTables(const DocumentTables& other) :
-									mInfoTable(other.mInfoTable), mContentsTable(other.mContentsTable),
-											mAttachmentsTable(other.mAttachmentsTable)
-									{}
+											DocumentTables(const CSQLiteTable& infoTable,
+													const CSQLiteTable& contentsTable,
+													CMDSSQLite::DateEncoding contentsDateEncoding,
+													const CSQLiteTable& attachmentsTable) :
+												mInfoTable(infoTable), mContentsTable(contentsTable),
+														mContentsDateEncoding(contentsDateEncoding),
+														mAttachmentsTable(attachmentsTable)
+												{}
+											DocumentTables(const DocumentTables& other) :
+												mInfoTable(other.mInfoTable), mContentsTable(other.mContentsTable),
+														mContentsDateEncoding(other.mContentsDateEncoding),
+														mAttachmentsTable(other.mAttachmentsTable)
+												{}
+
+				CSQLiteTable&				getInfoTable()
+												{ return mInfoTable; }
+				CSQLiteTable&				getContentsTable()
+												{ return mContentsTable; }
+				CMDSSQLite::DateEncoding	getContentsDateEncoding() const
+												{ return mContentsDateEncoding; }
+				CSQLiteTable&				getAttachmentsTable()
+												{ return mAttachmentsTable; }
+
+			private:
+				CSQLiteTable				mInfoTable;
+				CSQLiteTable				mContentsTable;
+				CMDSSQLite::DateEncoding	mContentsDateEncoding;
+				CSQLiteTable				mAttachmentsTable;
+		};
+
+		// IDCache
+		class IDCache {
+			public:
+								IDCache(UInt32 limit = 100000) : mIDByKey(limit) {}
+
+				OV<SInt64>		get(const CString& documentType, const CString& documentID)
+									{ return mIDByKey.get(getKey(documentType, documentID)); }
+				void			add(const CString& documentType, const CString& documentID, SInt64 id)
+									{ mIDByKey.add(getKey(documentType, documentID), id); }
+				void			remove(const CString& documentType, const CString& documentID)
+									{ mIDByKey.remove(getKey(documentType, documentID)); }
+
+				IDCacheInfo		getInfo()
+									{
+										// Get info
+										TMDSClockCache<SInt64>::Info	info = mIDByKey.getInfo();
 
-				CSQLiteTable&	getInfoTable()
-									{ return mInfoTable; }
-				CSQLiteTable&	getContentsTable()
-									{ return mContentsTable; }
-				CSQLiteTable&	getAttachmentsTable()
-									{ return mAttachmentsTable; }
+										return IDCacheInfo(info.getCount(), info.getHitCount(), info.getMissCount(),
+												info.getEvictionCount());
+									}
+
+			private:
+				static	CString	getKey(const CString& documentType, const CString& documentID)
+									{ return documentType + CString(OSSTR("/")) + documentID; }
 
 			private:
-				CSQLiteTable	mInfoTable;
-				CSQLiteTable	mContentsTable;
-				CSQLiteTable	mAttachmentsTable;
+				// An id is only valid while its row exists.  A rolled back transaction discards the rows it added
+				//	and SQLite may hand out the same ids again, so entries for those rows must be removed.
+				TMDSClockCache<SInt64>	mIDByKey;
 		};
 
 		// IndexUpdateInfo
@@ -2183,18 +3479,51 @@ class CMDSSQLiteDatabaseManager::Internals {
 															BatchInfo(const BatchInfo& other) :
 																mDocumentLastRevisionTypesNeedingWrite(
 																		other.mDocumentLastRevisionTypesNeedingWrite),
+																		mPreviousLastRevisionByType(
+																				other.mPreviousLastRevisionByType),
+																		mPreviousDocumentCountByType(
+																				other.mPreviousDocumentCountByType),
+																		mCreatedDocumentIDsByDocumentType(
+																				other.mCreatedDocumentIDsByDocumentType),
+																		mDocumentTypesWithNewTables(
+																				other.mDocumentTypesWithNewTables),
 																		mCacheUpdateInfoByName(
 																				other.mCacheUpdateInfoByName),
 																		mCollectionUpdateInfoByName(
 																				other.mCollectionUpdateInfoByName),
 																		mIndexUpdateInfoByName(
-																				other.mIndexUpdateInfoByName)
+																				other.mIndexUpdateInfoByName),
+																		mError(other.mError)
 																{}
 
 						void								noteDocumentTypeNeedingLastRevisionWrite(
-																	const CString& documentType)
-																{ mDocumentLastRevisionTypesNeedingWrite +=
-																		documentType; }
+																	const CString& documentType,
+																	const OR<TNumber<UInt32> >& previousLastRevision,
+																	const OR<TNumber<UInt32> >& previousDocumentCount)
+																{
+																	// Check if first time
+																	if (mDocumentLastRevisionTypesNeedingWrite.contains(
+																			documentType))
+																		return;
+
+																	// Note values to restore on rollback
+																	mDocumentLastRevisionTypesNeedingWrite +=
+																			documentType;
+																	if (previousLastRevision.hasReference())
+																		// Have last revision
+																		mPreviousLastRevisionByType.set(
+																				documentType, *previousLastRevision);
+																	if (previousDocumentCount.hasReference())
+																		// Have document count
+																		mPreviousDocumentCountByType.set(
+																				documentType, *previousDocumentCount);
+																}
+						void								noteDocumentCreated(const CString& documentType,
+																	const CString& documentID)
+																{ mCreatedDocumentIDsByDocumentType.add(documentType,
+																		documentID); }
+						void								noteDocumentTablesCreated(const CString& documentType)
+																{ mDocumentTypesWithNewTables += documentType; }
 						void								noteCacheUpdate(const CString& name,
 																	const OV<ValueInfoByID>& valueInfoByID,
 																	const IDArray& removedIDs,
@@ -2255,27 +3584,65 @@ class CMDSSQLiteDatabaseManager::Internals {
 																						indexKeysInfos, removedIDs,
 																						lastRevision));
 																}
+						void								noteError(const SError& error)
+																{
+																	// Keep the first error
+																	if (!mError.hasValue())
+																		mError.setValue(error);
+																}
 
 				const	TSet<CString>&						getDocumentLastRevisionTypesNeedingWrite() const
 																{ return mDocumentLastRevisionTypesNeedingWrite; }
+				const	TDictionary<TNumber<UInt32> >&		getPreviousLastRevisionByType() const
+																{ return mPreviousLastRevisionByType; }
+				const	TDictionary<TNumber<UInt32> >&		getPreviousDocumentCountByType() const
+																{ return mPreviousDocumentCountByType; }
+				const	TArrayDictionary<CString>&			getCreatedDocumentIDsByDocumentType() const
+																{ return mCreatedDocumentIDsByDocumentType; }
+				const	TSet<CString>&						getDocumentTypesWithNewTables() const
+																{ return mDocumentTypesWithNewTables; }
 				const 	TDictionary<CacheUpdateInfo>&		getCacheUpdateInfoByName() const
 																{ return mCacheUpdateInfoByName; }
 				const 	TDictionary<CollectionUpdateInfo>&	getCollectionUpdateInfoByName() const
 																{ return mCollectionUpdateInfoByName; }
 				const 	TDictionary<IndexUpdateInfo>&		getIndexUpdateInfoByName() const
 																{ return mIndexUpdateInfoByName; }
+				const	OV<SError>&							getError() const
+																{ return mError; }
 
 			// Properties
 			private:
 				TNSet<CString>						mDocumentLastRevisionTypesNeedingWrite;
+				TNDictionary<TNumber<UInt32> >		mPreviousLastRevisionByType;
+				TNDictionary<TNumber<UInt32> >		mPreviousDocumentCountByType;
+				TNArrayDictionary<CString>			mCreatedDocumentIDsByDocumentType;
+				TNSet<CString>						mDocumentTypesWithNewTables;
 				TNDictionary<CacheUpdateInfo>		mCacheUpdateInfoByName;
 				TNDictionary<CollectionUpdateInfo>	mCollectionUpdateInfoByName;
 				TNDictionary<IndexUpdateInfo>		mIndexUpdateInfoByName;
+				OV<SError>							mError;
+		};
+
+		struct BatchTransactionInfo {
+			public:
+				BatchTransactionInfo(Internals& internals, BatchProc batchProc, void* userData) :
+					mInternals(internals), mBatchProc(batchProc), mUserData(userData)
+					{}
+
+				Internals&	mInternals;
+				BatchProc	mBatchProc;
+				void*		mUserData;
+				OV<SError>	mError;
 		};
 
 	public:
-									Internals(const CFolder& folder, const CString& name) :
-										mDatabase(folder, name),
+									Internals(const CFolder& folder, const CString& name,
+											CMDSSQLite::DurabilityMode durabilityMode,
+											const OV<CMDSSQLite::WALCheckpointInfo>& walCheckpointInfo,
+											CMDSSQLite::PropertyMapEncoding propertyMapEncoding,
+											CMDSSQLite::DateEncoding dateEncoding) :
+										mDatabase(folder, name), mPropertyMapEncoding(propertyMapEncoding),
+												mDateEncoding(dateEncoding),
 												mInternalsTable(CInternalsTable::in(mDatabase)),
 												mAssociationsTable(CAssociationsTable::in(mDatabase, mInternalsTable)),
 												mCachesTable(CCachesTable::in(mDatabase, mInternalsTable)),
@@ -2287,11 +3654,79 @@ class CMDSSQLiteDatabaseManager::Internals {
 												mInfoTable(CInfoTable::in(mDatabase)),
 												mInternalTable(CInternalTable::in(mDatabase))
 										{
+											// Setup durability
+											switch (durabilityMode) {
+												case CMDSSQLite::kDurabilityModeFullSync:
+													// Full sync
+													mDatabase.execute(CString(OSSTR("PRAGMA synchronous = FULL")));
+													break;
+
+												case CMDSSQLite::kDurabilityModeNormalSync:
+													// Normal sync
+													mDatabase.execute(CString(OSSTR("PRAGMA synchronous = NORMAL")));
+													break;
+
+												case CMDSSQLite::kDurabilityModeWAL:
+													// WAL.  In WAL mode, NORMAL only syncs the log at checkpoint time
+													//	and remains safe against corruption.
+													mDatabase.execute(CString(OSSTR("PRAGMA journal_mode = WAL")));
+													mDatabase.execute(CString(OSSTR("PRAGMA synchronous = NORMAL")));
+
+													// Check for checkpoint thread
+													if (walCheckpointInfo.hasValue()) {
+														// Checkpoint in the background instead of on
+														//	the committing thread
+														mDatabase.execute(
+																CString(OSSTR("PRAGMA wal_autocheckpoint = 0")));
+														mWALCheckpointThread =
+																OV<I<CWALCheckpointThread> >(
+																		I<CWALCheckpointThread>(
+																				new CWALCheckpointThread(folder,
+																						name, *walCheckpointInfo)));
+													}
+													break;
+											}
+
 											// Finalize setup
 											CInfoTable::set(CString(OSSTR("version")), OV<CString>(), mInfoTable);
 
-											mDocumentsTable.select((CSQLiteResultsRow::Proc) storeDocumentLastRevision,
-													this);
+											TNArray<CDocumentsTable::Info>	documentsTableInfos;
+											mDocumentsTable.select((CSQLiteResultsRow::Proc) addDocumentsTableInfo,
+													&documentsTableInfos);
+											for (TArray<CDocumentsTable::Info>::Iterator iterator =
+															documentsTableInfos.getIterator();
+													iterator; iterator++) {
+												// Setup
+												const	CString&	documentType = iterator->getDocumentType();
+
+												// Store last revision
+												mDocumentLastRevisionByDocumentType.set(documentType,
+														TNumber<UInt32>(iterator->getLastRevision()));
+
+												// Check if have document count
+												if (iterator->getDocumentCount().hasValue())
+													// Store document count
+													mDocumentCountByDocumentType.set(documentType,
+															TNumber<UInt32>(*iterator->getDocumentCount()));
+												else {
+													// Count once for document types stored before counts were
+													//	maintained
+													UInt32	documentCount =
+																	getDocumentTables(documentType).getInfoTable()
+																			.count();
+													mDocumentCountByDocumentType.set(documentType,
+															TNumber<UInt32>(documentCount));
+													CDocumentsTable::set(iterator->getLastRevision(), documentCount,
+															documentType, mDocumentsTable);
+												}
+											}
+										}
+									~Internals()
+										{
+											// Check for checkpoint thread
+											if (mWALCheckpointThread.hasValue())
+												// Stop
+												(*mWALCheckpointThread)->stop();
 										}
 
 				DocumentTables&		getDocumentTables(const CString& documentType)
@@ -2307,19 +3742,111 @@ class CMDSSQLiteDatabaseManager::Internals {
 																				mInternalsTable);
 												CSQLiteTable	contentsTable =
 																		CDocumentTypeContentsTable::in(mDatabase,
-																				nameRoot, mInfoTable, mInternalsTable);
+																				nameRoot, mInfoTable, mInternalsTable,
+																				mPropertyMapEncoding, mDateEncoding);
 												CSQLiteTable	attachmentsTable =
 																		CDocumentTypeAttachmentsTable::in(mDatabase,
 																				nameRoot, mInfoTable, mInternalsTable);
 
 												// Store
 												mDocumentTablesByDocumentType.set(documentType,
-														DocumentTables(infoTable, contentsTable, attachmentsTable));
+														DocumentTables(infoTable, contentsTable,
+																CDocumentTypeContentsTable::getDateEncoding(
+																		contentsTable, mInternalsTable),
+																attachmentsTable));
+
+												// Check for batch
+												const	OR<BatchInfo>	batchInfo = mBatchInfoByThread.get();
+												if (batchInfo.hasReference())
+													// Tables created in the batch go away if it is rolled back
+													batchInfo->noteDocumentTablesCreated(documentType);
 											}
 
 											return *mDocumentTablesByDocumentType.get(documentType);
 										}
-				UInt32				getNextRevision(const CString& documentType)
+				OV<SInt64>			getID(const CString& documentType, const CString& documentID)
+										{
+											// Check cache
+											OV<SInt64>	id = mIDCache.get(documentType, documentID);
+											if (id.hasValue())
+												return id;
+
+											// Query
+											id =
+													CDocumentTypeInfoTable::getID(documentID,
+															getDocumentTables(documentType).getInfoTable());
+											if (id.hasValue())
+												// Remember
+												mIDCache.add(documentType, documentID, *id);
+
+											return id;
+										}
+				CDictionary			getIDByDocumentID(const CString& documentType,
+											const TArray<CString>& documentIDs)
+										{
+											// Setup
+											CDictionary			idByDocumentID;
+											TNArray<CString>	uncachedDocumentIDs;
+
+											// Check cache
+											for (TArray<CString>::Iterator iterator = documentIDs.getIterator();
+													iterator; iterator++) {
+												// Look up
+												OV<SInt64>	id = mIDCache.get(documentType, *iterator);
+												if (id.hasValue())
+													// Found
+													idByDocumentID.set(*iterator, *id);
+												else
+													// Not found
+													uncachedDocumentIDs += *iterator;
+											}
+
+											// Query the rest in chunks that fit within the variable number limit
+											CSQLiteTable&	infoTable = getDocumentTables(documentType).getInfoTable();
+											UInt32			variableNumberLimit = infoTable.getVariableNumberLimit();
+											for (UInt32 startIndex = 0; startIndex < uncachedDocumentIDs.getCount();
+													startIndex += variableNumberLimit) {
+												// Compose chunk
+												TNArray<CString>	chunkDocumentIDs;
+												for (UInt32 i = startIndex;
+														(i < uncachedDocumentIDs.getCount()) &&
+																(i < (startIndex + variableNumberLimit));
+														i++)
+													// Add
+													chunkDocumentIDs += uncachedDocumentIDs[i];
+
+												// Query
+												CDictionary	chunkIDByDocumentID =
+																	CDocumentTypeInfoTable::getIDByDocumentID(
+																			chunkDocumentIDs, infoTable);
+												for (CDictionary::Iterator iterator =
+																chunkIDByDocumentID.getIterator();
+														iterator; iterator++) {
+													// Add and remember
+													SInt64	id = iterator.getValue().getSInt64();
+													idByDocumentID.set(iterator.getKey(), id);
+													mIDCache.add(documentType, iterator.getKey(), id);
+												}
+											}
+
+											return idByDocumentID;
+										}
+				CDocumentTypeInfoTable::DocumentIDByID
+									getDocumentIDByID(const CString& documentType, const TArray<CString>& documentIDs)
+										{
+											// Resolve ids
+											CDictionary	idByDocumentID = getIDByDocumentID(documentType, documentIDs);
+
+											// Compose reverse map
+											CDocumentTypeInfoTable::DocumentIDByID	documentIDByID;
+											for (CDictionary::Iterator iterator = idByDocumentID.getIterator();
+													iterator; iterator++)
+												// Add
+												documentIDByID.set(iterator.getValue().getSInt64(), iterator.getKey());
+
+											return documentIDByID;
+										}
+				UInt32				getNextRevision(const CString& documentType, bool isNewDocument = false)
 										{
 											// Compose next revision
 											const	OR<TNumber<UInt32> >	currentRevision =
@@ -2329,78 +3856,291 @@ class CMDSSQLiteDatabaseManager::Internals {
 																					currentRevision.hasReference() ?
 																							**currentRevision + 1 : 1;
 
+											// Compose document count.  It is written along with the revision so
+											//	creating a document stays a single Documents table write.
+											const	OR<TNumber<UInt32> >	currentDocumentCount =
+																					mDocumentCountByDocumentType
+																							.get(documentType);
+													UInt32					documentCount =
+																					currentDocumentCount.hasReference() ?
+																							**currentDocumentCount : 0;
+											if (isNewDocument)
+												// One more
+												documentCount++;
+
 											// Check for batch
 											const	OR<BatchInfo>	batchInfo =
-																			mBatchInfoByThreadRef[
-																					CThread::getCurrentRef()];
+																			mBatchInfoByThread.get();
 											if (batchInfo.hasReference())
 												// Update batchinfo
-												batchInfo->noteDocumentTypeNeedingLastRevisionWrite(documentType);
-											else
+												batchInfo->noteDocumentTypeNeedingLastRevisionWrite(documentType,
+														currentRevision, currentDocumentCount);
+											else {
 												// Update
-												CDocumentsTable::set(nextRevision, documentType, mDocumentsTable);
+												CDocumentsTable::set(nextRevision, documentCount, documentType,
+														mDocumentsTable);
+												noteWrite();
+											}
 
 											// Store
 											mDocumentLastRevisionByDocumentType.set(documentType,
 													TNumber<UInt32>(nextRevision));
+											mDocumentCountByDocumentType.set(documentType,
+													TNumber<UInt32>(documentCount));
 
 											return nextRevision;
 										}
+				void				loadCollectionDocumentCount(const CString& name,
+											const CSQLiteTable& collectionContentsTable)
+										{
+											// Check if have stored count
+											OV<UInt32>	documentCount =
+																CCollectionsTable::getDocumentCount(name,
+																		mCollectionsTable);
+											if (!documentCount.hasValue()) {
+												// Count once for collections stored before counts were maintained
+												documentCount.setValue(collectionContentsTable.count());
+												CCollectionsTable::update(name, OV<UInt32>(), *documentCount,
+														mCollectionsTable);
+											}
+
+											// Store
+											mCollectionDocumentCountByName.set(name, TNumber<UInt32>(*documentCount));
+										}
+				void				rollBack(const BatchInfo& batchInfo,
+											const TDictionary<TNumber<UInt32> >& previousCollectionDocumentCountByName)
+										{
+											// Restore document type last revisions and counts
+											for (TSet<CString>::Iterator iterator =
+															batchInfo.getDocumentLastRevisionTypesNeedingWrite()
+																	.getIterator();
+													iterator; iterator++) {
+												// Restore.  Document types new in the batch had no values.
+												if (batchInfo.getPreviousLastRevisionByType().contains(*iterator))
+													// Restore last revision
+													mDocumentLastRevisionByDocumentType.set(*iterator,
+															*batchInfo.getPreviousLastRevisionByType()[*iterator]);
+												else
+													// Remove last revision
+													mDocumentLastRevisionByDocumentType.remove(*iterator);
+												if (batchInfo.getPreviousDocumentCountByType().contains(*iterator))
+													// Restore document count
+													mDocumentCountByDocumentType.set(*iterator,
+															*batchInfo.getPreviousDocumentCountByType()[*iterator]);
+												else
+													// Remove document count
+													mDocumentCountByDocumentType.remove(*iterator);
+											}
+
+											// Restore collection document counts
+											for (TDictionary<TNumber<UInt32> >::Iterator iterator =
+															previousCollectionDocumentCountByName.getIterator();
+													iterator; iterator++)
+												// Restore
+												mCollectionDocumentCountByName.set(iterator.getKey(),
+														iterator.getValue());
+
+											// Drop ids of discarded rows as SQLite may hand them out again
+											TSet<CString>	createdDocumentTypes =
+																	batchInfo.getCreatedDocumentIDsByDocumentType()
+																			.getKeys();
+											for (TSet<CString>::Iterator documentTypeIterator =
+															createdDocumentTypes.getIterator();
+													documentTypeIterator; documentTypeIterator++)
+												// Iterate document IDs
+												for (TArray<CString>::Iterator iterator =
+																batchInfo.getCreatedDocumentIDsByDocumentType()[
+																		*documentTypeIterator]->getIterator();
+														iterator; iterator++)
+													// Remove
+													mIDCache.remove(*documentTypeIterator, *iterator);
+
+											// Drop tables that were created in the batch
+											for (TSet<CString>::Iterator iterator =
+															batchInfo.getDocumentTypesWithNewTables().getIterator();
+													iterator; iterator++)
+												// Remove
+												mDocumentTablesByDocumentType.remove(*iterator);
+										}
+				void				noteWrite()
+										{
+											// Check for checkpoint thread
+											if (mWALCheckpointThread.hasValue())
+												// Note
+												(*mWALCheckpointThread)->noteWrite();
+										}
 
-		static	void				cacheUpdate(const CString& name, const OV<ValueInfoByID>& valueInfoByID,
+		static	OV<SError>			cacheUpdate(const CString& name, const OV<ValueInfoByID>& valueInfoByID,
 											const IDArray& removedIDs, const OV<UInt32>& lastRevision,
 											Internals* internals)
 										{
 											// Update tables
-											CCacheContentsTable::update(valueInfoByID, removedIDs,
-													*internals->mCacheTablesByName[name]);
+											OV<SError>	error =
+																CCacheContentsTable::update(valueInfoByID, removedIDs,
+																		internals->mDatabase,
+																		*internals->mCacheTablesByName[name]);
+											ReturnErrorIfError(error);
+
 											if (lastRevision.hasValue())
 												// Update Caches table
 												CCachesTable::update(name, *lastRevision, internals->mCachesTable);
+
+											return OV<SError>();
 										}
 		static	void				collectionUpdate(const CString& name, const OV<IDArray >& includedIDs,
 											const OV<IDArray >& notIncludedIDs, const OV<UInt32>& lastRevision,
 											Internals* internals)
 										{
 											// Update tables
-											CCollectionContentsTable::update(includedIDs, notIncludedIDs,
-													*internals->mCollectionTablesByName[name]);
-											if (lastRevision.hasValue())
+											SInt32	documentCountDelta =
+															CCollectionContentsTable::update(includedIDs,
+																	notIncludedIDs,
+																	*internals->mCollectionTablesByName[name]);
+											if (lastRevision.hasValue() || (documentCountDelta != 0)) {
+												// Update document count
+												UInt32	documentCount =
+																**internals->mCollectionDocumentCountByName.get(name) +
+																		documentCountDelta;
+												internals->mCollectionDocumentCountByName.set(name,
+														TNumber<UInt32>(documentCount));
+
 												// Update Collections table
-												CCollectionsTable::update(name, *lastRevision,
+												CCollectionsTable::update(name, lastRevision, documentCount,
 														internals->mCollectionsTable);
+											}
 										}
-		static	void				indexUpdate(const CString& name, const OV<TArray<IndexKeysInfo> >& indexKeysInfos,
+		static	OV<SError>			indexUpdate(const CString& name,
+											const OV<TArray<IndexKeysInfo> >& indexKeysInfos,
 											const OV<IDArray >& removedIDs, const OV<UInt32>& lastRevision,
 											Internals* internals)
 										{
 											// Update tables
-											CIndexContentsTable::update(indexKeysInfos, removedIDs,
-													*internals->mIndexTablesByName[name]);
+											OV<SError>	error =
+																CIndexContentsTable::update(indexKeysInfos, removedIDs,
+																		internals->mDatabase,
+																		*internals->mIndexTablesByName[name]);
+											ReturnErrorIfError(error);
+
 											if (lastRevision.hasValue())
 												// Update Indexes table
 												CIndexesTable::update(name, *lastRevision,
 														internals->mIndexesTable);
+
+											return OV<SError>();
 										}
 
-	private:
-		static	OV<SError>			storeDocumentLastRevision(const CSQLiteResultsRow& resultsRow, Internals* internals)
+		static	CSQLiteDatabase::TransactionResult
+									batch(BatchTransactionInfo* batchTransactionInfo)
 										{
 											// Setup
-											CDocumentsTable::Info	documentsTableInfo(resultsRow);
+											Internals&	internals = batchTransactionInfo->mInternals;
+
+											internals.mBatchInfoByThread.set(BatchInfo());
+
+											// Call proc
+											batchTransactionInfo->mBatchProc(batchTransactionInfo->mUserData);
+
+											// Commit changes
+											BatchInfo	batchInfo = *internals.mBatchInfoByThread.get();
+											internals.mBatchInfoByThread.remove();
+
+											TNDictionary<TNumber<UInt32> >	previousCollectionDocumentCountByName;
+											if (batchInfo.getError().hasValue()) {
+												// A direct write failed
+												batchTransactionInfo->mError = batchInfo.getError();
+												internals.rollBack(batchInfo, previousCollectionDocumentCountByName);
+
+												return CSQLiteDatabase::kTransactionResultRollback;
+											}
+
+											for (TSet<CString>::Iterator iterator =
+															batchInfo.getDocumentLastRevisionTypesNeedingWrite()
+																	.getIterator();
+													iterator; iterator++)
+												// Update
+												CDocumentsTable::set(
+														**internals.mDocumentLastRevisionByDocumentType.get(*iterator),
+														**internals.mDocumentCountByDocumentType.get(*iterator),
+														*iterator, internals.mDocumentsTable);
+											for (TDictionary<CacheUpdateInfo>::Iterator iterator =
+															batchInfo.getCacheUpdateInfoByName().getIterator();
+													iterator; iterator++) {
+												// Setup
+												const	CacheUpdateInfo&	cacheUpdateInfo = iterator.getValue();
+
+												// Update cache
+												batchTransactionInfo->mError =
+														cacheUpdate(iterator.getKey(),
+																cacheUpdateInfo.getValueInfoByID(),
+																cacheUpdateInfo.getRemovedIDs(),
+																cacheUpdateInfo.getLastRevision(), &internals);
+												if (batchTransactionInfo->mError.hasValue()) {
+													// Roll back
+													internals.rollBack(batchInfo,
+															previousCollectionDocumentCountByName);
+
+													return CSQLiteDatabase::kTransactionResultRollback;
+												}
+											}
+											for (TDictionary<CollectionUpdateInfo>::Iterator iterator =
+															batchInfo.getCollectionUpdateInfoByName().getIterator();
+													iterator; iterator++) {
+												// Setup
+												const	CollectionUpdateInfo&	collectionUpdateInfo = iterator.getValue();
+
+												// Note document count to restore on rollback
+												previousCollectionDocumentCountByName.set(iterator.getKey(),
+														*internals.mCollectionDocumentCountByName.get(
+																iterator.getKey()));
+
+												// Update collection
+												collectionUpdate(iterator.getKey(),
+														collectionUpdateInfo.getIncludedIDs(),
+														collectionUpdateInfo.getNotIncludedIDs(),
+														collectionUpdateInfo.getLastRevision(), &internals);
+											}
+											for (TDictionary<IndexUpdateInfo>::Iterator iterator =
+															batchInfo.getIndexUpdateInfoByName().getIterator();
+													iterator; iterator++) {
+												// Setup
+												const	IndexUpdateInfo&	indexUpdateInfo = iterator.getValue();
+
+												// Update index
+												batchTransactionInfo->mError =
+														indexUpdate(iterator.getKey(),
+																indexUpdateInfo.getIndexKeysInfos(),
+																indexUpdateInfo.getRemovedIDs(),
+																indexUpdateInfo.getLastRevision(), &internals);
+												if (batchTransactionInfo->mError.hasValue()) {
+													// Roll back
+													internals.rollBack(batchInfo,
+															previousCollectionDocumentCountByName);
+
+													return CSQLiteDatabase::kTransactionResultRollback;
+												}
+											}
+
+											return CSQLiteDatabase::kTransactionResultCommit;
+										}
 
-											// Update dictionary
-											internals->mDocumentLastRevisionByDocumentType.set(
-													documentsTableInfo.getDocumentType(),
-													TNumber<UInt32>(documentsTableInfo.getLastRevision()));
+	private:
+		static	OV<SError>			addDocumentsTableInfo(const CSQLiteResultsRow& resultsRow,
+											TNArray<CDocumentsTable::Info>* documentsTableInfos)
+										{
+											// Add
+											(*documentsTableInfos) += CDocumentsTable::Info(resultsRow);
 
 											return OV<SError>();
 										}
 
 	public:
 		CSQLiteDatabase 						mDatabase;
+		CMDSSQLite::PropertyMapEncoding			mPropertyMapEncoding;
+		CMDSSQLite::DateEncoding				mDateEncoding;
+		OV<I<CWALCheckpointThread> >			mWALCheckpointThread;
 
-		TNLockingDictionary<BatchInfo>			mBatchInfoByThreadRef;
+		TMDSBatchByThread<BatchInfo>			mBatchInfoByThread;
+		CLock									mBatchLock;
 
 		CSQLiteTable							mInternalsTable;
 
@@ -2412,10 +4152,13 @@ class CMDSSQLiteDatabaseManager::Internals {
 
 		CSQLiteTable							mCollectionsTable;
 		TNLockingDictionary<CSQLiteTable>		mCollectionTablesByName;
+		TNLockingDictionary<TNumber<UInt32> >	mCollectionDocumentCountByName;
 
 		CSQLiteTable							mDocumentsTable;
 		TNLockingDictionary<DocumentTables>		mDocumentTablesByDocumentType;
 		TNLockingDictionary<TNumber<UInt32> >	mDocumentLastRevisionByDocumentType;
+		TNLockingDictionary<TNumber<UInt32> >	mDocumentCountByDocumentType;
+		IDCache									mIDCache;
 
 		CSQLiteTable							mIndexesTable;
 		TNLockingDictionary<CSQLiteTable>		mIndexTablesByName;
@@ -2432,10 +4175,12 @@ class CMDSSQLiteDatabaseManager::Internals {
 // MARK: Lifecycle methods
 
 //----------------------------------------------------------------------------------------------------------------------
-CMDSSQLiteDatabaseManager::CMDSSQLiteDatabaseManager(const CFolder& folder, const CString& name)
+CMDSSQLiteDatabaseManager::CMDSSQLiteDatabaseManager(const CFolder& folder, const CString& name,
+		CMDSSQLite::DurabilityMode durabilityMode, const OV<CMDSSQLite::WALCheckpointInfo>& walCheckpointInfo,
+		CMDSSQLite::PropertyMapEncoding propertyMapEncoding, CMDSSQLite::DateEncoding dateEncoding)
 //----------------------------------------------------------------------------------------------------------------------
 {
-	mInternals = new Internals(folder, name);
+	mInternals = new Internals(folder, name, durabilityMode, walCheckpointInfo, propertyMapEncoding, dateEncoding);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -2454,6 +4199,13 @@ UInt32 CMDSSQLiteDatabaseManager::getVariableNumberLimit() const
 	return mInternals->mInfoTable.getVariableNumberLimit();
 }
 
+//----------------------------------------------------------------------------------------------------------------------
+CMDSSQLiteDatabaseManager::IDCacheInfo CMDSSQLiteDatabaseManager::getIDCacheInfo() const
+//----------------------------------------------------------------------------------------------------------------------
+{
+	return mInternals->mIDCache.getInfo();
+}
+
 //----------------------------------------------------------------------------------------------------------------------
 void CMDSSQLiteDatabaseManager::associationRegister(const CString& name, const CString& fromDocumentType,
 		const CString& toDocumentType)
@@ -2522,10 +4274,7 @@ TVResult<TArray<CMDSAssociation::Item> > CMDSSQLiteDatabaseManager::associationG
 //----------------------------------------------------------------------------------------------------------------------
 {
 	// Setup
-	Internals::DocumentTables&	fromDocumentTables = mInternals->getDocumentTables(fromDocumentType);
-	OV<SInt64>					fromID =
-										CDocumentTypeInfoTable::getID(fromDocumentID,
-												fromDocumentTables.getInfoTable());
+	OV<SInt64>	fromID = mInternals->getID(fromDocumentType, fromDocumentID);
 	if (!fromID.hasValue())
 		return TVResult<TArray<CMDSAssociation::Item> >(CMDSDocumentStorage::getUnknownDocumentIDError(fromDocumentID));
 
@@ -2558,13 +4307,11 @@ TVResult<TArray<CMDSAssociation::Item> > CMDSSQLiteDatabaseManager::associationG
 //----------------------------------------------------------------------------------------------------------------------
 {
 	// Setup
-	Internals::DocumentTables&	fromDocumentTables = mInternals->getDocumentTables(fromDocumentType);
-
-	Internals::DocumentTables&	toDocumentTables = mInternals->getDocumentTables(toDocumentType);
-	OV<SInt64>					toID = CDocumentTypeInfoTable::getID(toDocumentID, toDocumentTables.getInfoTable());
+	OV<SInt64>	toID = mInternals->getID(toDocumentType, toDocumentID);
 	if (!toID.hasValue())
 		return TVResult<TArray<CMDSAssociation::Item> >(CMDSDocumentStorage::getUnknownDocumentIDError(toDocumentID));
 
+	Internals::DocumentTables&	fromDocumentTables = mInternals->getDocumentTables(fromDocumentType);
 	CSQLiteTable&				associationContentsTable = *mInternals->mAssociationTablesByName.get(name);
 
 	// Get items
@@ -2593,11 +4340,10 @@ OV<UInt32> CMDSSQLiteDatabaseManager::associationGetCountFrom(const CString& nam
 //----------------------------------------------------------------------------------------------------------------------
 {
 	// Setup
-	Internals::DocumentTables&	documentTables = mInternals->getDocumentTables(fromDocumentType);
-	CSQLiteTable&				associationContentsTable = *mInternals->mAssociationTablesByName.get(name);
+	CSQLiteTable&	associationContentsTable = *mInternals->mAssociationTablesByName.get(name);
 
 	// Get id
-	OV<SInt64>	id = CDocumentTypeInfoTable::getID(fromDocumentID, documentTables.getInfoTable());
+	OV<SInt64>	id = mInternals->getID(fromDocumentType, fromDocumentID);
 	if (!id.hasValue())
 		return OV<UInt32>();
 
@@ -2610,11 +4356,10 @@ OV<UInt32> CMDSSQLiteDatabaseManager::associationGetCountTo(const CString& name,
 //----------------------------------------------------------------------------------------------------------------------
 {
 	// Setup
-	Internals::DocumentTables&	documentTables = mInternals->getDocumentTables(toDocumentType);
-	CSQLiteTable&				associationContentsTable = *mInternals->mAssociationTablesByName.get(name);
+	CSQLiteTable&	associationContentsTable = *mInternals->mAssociationTablesByName.get(name);
 
 	// Get id
-	OV<SInt64>	id = CDocumentTypeInfoTable::getID(toDocumentID, documentTables.getInfoTable());
+	OV<SInt64>	id = mInternals->getID(toDocumentType, toDocumentID);
 	if (!id.hasValue())
 		return OV<UInt32>();
 
@@ -2628,10 +4373,7 @@ OV<SError> CMDSSQLiteDatabaseManager::associationIterateDocumentInfosFrom(const
 //----------------------------------------------------------------------------------------------------------------------
 {
 	// Setup
-	Internals::DocumentTables&	fromDocumentTables = mInternals->getDocumentTables(fromDocumentType);
-	OV<SInt64>					fromID =
-										CDocumentTypeInfoTable::getID(fromDocumentID,
-												fromDocumentTables.getInfoTable());
+	OV<SInt64>	fromID = mInternals->getID(fromDocumentType, fromDocumentID);
 	if (!fromID.hasValue())
 		return OV<SError>(CMDSDocumentStorage::getUnknownDocumentIDError(fromDocumentID));
 
@@ -2656,8 +4398,7 @@ OV<SError> CMDSSQLiteDatabaseManager::associationIterateDocumentInfosTo(const CS
 //----------------------------------------------------------------------------------------------------------------------
 {
 	// Setup
-	Internals::DocumentTables&	toDocumentTables = mInternals->getDocumentTables(toDocumentType);
-	OV<SInt64>					toID = CDocumentTypeInfoTable::getID(toDocumentID, toDocumentTables.getInfoTable());
+	OV<SInt64>	toID = mInternals->getID(toDocumentType, toDocumentID);
 	if (!toID.hasValue())
 		return OV<SError>(CMDSDocumentStorage::getUnknownDocumentIDError(toDocumentID));
 
@@ -2676,25 +4417,78 @@ OV<SError> CMDSSQLiteDatabaseManager::associationIterateDocumentInfosTo(const CS
 }
 
 //----------------------------------------------------------------------------------------------------------------------
-void CMDSSQLiteDatabaseManager::associationUpdate(const CString& name, const TArray<CMDSAssociation::Update>& updates,
-		const CString& fromDocumentType, const CString& toDocumentType)
+OV<SError> CMDSSQLiteDatabaseManager::associationIterateDocumentInfosFrom(const CString& name,
+		const CString& fromDocumentID, const CString& fromDocumentType, const CString& toDocumentType,
+		const OV<SInt64>& afterID, UInt32 count, const DocumentInfo::ProcInfo& documentInfoProcInfo)
 //----------------------------------------------------------------------------------------------------------------------
 {
 	// Setup
-	Internals::DocumentTables&	fromDocumentTables = mInternals->getDocumentTables(fromDocumentType);
-	CDictionary					fromIDByDocumentID =
-										CDocumentTypeInfoTable::getIDByDocumentID(
-												CMDSAssociation::Update::getFromDocumentIDsArray(updates),
-												fromDocumentTables.getInfoTable());
+	OV<SInt64>	fromID = mInternals->getID(fromDocumentType, fromDocumentID);
+	if (!fromID.hasValue())
+		return OV<SError>(CMDSDocumentStorage::getUnknownDocumentIDError(fromDocumentID));
 
 	Internals::DocumentTables&	toDocumentTables = mInternals->getDocumentTables(toDocumentType);
-	CDictionary					toIDByDocumentID =
-										CDocumentTypeInfoTable::getIDByDocumentID(
-												CMDSAssociation::Update::getToDocumentIDsArray(updates),
-												toDocumentTables.getInfoTable());
+	CSQLiteTable&				associationContentsTable = *mInternals->mAssociationTablesByName.get(name);
+
+	// Iterate rows (seeks the fromID/toID index past the last row returned instead of stepping over skipped rows)
+	associationContentsTable.select(CDocumentTypeInfoTable::tableColumns(),
+			CSQLiteInnerJoin(associationContentsTable, CAssociationContentsTable::mToIDTableColumn,
+					toDocumentTables.getInfoTable(), CDocumentTypeInfoTable::mIDTableColumn),
+			afterID.hasValue() ?
+					CSQLiteWhere(CAssociationContentsTable::mFromIDTableColumn, SSQLiteValue(*fromID))
+							.addAnd(CAssociationContentsTable::mToIDTableColumn, CString(OSSTR(">")),
+									SSQLiteValue(*afterID)) :
+					CSQLiteWhere(CAssociationContentsTable::mFromIDTableColumn, SSQLiteValue(*fromID)),
+			CSQLiteOrderBy(CAssociationContentsTable::mToIDTableColumn), CSQLiteLimit(OV<UInt32>(count)),
+			(CSQLiteResultsRow::Proc) CDocumentTypeInfoTable::callDocumentInfoProcInfo, (void*) &documentInfoProcInfo);
 
+	return OV<SError>();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+OV<SError> CMDSSQLiteDatabaseManager::associationIterateDocumentInfosTo(const CString& name,
+		const CString& toDocumentID, const CString& toDocumentType, const CString& fromDocumentType,
+		const OV<SInt64>& afterID, UInt32 count, const DocumentInfo::ProcInfo& documentInfoProcInfo)
+//----------------------------------------------------------------------------------------------------------------------
+{
+	// Setup
+	OV<SInt64>	toID = mInternals->getID(toDocumentType, toDocumentID);
+	if (!toID.hasValue())
+		return OV<SError>(CMDSDocumentStorage::getUnknownDocumentIDError(toDocumentID));
+
+	Internals::DocumentTables&	fromDocumentTables = mInternals->getDocumentTables(fromDocumentType);
 	CSQLiteTable&				associationContentsTable = *mInternals->mAssociationTablesByName.get(name);
 
+	// Iterate rows
+	associationContentsTable.select(CDocumentTypeInfoTable::tableColumns(),
+			CSQLiteInnerJoin(associationContentsTable, CAssociationContentsTable::mFromIDTableColumn,
+					fromDocumentTables.getInfoTable(), CDocumentTypeInfoTable::mIDTableColumn),
+			afterID.hasValue() ?
+					CSQLiteWhere(CAssociationContentsTable::mToIDTableColumn, SSQLiteValue(*toID))
+							.addAnd(CAssociationContentsTable::mFromIDTableColumn, CString(OSSTR(">")),
+									SSQLiteValue(*afterID)) :
+					CSQLiteWhere(CAssociationContentsTable::mToIDTableColumn, SSQLiteValue(*toID)),
+			CSQLiteOrderBy(CAssociationContentsTable::mFromIDTableColumn), CSQLiteLimit(OV<UInt32>(count)),
+			(CSQLiteResultsRow::Proc) CDocumentTypeInfoTable::callDocumentInfoProcInfo, (void*) &documentInfoProcInfo);
+
+	return OV<SError>();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+OV<SError> CMDSSQLiteDatabaseManager::associationUpdate(const CString& name,
+		const TArray<CMDSAssociation::Update>& updates, const CString& fromDocumentType, const CString& toDocumentType)
+//----------------------------------------------------------------------------------------------------------------------
+{
+	// Setup
+	CDictionary		fromIDByDocumentID =
+							mInternals->getIDByDocumentID(fromDocumentType,
+									CMDSAssociation::Update::getFromDocumentIDsArray(updates));
+	CDictionary		toIDByDocumentID =
+							mInternals->getIDByDocumentID(toDocumentType,
+									CMDSAssociation::Update::getToDocumentIDsArray(updates));
+
+	CSQLiteTable&	associationContentsTable = *mInternals->mAssociationTablesByName.get(name);
+
 	// Update Association
 	TNArray<CAssociationContentsTable::Item>	addAssociationContentsTableItems;
 	TNArray<CAssociationContentsTable::Item>	removeAssociationContentsTableItems;
@@ -2712,8 +4506,22 @@ void CMDSSQLiteDatabaseManager::associationUpdate(const CString& name, const TAr
 					CAssociationContentsTable::Item(
 							fromIDByDocumentID.getSInt64(iterator->getItem().getFromDocumentID()),
 							toIDByDocumentID.getSInt64(iterator->getItem().getToDocumentID()));
-	CAssociationContentsTable::remove(removeAssociationContentsTableItems, associationContentsTable);
-	CAssociationContentsTable::add(addAssociationContentsTableItems, associationContentsTable);
+	OV<SError>	error =
+						CAssociationContentsTable::remove(removeAssociationContentsTableItems, mInternals->mDatabase,
+								associationContentsTable);
+	if (!error.hasValue())
+		// Add
+		error =
+				CAssociationContentsTable::add(addAssociationContentsTableItems, mInternals->mDatabase,
+						associationContentsTable);
+
+	// Check if in batch
+	const	OR<Internals::BatchInfo>	batchInfo = mInternals->mBatchInfoByThread.get();
+	if (error.hasValue() && batchInfo.hasReference())
+		// Note error so the batch gets rolled back
+		batchInfo->noteError(*error);
+
+	return error;
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -2723,15 +4531,14 @@ TVResult<SValue> CMDSSQLiteDatabaseManager::associationDetail(const I<CMDSAssoci
 //----------------------------------------------------------------------------------------------------------------------
 {
 	// Preflight
-	Internals::DocumentTables&				fromDocumentTables =
-													mInternals->getDocumentTables(association->getFromDocumentType());
+	TNSet<CString>							fromDocumentIDsSet(fromDocumentIDs);
 	CDocumentTypeInfoTable::DocumentIDByID	fromDocumentIDByID =
-													CDocumentTypeInfoTable::getDocumentIDByID(fromDocumentIDs,
-															fromDocumentTables.getInfoTable());
-	if (fromDocumentIDByID.getCount() < fromDocumentIDs.getCount()) {
+													mInternals->getDocumentIDByID(association->getFromDocumentType(),
+															fromDocumentIDs);
+	if (fromDocumentIDByID.getCount() < fromDocumentIDsSet.getCount()) {
 		// Did not resolve all documentIDs
 				TNSet<CString>	notFoundFromDocumentIDs =
-										TNSet<CString>(fromDocumentIDs).getDifference(fromDocumentIDByID.getValues());
+										fromDocumentIDsSet.getDifference(fromDocumentIDByID.getValues());
 		const	CString&		documentID = *notFoundFromDocumentIDs.getAny();
 
 		return TVResult<SValue>(CMDSDocumentStorage::getUnknownDocumentIDError(documentID));
@@ -2784,16 +4591,18 @@ TVResult<SValue> CMDSSQLiteDatabaseManager::associationSum(const I<CMDSAssociati
 //----------------------------------------------------------------------------------------------------------------------
 {
 	// Preflight
-	Internals::DocumentTables&	fromDocumentTables = mInternals->getDocumentTables(association->getFromDocumentType());
+	CDictionary				fromIDByDocumentID =
+									mInternals->getIDByDocumentID(association->getFromDocumentType(), fromDocumentIDs);
 
-	TNArray<SSQLiteValue>		fromIDs;
-	for (TArray<CString>::Iterator iterator = fromDocumentIDs.getIterator(); iterator; iterator++) {
+	// Each fromID is only summed once, even when it lands in different chunks
+	TNSet<CString>			fromDocumentIDsSet(fromDocumentIDs);
+	TNArray<SSQLiteValue>	fromIDs;
+	for (TSet<CString>::Iterator iterator = fromDocumentIDsSet.getIterator(); iterator; iterator++) {
 		// Get fromID
-		OV<SInt64>	fromID = CDocumentTypeInfoTable::getID(*iterator, fromDocumentTables.getInfoTable());
-		if (!fromID.hasValue())
+		if (!fromIDByDocumentID.contains(*iterator))
 			// Did not resolve all documentIDs
 			return TVResult<SValue>(CMDSDocumentStorage::getUnknownDocumentIDError(*iterator));
-		fromIDs += SSQLiteValue(*fromID);
+		fromIDs += SSQLiteValue(fromIDByDocumentID.getSInt64(*iterator));
 	}
 
 	// Setup
@@ -2803,17 +4612,37 @@ TVResult<SValue> CMDSSQLiteDatabaseManager::associationSum(const I<CMDSAssociati
 	CSQLiteTable&				cacheContentsTable = *mInternals->mCacheTablesByName.get(cache->getName());
 	TArray<CSQLiteTableColumn>	cacheContentsTableColumns = cacheContentsTable.getTableColumns(cachedValueNames);
 
-	// Sum
-	TVResult<CDictionary>	info =
-									associationContentsTable.sum(cacheContentsTableColumns,
-											CSQLiteInnerJoin(associationContentsTable,
-													CAssociationContentsTable::mToIDTableColumn, cacheContentsTable,
-													CCacheContentsTable::mIDTableColumn),
-											CSQLiteWhere(CAssociationContentsTable::mFromIDTableColumn, fromIDs),
-											true);
-	ReturnValueIfResultError(info, TVResult<SValue>(info.getError()));
-
-	return TVResult<SValue>(SValue(*info));
+	UInt32						variableNumberLimit = associationContentsTable.getVariableNumberLimit();
+
+	// Sum in chunks so each statement binds no more fromIDs than the variable number limit.  Always sum at least once
+	//	so the results have the same keys when there are no fromIDs.
+	CDictionary	results;
+	for (UInt32 startIndex = 0; (startIndex == 0) || (startIndex < fromIDs.getCount());
+			startIndex += variableNumberLimit) {
+		// Setup
+		TNArray<SSQLiteValue>	chunkFromIDs;
+		for (UInt32 i = startIndex; (i < fromIDs.getCount()) && (i < (startIndex + variableNumberLimit)); i++)
+			// Add
+			chunkFromIDs += fromIDs[i];
+
+		// Sum chunk
+		TVResult<CDictionary>	info =
+										associationContentsTable.sum(cacheContentsTableColumns,
+												CSQLiteInnerJoin(associationContentsTable,
+														CAssociationContentsTable::mToIDTableColumn,
+														cacheContentsTable, CCacheContentsTable::mIDTableColumn),
+												CSQLiteWhere(CAssociationContentsTable::mFromIDTableColumn,
+														chunkFromIDs),
+												true);
+		ReturnValueIfResultError(info, TVResult<SValue>(info.getError()));
+
+		// Add partial sums
+		for (CDictionary::Iterator iterator = info->getIterator(); iterator; iterator++)
+			// Add
+			results.set(iterator.getKey(), results.getSInt64(iterator.getKey()) + info->getSInt64(iterator.getKey()));
+	}
+
+	return TVResult<SValue>(SValue(results));
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -2893,11 +4722,12 @@ TVResult<TArray<CDictionary> > CMDSSQLiteDatabaseManager::cacheGetValues(
 	CDocumentTypeInfoTable::DocumentIDByID	documentIDByID;
 	if (documentIDs.hasValue()) {
 		// Setup
-		documentIDByID = CDocumentTypeInfoTable::getDocumentIDByID(*documentIDs, documentTables.getInfoTable());
+		TNSet<CString>	documentIDsSet(*documentIDs);
+		documentIDByID = mInternals->getDocumentIDByID(cache->getDocumentType(), *documentIDs);
 
-		if (documentIDByID.getCount() < documentIDs->getCount()) {
+		if (documentIDByID.getCount() < documentIDsSet.getCount()) {
 			// Did not resolve all documentIDs
-			CString	documentID = *TNSet<CString>(*documentIDs).getDifference(documentIDByID.getValues()).getAny();
+			CString	documentID = *documentIDsSet.getDifference(documentIDByID.getValues()).getAny();
 
 			return TVResult<TArray<CDictionary> >(CMDSDocumentStorage::getUnknownDocumentIDError(documentID));
 		}
@@ -2934,18 +4764,20 @@ TVResult<TArray<CDictionary> > CMDSSQLiteDatabaseManager::cacheGetValues(
 }
 
 //----------------------------------------------------------------------------------------------------------------------
-void CMDSSQLiteDatabaseManager::cacheUpdate(const CString& name, const OV<ValueInfoByID>& valueInfoByID,
+OV<SError> CMDSSQLiteDatabaseManager::cacheUpdate(const CString& name, const OV<ValueInfoByID>& valueInfoByID,
 		const IDArray& removedIDs, const OV<UInt32>& lastRevision)
 //----------------------------------------------------------------------------------------------------------------------
 {
 	// Check if in batch
-	const	OR<Internals::BatchInfo>	batchInfo = mInternals->mBatchInfoByThreadRef[CThread::getCurrentRef()];
-	if (batchInfo.hasReference())
+	const	OR<Internals::BatchInfo>	batchInfo = mInternals->mBatchInfoByThread.get();
+	if (batchInfo.hasReference()) {
 		// Update batch info
 		batchInfo->noteCacheUpdate(name, valueInfoByID, removedIDs, lastRevision);
-	else
+
+		return OV<SError>();
+	} else
 		// Update
-		Internals::cacheUpdate(name, valueInfoByID, removedIDs, lastRevision, mInternals);
+		return Internals::cacheUpdate(name, valueInfoByID, removedIDs, lastRevision, mInternals);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -3006,6 +4838,9 @@ UInt32 CMDSSQLiteDatabaseManager::collectionRegister(const CString& name, const
 		collectionContentsTable.create();
 	}
 
+	// Load document count
+	mInternals->loadCollectionDocumentCount(name, collectionContentsTable);
+
 	return lastRevision;
 }
 
@@ -3020,6 +4855,7 @@ OV<CollectionInfo> CMDSSQLiteDatabaseManager::collectionInfo(const CString& name
 		CSQLiteTable	collectionContentsTable =
 								CCollectionContentsTable::in(mInternals->mDatabase, name, mInternals->mInternalsTable);
 		mInternals->mCollectionTablesByName.set(name, collectionContentsTable);
+		mInternals->loadCollectionDocumentCount(name, collectionContentsTable);
 	}
 
 	return collectionInfo;
@@ -3030,7 +4866,7 @@ UInt32 CMDSSQLiteDatabaseManager::collectionGetDocumentCount(const CString& name
 //----------------------------------------------------------------------------------------------------------------------
 {
 	// Return count
-	return mInternals->mCollectionTablesByName.get(name)->count();
+	return **mInternals->mCollectionDocumentCountByName.get(name);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -3050,13 +4886,42 @@ void CMDSSQLiteDatabaseManager::collectionIterateDocumentInfos(const CString& na
 			(CSQLiteResultsRow::Proc) CDocumentTypeInfoTable::callDocumentInfoProcInfo, (void*) &documentInfoProcInfo);
 }
 
+//----------------------------------------------------------------------------------------------------------------------
+void CMDSSQLiteDatabaseManager::collectionIterateDocumentInfos(const CString& name, const CString& documentType,
+		const OV<SInt64>& afterID, UInt32 count, const DocumentInfo::ProcInfo& documentInfoProcInfo)
+//----------------------------------------------------------------------------------------------------------------------
+{
+	// Setup
+	Internals::DocumentTables&	documentTables = mInternals->getDocumentTables(documentType);
+	CSQLiteTable&				collectionContentsTable = *mInternals->mCollectionTablesByName.get(name);
+
+	// Iterate rows
+	if (afterID.hasValue())
+		// Continue after the last row returned
+		collectionContentsTable.select(
+				CSQLiteInnerJoin(collectionContentsTable, CCollectionContentsTable::mIDTableColumn,
+						documentTables.getInfoTable()),
+				CSQLiteWhere(CCollectionContentsTable::mIDTableColumn, CString(OSSTR(">")), SSQLiteValue(*afterID)),
+				CSQLiteOrderBy(CCollectionContentsTable::mIDTableColumn), CSQLiteLimit(OV<UInt32>(count)),
+				(CSQLiteResultsRow::Proc) CDocumentTypeInfoTable::callDocumentInfoProcInfo,
+				(void*) &documentInfoProcInfo);
+	else
+		// Start at the beginning
+		collectionContentsTable.select(
+				CSQLiteInnerJoin(collectionContentsTable, CCollectionContentsTable::mIDTableColumn,
+						documentTables.getInfoTable()),
+				CSQLiteOrderBy(CCollectionContentsTable::mIDTableColumn), CSQLiteLimit(OV<UInt32>(count)),
+				(CSQLiteResultsRow::Proc) CDocumentTypeInfoTable::callDocumentInfoProcInfo,
+				(void*) &documentInfoProcInfo);
+}
+
 //----------------------------------------------------------------------------------------------------------------------
 void CMDSSQLiteDatabaseManager::collectionUpdate(const CString& name, const OV<IDArray >& includedIDs,
 		const OV<IDArray >& notIncludedIDs, const OV<UInt32>& lastRevision)
 //----------------------------------------------------------------------------------------------------------------------
 {
 	// Check if in batch
-	const	OR<Internals::BatchInfo>	batchInfo = mInternals->mBatchInfoByThreadRef[CThread::getCurrentRef()];
+	const	OR<Internals::BatchInfo>	batchInfo = mInternals->mBatchInfoByThread.get();
 	if (batchInfo.hasReference())
 		// Update batch info
 		batchInfo->noteCollectionUpdate(name, includedIDs, notIncludedIDs, lastRevision);
@@ -3072,7 +4937,7 @@ CMDSSQLiteDatabaseManager::DocumentCreateInfo CMDSSQLiteDatabaseManager::documen
 //----------------------------------------------------------------------------------------------------------------------
 {
 	// Setup
-	UInt32						revision = mInternals->getNextRevision(documentType);
+	UInt32						revision = mInternals->getNextRevision(documentType, true);
 	UniversalTime				creationUniversalTimeUse =
 										creationUniversalTime.hasValue() ?
 												*creationUniversalTime : SUniversalTime::getCurrent();
@@ -3084,7 +4949,15 @@ CMDSSQLiteDatabaseManager::DocumentCreateInfo CMDSSQLiteDatabaseManager::documen
 	// Add to database
 	SInt64	id = CDocumentTypeInfoTable::add(documentID, revision, documentTables.getInfoTable());
 	CDocumentTypeContentsTable::add(id, creationUniversalTimeUse, modificationUniversalTimeUse, propertyMap,
+			mInternals->mPropertyMapEncoding, documentTables.getContentsDateEncoding(),
 			documentTables.getContentsTable());
+	mInternals->mIDCache.add(documentType, documentID, id);
+
+	// Check for batch
+	const	OR<Internals::BatchInfo>	batchInfo = mInternals->mBatchInfoByThread.get();
+	if (batchInfo.hasReference())
+		// Note created
+		batchInfo->noteDocumentCreated(documentType, documentID);
 
 	return DocumentCreateInfo(id, revision, creationUniversalTimeUse, modificationUniversalTimeUse);
 }
@@ -3094,7 +4967,20 @@ UInt32 CMDSSQLiteDatabaseManager::documentCount(const CString& documentType)
 //----------------------------------------------------------------------------------------------------------------------
 {
 	// Return count
-	return mInternals->getDocumentTables(documentType).getInfoTable().count();
+	const	OR<TNumber<UInt32> >	documentCount = mInternals->mDocumentCountByDocumentType.get(documentType);
+
+	return documentCount.hasReference() ? **documentCount : 0;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+UInt32 CMDSSQLiteDatabaseManager::documentLastRevision(const CString& documentType)
+//----------------------------------------------------------------------------------------------------------------------
+{
+	// Return last revision
+	const	OR<TNumber<UInt32> >	documentLastRevision =
+											mInternals->mDocumentLastRevisionByDocumentType.get(documentType);
+
+	return documentLastRevision.hasReference() ? **documentLastRevision : 0;
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -3132,8 +5018,8 @@ void CMDSSQLiteDatabaseManager::documentContentInfoIterate(const CString& docume
 			CSQLiteWhere(CDocumentTypeInfoTable::mIDTableColumn,
 					SSQLiteValue::valuesFrom(IDArray(documentInfos,
 							(IDArray::MapProc) DocumentInfo::getIDFromDocumentInfo))),
-			(CSQLiteResultsRow::Proc) CDocumentTypeContentsTable::callDocumentContentInfoProcInfo,
-					(void*) &documentContentInfoProcInfo);
+			CDocumentTypeContentsTable::getDocumentContentInfoProc(documentTables.getContentsDateEncoding()),
+			(void*) &documentContentInfoProcInfo);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -3166,7 +5052,8 @@ CMDSSQLiteDatabaseManager::DocumentUpdateInfo CMDSSQLiteDatabaseManager::documen
 
 	// Update
 	CDocumentTypeInfoTable::update(id, revision, documentTables.getInfoTable());
-	CDocumentTypeContentsTable::update(id, modificationUniversalTime, propertyMap, documentTables.getContentsTable());
+	CDocumentTypeContentsTable::update(id, modificationUniversalTime, propertyMap, mInternals->mPropertyMapEncoding,
+			documentTables.getContentsDateEncoding(), documentTables.getContentsTable());
 
 	return DocumentUpdateInfo(revision, modificationUniversalTime);
 }
@@ -3180,7 +5067,8 @@ void CMDSSQLiteDatabaseManager::documentRemove(const CString& documentType, SInt
 
 	// Remove
 	CDocumentTypeInfoTable::remove(id, documentTables.getInfoTable());
-	CDocumentTypeContentsTable::remove(id, documentTables.getContentsTable());
+	CDocumentTypeContentsTable::remove(id, mInternals->mPropertyMapEncoding, documentTables.getContentsDateEncoding(),
+			documentTables.getContentsTable());
 	CDocumentTypeAttachmentsTable::remove(id, documentTables.getAttachmentsTable());
 }
 
@@ -3197,7 +5085,8 @@ CMDSSQLiteDatabaseManager::DocumentAttachmentInfo CMDSSQLiteDatabaseManager::doc
 
 	// Add attachment
 	CDocumentTypeInfoTable::update(id, revision, documentTables.getInfoTable());
-	CDocumentTypeContentsTable::update(id, modificationUniversalTime, documentTables.getContentsTable());
+	CDocumentTypeContentsTable::update(id, modificationUniversalTime, documentTables.getContentsDateEncoding(),
+			documentTables.getContentsTable());
 	UInt32	attachmentRevision =
 					CDocumentTypeAttachmentsTable::add(id, attachmentID, info, content,
 							documentTables.getAttachmentsTable());
@@ -3217,6 +5106,32 @@ CMDSDocument::AttachmentInfoByID CMDSSQLiteDatabaseManager::documentAttachmentIn
 	return CDocumentTypeAttachmentsTable::getDocumentAttachmentInfoByID(id, documentTables.getAttachmentsTable());
 }
 
+//----------------------------------------------------------------------------------------------------------------------
+CMDSSQLiteDatabaseManager::DocumentAttachmentInfoByIDByID CMDSSQLiteDatabaseManager::documentAttachmentInfoByIDByID(
+		const CString& documentType, const IDArray& ids)
+//----------------------------------------------------------------------------------------------------------------------
+{
+	// Setup
+	Internals::DocumentTables&		documentTables = mInternals->getDocumentTables(documentType);
+	UInt32							variableNumberLimit = getVariableNumberLimit();
+	DocumentAttachmentInfoByIDByID	documentAttachmentInfoByIDByID;
+
+	// Query in chunks that fit within the variable number limit
+	for (UInt32 startIndex = 0; startIndex < ids.getCount(); startIndex += variableNumberLimit) {
+		// Compose chunk
+		IDArray	chunkIDs;
+		for (UInt32 i = startIndex; (i < ids.getCount()) && (i < (startIndex + variableNumberLimit)); i++)
+			// Add
+			chunkIDs += ids[i];
+
+		// Query
+		CDocumentTypeAttachmentsTable::addDocumentAttachmentInfos(chunkIDs, documentTables.getAttachmentsTable(),
+				documentAttachmentInfoByIDByID);
+	}
+
+	return documentAttachmentInfoByIDByID;
+}
+
 //----------------------------------------------------------------------------------------------------------------------
 CData CMDSSQLiteDatabaseManager::documentAttachmentContent(const CString& documentType, SInt64 id,
 		const CString& attachmentID)
@@ -3248,7 +5163,8 @@ CMDSSQLiteDatabaseManager::DocumentAttachmentInfo CMDSSQLiteDatabaseManager::doc
 
 	// Update attachment
 	CDocumentTypeInfoTable::update(id, revision, documentTables.getInfoTable());
-	CDocumentTypeContentsTable::update(id, modificationUniversalTime, documentTables.getContentsTable());
+	CDocumentTypeContentsTable::update(id, modificationUniversalTime, documentTables.getContentsDateEncoding(),
+			documentTables.getContentsTable());
 	UInt32	attachmentRevision =
 					CDocumentTypeAttachmentsTable::update(id, attachmentID, updatedInfo, updatedContent,
 							documentTables.getAttachmentsTable());
@@ -3269,7 +5185,8 @@ CMDSSQLiteDatabaseManager::DocumentAttachmentRemoveInfo CMDSSQLiteDatabaseManage
 
 	// Remove attachment
 	CDocumentTypeInfoTable::update(id, revision, documentTables.getInfoTable());
-	CDocumentTypeContentsTable::update(id, modificationUniversalTime, documentTables.getContentsTable());
+	CDocumentTypeContentsTable::update(id, modificationUniversalTime, documentTables.getContentsDateEncoding(),
+			documentTables.getContentsTable());
 	CDocumentTypeAttachmentsTable::remove(id, attachmentID, documentTables.getAttachmentsTable());
 
 	return DocumentAttachmentRemoveInfo(revision, modificationUniversalTime);
@@ -3356,18 +5273,21 @@ void CMDSSQLiteDatabaseManager::indexIterateDocumentInfos(const CString& name, c
 }
 
 //----------------------------------------------------------------------------------------------------------------------
-void CMDSSQLiteDatabaseManager::indexUpdate(const CString& name, const OV<TArray<IndexKeysInfo> >& indexKeysInfos,
-		const OV<IDArray >& removedIDs, const OV<UInt32>& lastRevision)
+OV<SError> CMDSSQLiteDatabaseManager::indexUpdate(const CString& name,
+		const OV<TArray<IndexKeysInfo> >& indexKeysInfos, const OV<IDArray >& removedIDs,
+		const OV<UInt32>& lastRevision)
 //----------------------------------------------------------------------------------------------------------------------
 {
 	// Check if in batch
-	const	OR<Internals::BatchInfo>	batchInfo = mInternals->mBatchInfoByThreadRef[CThread::getCurrentRef()];
-	if (batchInfo.hasReference())
+	const	OR<Internals::BatchInfo>	batchInfo = mInternals->mBatchInfoByThread.get();
+	if (batchInfo.hasReference()) {
 		// Update batch info
 		batchInfo->noteIndexUpdate(name, indexKeysInfos, removedIDs, lastRevision);
-	else
+
+		return OV<SError>();
+	} else
 		// Update
-		Internals::indexUpdate(name, indexKeysInfos, removedIDs, lastRevision, mInternals);
+		return Internals::indexUpdate(name, indexKeysInfos, removedIDs, lastRevision, mInternals);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -3399,52 +5319,17 @@ void CMDSSQLiteDatabaseManager::internalSet(const CString& key, const OV<CString
 }
 
 //----------------------------------------------------------------------------------------------------------------------
-void CMDSSQLiteDatabaseManager::batch(BatchProc batchProc, void* userData)
+OV<SError> CMDSSQLiteDatabaseManager::batch(BatchProc batchProc, void* userData)
 //----------------------------------------------------------------------------------------------------------------------
 {
-	// Setup
-	mInternals->mBatchInfoByThreadRef.set(CThread::getCurrentRefAsString(), Internals::BatchInfo());
-
-	// Call proc
-	batchProc(userData);
-
-	// Commit changes
-	Internals::BatchInfo	batchInfo = *mInternals->mBatchInfoByThreadRef.get(CThread::getCurrentRefAsString());
-	mInternals->mBatchInfoByThreadRef.remove(CThread::getCurrentRefAsString());
-
-	for (TSet<CString>::Iterator iterator = batchInfo.getDocumentLastRevisionTypesNeedingWrite().getIterator();
-			iterator; iterator++)
-		// Update
-		CDocumentsTable::set(**mInternals->mDocumentLastRevisionByDocumentType.get(*iterator), *iterator,
-				mInternals->mDocumentsTable);
-	for (TDictionary<Internals::CacheUpdateInfo>::Iterator iterator =
-					batchInfo.getCacheUpdateInfoByName().getIterator();
-			iterator; iterator++) {
-		// Setup
-		const	Internals::CacheUpdateInfo&	cacheUpdateInfo = iterator.getValue();
-
-		// Update cache
-		Internals::cacheUpdate(iterator.getKey(), cacheUpdateInfo.getValueInfoByID(),
-				cacheUpdateInfo.getRemovedIDs(), cacheUpdateInfo.getLastRevision(), mInternals);
-	}
-	for (TDictionary<Internals::CollectionUpdateInfo>::Iterator iterator =
-					batchInfo.getCollectionUpdateInfoByName().getIterator();
-			iterator; iterator++) {
-		// Setup
-		const	Internals::CollectionUpdateInfo&	collectionUpdateInfo = iterator.getValue();
-
-		// Update collection
-		Internals::collectionUpdate(iterator.getKey(), collectionUpdateInfo.getIncludedIDs(),
-				collectionUpdateInfo.getNotIncludedIDs(), collectionUpdateInfo.getLastRevision(), mInternals);
-	}
-	for (TDictionary<Internals::IndexUpdateInfo>::Iterator iterator =
-					batchInfo.getIndexUpdateInfoByName().getIterator();
-			iterator; iterator++) {
-		// Setup
-		const	Internals::IndexUpdateInfo&	indexUpdateInfo = iterator.getValue();
-
-		// Update index
-		Internals::indexUpdate(iterator.getKey(), indexUpdateInfo.getIndexKeysInfos(), indexUpdateInfo.getRemovedIDs(),
-				indexUpdateInfo.getLastRevision(), mInternals);
-	}
+	// Perform all writes as a single transaction.  Batches can come from more than one thread (such as the background
+	//	view builder) and the connection only supports one transaction at a time.
+	Internals::BatchTransactionInfo	batchTransactionInfo(*mInternals, batchProc, userData);
+	mInternals->mBatchLock.lock();
+	mInternals->mDatabase.performAsTransaction((CSQLiteDatabase::TransactionProc) Internals::batch,
+			&batchTransactionInfo);
+	mInternals->mBatchLock.unlock();
+	mInternals->noteWrite();
+
+	return batchTransactionInfo.mError;
 }
@@ -5,6 +5,7 @@
 #pragma once
 
 #include "CMDSAssociation.h"
+#include "CMDSSQLite.h"
 #include "CMDSSQLiteDocumentBacking.h"
 #include "CSQLiteDatabase.h"
 #include "TMDSCache.h"
@@ -444,6 +445,38 @@ class CMDSSQLiteDatabaseManager {
 				UniversalTime	mModificationUniversalTime;
 		};
 
+	// IDCacheInfo
+	public:
+		struct IDCacheInfo {
+			// Methods
+			public:
+						// Lifecycle methods
+						IDCacheInfo(UInt32 count, UInt64 hitCount, UInt64 missCount, UInt64 evictionCount) :
+							mCount(count), mHitCount(hitCount), mMissCount(missCount), mEvictionCount(evictionCount)
+							{}
+						IDCacheInfo(const IDCacheInfo& other) :
+							mCount(other.mCount), mHitCount(other.mHitCount), mMissCount(other.mMissCount),
+									mEvictionCount(other.mEvictionCount)
+							{}
+
+						// Instance methods
+				UInt32	getCount() const
+							{ return mCount; }
+				UInt64	getHitCount() const
+							{ return mHitCount; }
+				UInt64	getMissCount() const
+							{ return mMissCount; }
+				UInt64	getEvictionCount() const
+							{ return mEvictionCount; }
+
+			// Properties
+			private:
+				UInt32	mCount;
+				UInt64	mHitCount;
+				UInt64	mMissCount;
+				UInt64	mEvictionCount;
+		};
+
 	// IndexInfo
 	public:
 		struct IndexInfo {
@@ -500,6 +533,9 @@ class CMDSSQLiteDatabaseManager {
 
 		typedef	TNKeyConvertibleDictionary<SInt64, CDictionary>	ValueInfoByID;
 
+		typedef	TNKeyConvertibleDictionary<SInt64, TNDictionary<CMDSDocument::AttachmentInfo> >
+																DocumentAttachmentInfoByIDByID;
+
 	// Classes
 	private:
 		class	Internals;
@@ -508,11 +544,17 @@ class CMDSSQLiteDatabaseManager {
 	public:
 													// Lifecycle methods
 													CMDSSQLiteDatabaseManager(const CFolder& folder,
-															const CString& name);
+															const CString& name,
+															CMDSSQLite::DurabilityMode durabilityMode,
+															const OV<CMDSSQLite::WALCheckpointInfo>&
+																	walCheckpointInfo,
+															CMDSSQLite::PropertyMapEncoding propertyMapEncoding,
+															CMDSSQLite::DateEncoding dateEncoding);
 													~CMDSSQLiteDatabaseManager();
 
 													// Instance methods
 				UInt32								getVariableNumberLimit() const;
+				IDCacheInfo							getIDCacheInfo() const;
 				
 				void								associationRegister(const CString& name,
 															const CString& fromDocumentType,
@@ -543,7 +585,18 @@ class CMDSSQLiteDatabaseManager {
 															const CString& fromDocumentType, UInt32 startIndex,
 															const OV<UInt32>& count,
 															const DocumentInfo::ProcInfo& documentInfoProcInfo);
-				void								associationUpdate(const CString& name,
+				OV<SError>							associationIterateDocumentInfosFrom(const CString& name,
+															const CString& fromDocumentID,
+															const CString& fromDocumentType,
+															const CString& toDocumentType, const OV<SInt64>& afterID,
+															UInt32 count,
+															const DocumentInfo::ProcInfo& documentInfoProcInfo);
+				OV<SError>							associationIterateDocumentInfosTo(const CString& name,
+															const CString& toDocumentID, const CString& toDocumentType,
+															const CString& fromDocumentType, const OV<SInt64>& afterID,
+															UInt32 count,
+															const DocumentInfo::ProcInfo& documentInfoProcInfo);
+				OV<SError>							associationUpdate(const CString& name,
 															const TArray<CMDSAssociation::Update>& updates,
 															const CString& fromDocumentType,
 															const CString& toDocumentType);
@@ -563,7 +616,7 @@ class CMDSSQLiteDatabaseManager {
 				TVResult<TArray<CDictionary> >		cacheGetValues(const I<TMDSCache<SInt64, ValueInfoByID> >& cache,
 															const TArray<CString>& valueNames,
 															const OV<TArray<CString> >& documentIDs);
-				void								cacheUpdate(const CString& name,
+				OV<SError>							cacheUpdate(const CString& name,
 															const OV<ValueInfoByID>& valueInfoByID,
 															const IDArray& removedIDs, const OV<UInt32>& lastRevision);
 
@@ -577,6 +630,10 @@ class CMDSSQLiteDatabaseManager {
 															const CString& documentType, UInt32 startIndex,
 															const OV<UInt32>& count,
 															const DocumentInfo::ProcInfo& documentInfoProcInfo);
+				void								collectionIterateDocumentInfos(const CString& name,
+															const CString& documentType, const OV<SInt64>& afterID,
+															UInt32 count,
+															const DocumentInfo::ProcInfo& documentInfoProcInfo);
 				void								collectionUpdate(const CString& name,
 															const OV<IDArray >& includedIDs,
 															const OV<IDArray >& notIncludedIDs,
@@ -588,6 +645,7 @@ class CMDSSQLiteDatabaseManager {
 															const OV<UniversalTime>& modificationUniversalTime,
 															const CDictionary& propertyMap);
 				UInt32								documentCount(const CString& documentType);
+				UInt32								documentLastRevision(const CString& documentType);
 				bool								documentTypeIsKnown(const CString& documentType);
 				void								documentInfoIterate(const CString& documentType,
 															const TArray<CString>& documentIDs,
@@ -606,6 +664,8 @@ class CMDSSQLiteDatabaseManager {
 				DocumentAttachmentInfo				documentAttachmentAdd(const CString& documentType, SInt64 id,
 														const CDictionary& info, const CData& content);
 				CMDSDocument::AttachmentInfoByID	documentAttachmentInfoByID(const CString& documentType, SInt64 id);
+				DocumentAttachmentInfoByIDByID		documentAttachmentInfoByIDByID(const CString& documentType,
+															const IDArray& ids);
 				CData								documentAttachmentContent(const CString& documentType, SInt64 id,
 															const CString& attachmentID);
 				DocumentAttachmentInfo				documentAttachmentUpdate(const CString& documentType, SInt64 id,
@@ -622,7 +682,7 @@ class CMDSSQLiteDatabaseManager {
 				void								indexIterateDocumentInfos(const CString& name,
 															const CString& documentType, const TArray<CString>& keys,
 															const DocumentInfo::KeyProcInfo& documentInfoKeyProcInfo);
-				void								indexUpdate(const CString& name,
+				OV<SError>							indexUpdate(const CString& name,
 															const OV<TArray<IndexKeysInfo> >& indexKeysInfos,
 															const OV<IDArray >& removedIDs,
 															const OV<UInt32>& lastRevision);
@@ -633,7 +693,7 @@ class CMDSSQLiteDatabaseManager {
 				OV<CString>							internalString(const CString& key);
 				void								internalSet(const CString& key, const OV<CString>& string);
 
-				void								batch(BatchProc batchProc, void* userData);
+				OV<SError>							batch(BatchProc batchProc, void* userData);
 
 	// Properties
 	private:
@@ -40,6 +40,70 @@ class CMDSSQLiteDocumentBacking::Internals {
 		TNDictionary<CMDSDocument::AttachmentInfo>	mDocumentAttachmentInfoByID;
 
 		CReadPreferringLock							mPropertiesLock;
+
+		static	UInt64								getByteCount(const CDictionary& dictionary)
+														{
+															// Sum keys and values
+															UInt64	byteCount = sizeof(CDictionary);
+															for (CDictionary::Iterator iterator =
+																			dictionary.getIterator();
+																	iterator; iterator++)
+																// Add item
+																byteCount +=
+																		iterator.getKey().getLength() +
+																				getByteCount(iterator.getValue());
+
+															return byteCount;
+														}
+		static	UInt64								getByteCount(const SValue& value)
+														{
+															// Check type
+															switch (value.getType()) {
+																case SValue::kTypeString:
+																	// String
+																	return sizeof(SValue) +
+																			value.getString().getLength();
+
+																case SValue::kTypeData:
+																	// Data
+																	return sizeof(SValue) +
+																			value.getData().getByteCount();
+
+																case SValue::kTypeDictionary:
+																	// Dictionary
+																	return sizeof(SValue) +
+																			getByteCount(value.getDictionary());
+
+																case SValue::kTypeArrayOfStrings: {
+																	// Array of strings
+																	UInt64	byteCount = sizeof(SValue);
+																	for (TArray<CString>::Iterator iterator =
+																					value.getArrayOfStrings()
+																							.getIterator();
+																			iterator; iterator++)
+																		// Add string
+																		byteCount +=
+																				sizeof(CString) + iterator->getLength();
+
+																	return byteCount; }
+
+																case SValue::kTypeArrayOfDictionaries: {
+																	// Array of dictionaries
+																	UInt64	byteCount = sizeof(SValue);
+																	for (TArray<CDictionary>::Iterator iterator =
+																					value.getArrayOfDictionaries()
+																							.getIterator();
+																			iterator; iterator++)
+																		// Add dictionary
+																		byteCount += getByteCount(*iterator);
+
+																	return byteCount; }
+
+																default:
+																	// Fixed size
+																	return sizeof(SValue);
+															}
+														}
 };
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -153,6 +217,22 @@ CMDSDocument::AttachmentInfoByID CMDSSQLiteDocumentBacking::getDocumentAttachmen
 }
 
 
+//----------------------------------------------------------------------------------------------------------------------
+UInt64 CMDSSQLiteDocumentBacking::getByteCount() const
+//----------------------------------------------------------------------------------------------------------------------
+{
+	// Estimate
+	mInternals->mPropertiesLock.lockForReading();
+	UInt64	byteCount =
+					sizeof(CMDSSQLiteDocumentBacking) + sizeof(Internals) + mInternals->mDocumentID.getLength() +
+							Internals::getByteCount(mInternals->mPropertyMap) +
+							mInternals->mDocumentAttachmentInfoByID.getKeyCount() *
+									sizeof(CMDSDocument::AttachmentInfo);
+	mInternals->mPropertiesLock.unlockForReading();
+
+	return byteCount;
+}
+
 //----------------------------------------------------------------------------------------------------------------------
 CMDSDocument::FullInfo CMDSSQLiteDocumentBacking::getDocumentFullInfo() const
 //----------------------------------------------------------------------------------------------------------------------
@@ -171,11 +251,9 @@ CMDSDocument::FullInfo CMDSSQLiteDocumentBacking::getDocumentFullInfo() const
 OV<SValue> CMDSSQLiteDocumentBacking::getValue(const CString& property) const
 //----------------------------------------------------------------------------------------------------------------------
 {
-	// Retrieve value
+	// Retrieve value with a single lookup (and without copying the property map)
 	mInternals->mPropertiesLock.lockForReading();
-	OV<SValue>	value =
-						mInternals->mPropertyMap.contains(property) ?
-								OV<SValue>(mInternals->mPropertyMap.getValue(property)) : OV<SValue>();
+	OV<SValue>	value = mInternals->mPropertyMap.getOValue(property);
 	mInternals->mPropertiesLock.unlockForReading();
 
 	return value;
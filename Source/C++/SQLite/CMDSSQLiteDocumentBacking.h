@@ -53,6 +53,8 @@ class CMDSSQLiteDocumentBacking {
 
 				CMDSDocument::FullInfo				getDocumentFullInfo() const;
 
+				UInt64								getByteCount() const;
+
 				OV<SValue>							getValue(const CString& property) const;
 				void								set(const CString& property, const OV<SValue>& value,
 															const CString& documentType,
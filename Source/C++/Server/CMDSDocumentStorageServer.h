@@ -67,13 +67,101 @@ class CMDSDocumentStorageServer : public CMDSDocumentStorage {
 				TArray<CMDSDocument::FullInfo>	mDocumentFullInfos;
 		};
 
+	// DocumentRevisionInfosPage
+	public:
+		struct DocumentRevisionInfosPage {
+			// Methods
+															// Lifecycle methods
+															DocumentRevisionInfosPage(
+																	const TArray<CMDSDocument::RevisionInfo>&
+																			documentRevisionInfos,
+																	const OV<CString>& continuationToken) :
+																mDocumentRevisionInfos(documentRevisionInfos),
+																		mContinuationToken(continuationToken)
+																{}
+															DocumentRevisionInfosPage(
+																	const DocumentRevisionInfosPage& other) :
+																mDocumentRevisionInfos(other.mDocumentRevisionInfos),
+																		mContinuationToken(other.mContinuationToken)
+																{}
+
+															// Instance methods
+				const	TArray<CMDSDocument::RevisionInfo>&	getDocumentRevisionInfos() const
+																{ return mDocumentRevisionInfos; }
+				const	OV<CString>&						getContinuationToken() const
+																{ return mContinuationToken; }
+			// Properties
+			private:
+				TArray<CMDSDocument::RevisionInfo>	mDocumentRevisionInfos;
+				OV<CString>							mContinuationToken;
+		};
+
+	// DocumentFullInfosPage
+	public:
+		struct DocumentFullInfosPage {
+			// Methods
+														// Lifecycle methods
+														DocumentFullInfosPage(
+																const TArray<CMDSDocument::FullInfo>& documentFullInfos,
+																const OV<CString>& continuationToken) :
+															mDocumentFullInfos(documentFullInfos),
+																	mContinuationToken(continuationToken)
+															{}
+														DocumentFullInfosPage(const DocumentFullInfosPage& other) :
+															mDocumentFullInfos(other.mDocumentFullInfos),
+																	mContinuationToken(other.mContinuationToken)
+															{}
+
+														// Instance methods
+				const	TArray<CMDSDocument::FullInfo>&	getDocumentFullInfos() const
+															{ return mDocumentFullInfos; }
+				const	OV<CString>&					getContinuationToken() const
+															{ return mContinuationToken; }
+			// Properties
+			private:
+				TArray<CMDSDocument::FullInfo>	mDocumentFullInfos;
+				OV<CString>						mContinuationToken;
+		};
+
+	// Status
+	public:
+		struct Status {
+			// Methods
+						// Lifecycle methods
+						Status(bool isUpToDate, UInt32 lastRevision, UInt32 documentLastRevision) :
+							mIsUpToDate(isUpToDate), mLastRevision(lastRevision),
+									mDocumentLastRevision(documentLastRevision)
+							{}
+						Status(const Status& other) :
+							mIsUpToDate(other.mIsUpToDate), mLastRevision(other.mLastRevision),
+									mDocumentLastRevision(other.mDocumentLastRevision)
+							{}
+
+						// Instance methods
+				bool	isUpToDate() const
+							{ return mIsUpToDate; }
+				UInt32	getLastRevision() const
+							{ return mLastRevision; }
+				UInt32	getDocumentLastRevision() const
+							{ return mDocumentLastRevision; }
+
+			// Properties
+			private:
+				bool	mIsUpToDate;
+				UInt32	mLastRevision;
+				UInt32	mDocumentLastRevision;
+		};
+
 	// Types
 	typedef	TVResult<TDictionary<CMDSDocument::FullInfo> >		DocumentFullInfoDictionaryResult;
 	typedef	TVResult<TArray<CMDSDocument::FullInfo> >			DocumentFullInfosResult;
+	typedef	TVResult<DocumentFullInfosPage>						DocumentFullInfosPageResult;
 	typedef	TVResult<DocumentFullInfosWithTotalCount>			DocumentFullInfosWithTotalCountResult;
 	typedef	TVResult<TDictionary<CMDSDocument::RevisionInfo> >	DocumentRevisionInfoDictionaryResult;
 	typedef	TVResult<TArray<CMDSDocument::RevisionInfo> >		DocumentRevisionInfosResult;
+	typedef	TVResult<DocumentRevisionInfosPage>					DocumentRevisionInfosPageResult;
 	typedef	TVResult<DocumentRevisionInfosWithTotalCount>		DocumentRevisionInfosWithTotalCountResult;
+	typedef	TVResult<Status>									StatusResult;
 
 	// Methods
 	public:
@@ -93,8 +181,28 @@ class CMDSDocumentStorageServer : public CMDSDocumentStorage {
 		virtual	DocumentFullInfosWithTotalCountResult		associationGetDocumentFullInfosTo(const CString& name,
 																	const CString& toDocumentID, UInt32 startIndex,
 																	const OV<UInt32>& count) const = 0;
+																// Keyset paged variants.  Pass no continuation token to
+																//	get the first page and the returned token to get the
+																//	next.  No token is returned once the last page has
+																//	been reached.
+		virtual	DocumentRevisionInfosPageResult				associationGetDocumentRevisionInfosPageFrom(
+																	const CString& name, const CString& fromDocumentID,
+																	const OV<CString>& continuationToken, UInt32 count)
+																	const = 0;
+		virtual	DocumentRevisionInfosPageResult				associationGetDocumentRevisionInfosPageTo(
+																	const CString& name, const CString& toDocumentID,
+																	const OV<CString>& continuationToken, UInt32 count)
+																	const = 0;
+		virtual	DocumentFullInfosPageResult					associationGetDocumentFullInfosPageFrom(
+																	const CString& name, const CString& fromDocumentID,
+																	const OV<CString>& continuationToken, UInt32 count)
+																	const = 0;
+		virtual	DocumentFullInfosPageResult					associationGetDocumentFullInfosPageTo(
+																	const CString& name, const CString& toDocumentID,
+																	const OV<CString>& continuationToken, UInt32 count)
+																	const = 0;
 
-		virtual	OV<SError>									cacheGetStatus(const CString& name) const = 0;
+		virtual	StatusResult								cacheGetStatus(const CString& name) const = 0;
 
 		virtual	DocumentRevisionInfosResult					collectionGetDocumentRevisionInfos(const CString& name,
 																	UInt32 startIndex, const OV<UInt32>& count) const
@@ -102,6 +210,13 @@ class CMDSDocumentStorageServer : public CMDSDocumentStorage {
 		virtual	DocumentFullInfosResult						collectionGetDocumentFullInfos(const CString& name,
 																	UInt32 startIndex, const OV<UInt32>& count) const
 																	= 0;
+		virtual	DocumentRevisionInfosPageResult				collectionGetDocumentRevisionInfosPage(
+																	const CString& name,
+																	const OV<CString>& continuationToken, UInt32 count)
+																	const = 0;
+		virtual	DocumentFullInfosPageResult					collectionGetDocumentFullInfosPage(const CString& name,
+																	const OV<CString>& continuationToken, UInt32 count)
+																	const = 0;
 
 		virtual	DocumentRevisionInfosResult					documentRevisionInfos(const CString& documentType,
 																	const TArray<CString>& documentIDs) const = 0;
@@ -124,7 +239,7 @@ class CMDSDocumentStorageServer : public CMDSDocumentStorage {
 																	const TArray<CMDSDocument::UpdateInfo>&
 																			documentUpdateInfos) = 0;
 
-		virtual	OV<SError>									indexGetStatus(const CString& name) const = 0;
+		virtual	StatusResult								indexGetStatus(const CString& name) const = 0;
 		virtual	DocumentRevisionInfoDictionaryResult		indexGetDocumentRevisionInfos(const CString& name,
 																	const TArray<CString>& keys) const = 0;
 		virtual	DocumentFullInfoDictionaryResult			indexGetDocumentFullInfos(const CString& name,
@@ -7,6 +7,8 @@
 #include "CMDSAssociation.h"
 #include "CUUID.h"
 
+#include <atomic>
+
 //----------------------------------------------------------------------------------------------------------------------
 // MARK: EMDSBatchResult
 enum EMDSBatchResult {
@@ -420,6 +422,20 @@ template <typename DB> class TMDSBatch {
 
 														return info;
 													}
+		TArray<CString>							documentIDsGet() const
+													{
+														// Setup
+														TNArray<CString>	documentIDs;
+
+														// Iterate changes
+														for (typename DocumentInfoByDocumentID::Iterator iterator =
+																		mDocumentInfoByDocumentID.getIterator();
+																iterator; iterator++)
+															// Add document ID
+															documentIDs += iterator.getKey();
+
+														return documentIDs;
+													}
 		TArray<CString>							documentIDsGet(const CString& documentType) const
 													{
 														// Setup
@@ -448,3 +464,82 @@ template <typename DB> class TMDSBatch {
 		DocumentInfoByDocumentID					mDocumentInfoByDocumentID;
 		TNArrayDictionary<CMDSAssociation::Update>	mAssociationUpdatesByAssociationName;
 };
+
+//----------------------------------------------------------------------------------------------------------------------
+// MARK: - TMDSBatchByThread
+
+// Tracks the batch (if any) in progress on each thread for a single document storage instance.  Lookups touch no lock
+//	and allocate nothing, and when no thread has a batch in progress they are a single relaxed atomic load.
+
+template <typename T> class TMDSBatchByThread {
+	// Node
+	private:
+		struct Node {
+			// Methods
+			public:
+				// Lifecycle methods
+				Node(const TMDSBatchByThread<T>* owner, const T& batch, Node* nextNode) :
+					mOwner(owner), mBatch(batch), mNextNode(nextNode)
+					{}
+
+			// Properties
+			public:
+				const	TMDSBatchByThread<T>*	mOwner;
+						T						mBatch;
+						Node*					mNextNode;
+		};
+
+	// Methods
+	public:
+					// Lifecycle methods
+					TMDSBatchByThread() : mActiveCount(0) {}
+
+					// Instance methods
+		void		set(const T& batch)
+						{
+							// Add node for the current thread
+							sFirstNode = new Node(this, batch, sFirstNode);
+							mActiveCount.fetch_add(1, std::memory_order_relaxed);
+						}
+		OR<T>		get() const
+						{
+							// Check if any batches are in progress.  A set() on this thread is always visible to a
+							//	get() on this thread so relaxed ordering is sufficient.
+							if (mActiveCount.load(std::memory_order_relaxed) == 0)
+								return OR<T>();
+
+							// Find node for the current thread
+							for (Node* node = sFirstNode; node != nil; node = node->mNextNode) {
+								// Check owner
+								if (node->mOwner == this)
+									// Found
+									return OR<T>(node->mBatch);
+							}
+
+							return OR<T>();
+						}
+		void		remove()
+						{
+							// Find node for the current thread
+							for (Node** nodePtr = &sFirstNode; *nodePtr != nil; nodePtr = &(*nodePtr)->mNextNode) {
+								// Check owner
+								if ((*nodePtr)->mOwner == this) {
+									// Remove
+									Node*	node = *nodePtr;
+									*nodePtr = node->mNextNode;
+									Delete(node);
+									mActiveCount.fetch_sub(1, std::memory_order_relaxed);
+
+									return;
+								}
+							}
+						}
+
+	// Properties
+	private:
+						std::atomic<UInt32>	mActiveCount;
+
+		static	thread_local	Node*				sFirstNode;
+};
+
+template <typename T> thread_local typename TMDSBatchByThread<T>::Node* TMDSBatchByThread<T>::sFirstNode = nil;
@@ -6,8 +6,322 @@
 
 #include "CMDSDocument.h"
 
+#include <atomic>
+
 //----------------------------------------------------------------------------------------------------------------------
-// MARK: TMDSDocumentBackingCache
+// MARK: TMDSClockCache
+
+// Holds values by key up to a count limit and an optional byte limit, spread across shards by key hash so lookups on
+//	different shards do not contend.  When over a limit, each shard evicts using the clock algorithm: references not
+//	touched since the hand last passed go, the rest get a second chance.
+
+template <typename T> class TMDSClockCache {
+	// Info
+	public:
+		struct Info {
+			// Methods
+			public:
+						// Lifecycle methods
+						Info(UInt32 count, UInt64 byteCount, UInt64 hitCount, UInt64 missCount,
+								UInt64 evictionCount) :
+							mCount(count), mByteCount(byteCount), mHitCount(hitCount), mMissCount(missCount),
+									mEvictionCount(evictionCount)
+							{}
+						Info(const Info& other) :
+							mCount(other.mCount), mByteCount(other.mByteCount), mHitCount(other.mHitCount),
+									mMissCount(other.mMissCount), mEvictionCount(other.mEvictionCount)
+							{}
+
+						// Instance methods
+				UInt32	getCount() const
+							{ return mCount; }
+				UInt64	getByteCount() const
+							{ return mByteCount; }
+				UInt64	getHitCount() const
+							{ return mHitCount; }
+				UInt64	getMissCount() const
+							{ return mMissCount; }
+				UInt64	getEvictionCount() const
+							{ return mEvictionCount; }
+
+			// Properties
+			private:
+				UInt32	mCount;
+				UInt64	mByteCount;
+				UInt64	mHitCount;
+				UInt64	mMissCount;
+				UInt64	mEvictionCount;
+		};
+
+	// Reference
+	private:
+		class Reference {
+			// Methods
+			public:
+						// Lifecycle methods
+						Reference(const T& value, UInt64 byteCount) :
+							mValue(value), mByteCount(byteCount), mWasReferenced(true)
+							{}
+						Reference(const Reference& other) :
+							mValue(other.mValue), mByteCount(other.mByteCount),
+									mWasReferenced(other.mWasReferenced.load(std::memory_order_relaxed))
+							{}
+
+						// Instance methods
+				void	noteWasReferenced() const
+							{
+								// Only write when changing so concurrent readers don't contend on the cache line
+								if (!mWasReferenced.load(std::memory_order_relaxed))
+									mWasReferenced.store(true, std::memory_order_relaxed);
+							}
+				bool	clearWasReferenced() const
+							{ return mWasReferenced.exchange(false, std::memory_order_relaxed); }
+				T&		getValue()
+							{ return mValue; }
+				UInt64	getByteCount() const
+							{ return mByteCount; }
+				void	setByteCount(UInt64 byteCount)
+							{ mByteCount = byteCount; }
+
+			// Properties
+			private:
+						T					mValue;
+						UInt64				mByteCount;
+				mutable	std::atomic<bool>	mWasReferenced;
+		};
+
+	// Shard
+	private:
+		struct Shard {
+			// Methods
+			public:
+						// Lifecycle methods
+						Shard() :
+							mLimit(0), mClockHand(0), mByteCount(0), mHitCount(0), mMissCount(0), mEvictionCount(0)
+							{}
+
+						// Instance methods
+				void	add(const CString& key, const T& value, UInt64 byteCount)
+							{
+								// Check for existing
+								const	OR<Reference>	reference = mReferenceByKey[key];
+								if (reference.hasReference())
+									// Replacing
+									mByteCount -= reference->getByteCount();
+								else
+									// New, so give it a place on the clock
+									mClockKeys += key;
+
+								// Store
+								mReferenceByKey.set(key, Reference(value, byteCount));
+								mByteCount += byteCount;
+							}
+				void	update(const CString& key, UInt64 byteCount)
+							{
+								// Check if have
+								const	OR<Reference>	reference = mReferenceByKey[key];
+								if (reference.hasReference()) {
+									// Re-account
+									mByteCount = mByteCount - reference->getByteCount() + byteCount;
+									reference->setByteCount(byteCount);
+								}
+							}
+				OR<T>	get(const CString& key)
+							{
+								// Look up
+								const	OR<Reference>	reference = mReferenceByKey[key];
+								if (!reference.hasReference()) {
+									// Miss
+									mMissCount.fetch_add(1, std::memory_order_relaxed);
+
+									return OR<T>();
+								}
+
+								// Hit
+								reference->noteWasReferenced();
+								mHitCount.fetch_add(1, std::memory_order_relaxed);
+
+								return OR<T>(reference->getValue());
+							}
+				void	remove(const CString& key)
+							{
+								// Check if have
+								const	OR<Reference>	reference = mReferenceByKey[key];
+								if (reference.hasReference()) {
+									// Remove.  The clock entry goes stale and is dropped on the next compaction.
+									mByteCount -= reference->getByteCount();
+									mReferenceByKey.remove(key);
+									compactClockIfNeeded();
+								}
+							}
+				void	evict()
+							{
+								// Advance the clock hand from where the previous call left it.  Two full turns
+								//	always clear every marker so the loop is bounded.
+								UInt32	stepsRemaining = mClockKeys.getCount() * 2;
+								while ((stepsRemaining-- > 0) &&
+										((mReferenceByKey.getCount() > mLimit) ||
+												(mByteLimit.hasValue() && (mByteCount > *mByteLimit)))) {
+									// Get key under the hand
+									if (mClockHand >= mClockKeys.getCount())
+										// Wrap
+										mClockHand = 0;
+									CString	key = mClockKeys[mClockHand++];
+
+									// Check reference
+									const	OR<Reference>	reference = mReferenceByKey[key];
+									if (reference.hasReference() && !reference->clearWasReferenced()) {
+										// Evict
+										mByteCount -= reference->getByteCount();
+										mReferenceByKey.remove(key);
+										mEvictionCount++;
+									}
+								}
+
+								// Drop stale clock entries as needed
+								compactClockIfNeeded();
+							}
+
+			private:
+				void	compactClockIfNeeded()
+							{
+								// Check if enough stale entries have built up
+								if (mClockKeys.getCount() <= (mReferenceByKey.getCount() * 2 + kClockCompactionSlack))
+									return;
+
+								// Rebuild from the live references
+								TNArray<CString>	keys;
+								for (typename TNDictionary<Reference>::Iterator iterator = mReferenceByKey.getIterator();
+										iterator; iterator++)
+									// Add
+									keys += iterator.getKey();
+								mClockKeys = keys;
+								mClockHand = 0;
+							}
+
+			// Properties
+			public:
+				static	const	UInt32					kClockCompactionSlack = 1024;
+
+								UInt32					mLimit;
+								OV<UInt64>				mByteLimit;
+								CReadPreferringLock		mLock;
+								TNDictionary<Reference>	mReferenceByKey;
+								TNArray<CString>		mClockKeys;
+								UInt32					mClockHand;
+								UInt64					mByteCount;
+								std::atomic<UInt64>		mHitCount;
+								std::atomic<UInt64>		mMissCount;
+								UInt64					mEvictionCount;
+		};
+
+	// Methods:
+	public:
+					// Lifecycle methods
+					TMDSClockCache(UInt32 limit, const OV<UInt64>& byteLimit = OV<UInt64>())
+						{
+							// Split limits across shards, spreading any remainder so the shard limits add up to
+							//	exactly the limits given
+							for (UInt32 i = 0; i < kShardCount; i++) {
+								// Set limits
+								mShards[i].mLimit = limit / kShardCount + ((i < (limit % kShardCount)) ? 1 : 0);
+								if (byteLimit.hasValue())
+									// Set byte limit
+									mShards[i].mByteLimit =
+											OV<UInt64>(*byteLimit / kShardCount +
+													((i < (*byteLimit % kShardCount)) ? 1 : 0));
+							}
+						}
+
+					// Instance methods
+		void		add(const CString& key, const T& value, UInt64 byteCount = 0)
+						{
+							// Setup
+							Shard&	shard = getShard(key);
+
+							// Store and evict as needed
+							shard.mLock.lockForWriting();
+							shard.add(key, value, byteCount);
+							shard.evict();
+							shard.mLock.unlockForWriting();
+						}
+		void		update(const CString& key, UInt64 byteCount)
+						{
+							// Setup
+							Shard&	shard = getShard(key);
+
+							// Re-account and evict as needed
+							shard.mLock.lockForWriting();
+							shard.update(key, byteCount);
+							shard.evict();
+							shard.mLock.unlockForWriting();
+						}
+		OV<T>		get(const CString& key)
+						{
+							// Setup
+							Shard&	shard = getShard(key);
+
+							// Retrieve
+							shard.mLock.lockForReading();
+							OR<T>	reference = shard.get(key);
+							OV<T>	value = reference.hasReference() ? OV<T>(*reference) : OV<T>();
+							shard.mLock.unlockForReading();
+
+							return value;
+						}
+		void		remove(const CString& key)
+						{
+							// Setup
+							Shard&	shard = getShard(key);
+
+							// Remove
+							shard.mLock.lockForWriting();
+							shard.remove(key);
+							shard.mLock.unlockForWriting();
+						}
+
+		Info		getInfo()
+						{
+							// Iterate shards
+							UInt32	count = 0;
+							UInt64	byteCount = 0;
+							UInt64	hitCount = 0;
+							UInt64	missCount = 0;
+							UInt64	evictionCount = 0;
+							for (UInt32 i = 0; i < kShardCount; i++) {
+								// Collect
+								Shard&	shard = mShards[i];
+								shard.mLock.lockForReading();
+								count += shard.mReferenceByKey.getCount();
+								byteCount += shard.mByteCount;
+								hitCount += shard.mHitCount.load(std::memory_order_relaxed);
+								missCount += shard.mMissCount.load(std::memory_order_relaxed);
+								evictionCount += shard.mEvictionCount;
+								shard.mLock.unlockForReading();
+							}
+
+							return Info(count, byteCount, hitCount, missCount, evictionCount);
+						}
+
+	private:
+		Shard&		getShard(const CString& key)
+						{
+							// Hash key
+							CHasher	hasher;
+							key.hashInto(hasher);
+
+							return mShards[hasher.getValue() % kShardCount];
+						}
+
+	// Properties:
+	private:
+		static	const	UInt32	kShardCount = 16;
+
+						Shard	mShards[kShardCount];
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+// MARK: - TMDSDocumentBackingCache
 
 template <typename T> class TMDSDocumentBackingCache {
 	// DocumentIDsInfo
@@ -65,93 +379,66 @@ template <typename T> class TMDSDocumentBackingCache {
 				TArray<CString>	mNotFoundDocumentIDs;
 		};
 
-	// Reference
-	private:
-		class Reference {
-			// Methods
-			public:
-						// Lifecycle methods
-						Reference(const T& documentBacking) :
-							mDocumentBacking(documentBacking),
-									mLastReferencedUniversalTime(SUniversalTime::getCurrent())
-							{}
-
-						// Instance methods
-				void	noteWasReferenced()
-							{ mLastReferencedUniversalTime = SUniversalTime::getCurrent(); }
-				T&		getDocumentBacking()
-							{ return mDocumentBacking; }
+	// Types
+	public:
+		typedef	typename TMDSClockCache<T>::Info	Info;
 
-			// Properties
-			private:
-				T				mDocumentBacking;
-				UniversalTime	mLastReferencedUniversalTime;
-		};
+	// Procs
+	public:
+		typedef	UInt64	(*ByteCountProc)(const T& documentBacking);
 
 	// Methods:
 	public:
 										// Lifecycle methods
-										TMDSDocumentBackingCache(UInt32 limit = 1000000) : mLimit(limit) {}
+										TMDSDocumentBackingCache(UInt32 limit = 1000000,
+												const OV<UInt64>& byteLimit = OV<UInt64>(),
+												ByteCountProc byteCountProc = nil) :
+											mCache(limit, byteLimit), mByteCountProc(byteCountProc)
+											{}
 
 										// Instance methods
 				void					add(const TArray<T>& documentBackings)
 											{
-												// Setup
-												mLock.lockForWriting();
-
 												// Iterate all backing infos
 												for (typename TArray<T>::Iterator iterator =
 																documentBackings.getIterator();
 														iterator; iterator++)
 													// Store
-													mReferenceByDocumentID.set((*iterator)->getDocumentID(),
-															Reference(*iterator));
-
-												// Done
-												mLock.unlockForWriting();
+													mCache.add((*iterator)->getDocumentID(), *iterator,
+															(mByteCountProc != nil) ? mByteCountProc(*iterator) : 0);
 											}
-		const	OR<T>					getDocumentBacking(const CString& documentID) const
+				void					update(const T& documentBacking)
 											{
-												// Setup
-												mLock.lockForReading();
-
-												// Retrieve
-												const	OR<Reference>	reference = mReferenceByDocumentID[documentID];
-												if (reference.hasReference())
-													// Note was referenced
-													reference->noteWasReferenced();
+												// Check if tracking byte counts
+												if (mByteCountProc == nil)
+													return;
 
-												// Done
-												mLock.unlockForReading();
-
-												return reference.hasReference() ?
-														OR<T>(reference->getDocumentBacking()) : OR<T>();
+												// Re-account.  Byte counts are only taken when a document backing
+												//	is added or updated, so callers must update after changing one
+												//	in place.
+												mCache.update(documentBacking->getDocumentID(),
+														mByteCountProc(documentBacking));
 											}
+		const	OV<T>					getDocumentBacking(const CString& documentID)
+											{ return mCache.get(documentID); }
 				DocumentIDsInfo			queryDocumentIDs(const TArray<CString>& documentIDs)
 											{
 												// Setup
 												TNArray<CString>	foundDocumentIDs;
 												TNArray<CString>	notFoundDocumentIDs;
 
-												mLock.lockForReading();
-
 												// Iterate document IDs
 												for (TArray<CString>::Iterator iterator = documentIDs.getIterator();
 														iterator; iterator++) {
-													// Look up reference for this document ID
-													const	OR<T>	reference = mReferenceByDocumentID[*iterator];
-													if (reference.hasReference()) {
+													// Check if found
+													if (mCache.get(*iterator).hasValue())
 														// Found
 														foundDocumentIDs += *iterator;
-														reference->noteWasReferenced();
-													} else
+													else
 														// Not found
 														notFoundDocumentIDs += *iterator;
 												}
 
-												// Done
-												mLock.unlockForReading();
-
 												return DocumentIDsInfo(foundDocumentIDs, notFoundDocumentIDs);
 											}
 				DocumentBackingsInfo	queryDocumentBackings(const TArray<CString>& documentIDs)
@@ -160,48 +447,38 @@ template <typename T> class TMDSDocumentBackingCache {
 												TNArray<T>			foundDocumentBackings;
 												TNArray<CString>	notFoundDocumentIDs;
 
-												mLock.lockForReading();
-
 												// Iterate document IDs
 												for (TArray<CString>::Iterator iterator = documentIDs.getIterator();
 														iterator; iterator++) {
-													// Look up reference for this document ID
-													const	OR<T>	reference = mReferenceByDocumentID[*iterator];
-													if (reference.hasReference()) {
+													// Look up
+													OV<T>	documentBacking = mCache.get(*iterator);
+													if (documentBacking.hasValue())
 														// Found
-														foundDocumentBackings += reference->getDocumentBacking();
-														reference->noteWasReferenced();
-													} else
+														foundDocumentBackings += *documentBacking;
+													else
 														// Not found
 														notFoundDocumentIDs += *iterator;
 												}
 
-												// Done
-												mLock.unlockForReading();
-
 												return DocumentBackingsInfo(foundDocumentBackings, notFoundDocumentIDs);
 											}
 				void					remove(const TArray<CString>& documentIDs)
 											{
-												// Setup
-												mLock.lockForWriting();
-
 												// Iterate document IDs
 												for (TArray<CString>::Iterator iterator = documentIDs.getIterator();
 														iterator; iterator++)
-													// Remove from storage
-													mReferenceByDocumentID.remove(*iterator);
-
-												// Done
-												mLock.unlockForWriting();
+													// Remove
+													mCache.remove(*iterator);
 											}
 
-		const	OR<T>					operator[](const CString& documentID) const
+				Info					getInfo()
+											{ return mCache.getInfo(); }
+
+		const	OV<T>					operator[](const CString& documentID)
 											{ return getDocumentBacking(documentID); }
 
 	// Properties:
 	private:
-		CReadPreferringLock		mLock;
-		TNDictionary<Reference>	mReferenceByDocumentID;
-		UInt32					mLimit;
+		TMDSClockCache<T>	mCache;
+		ByteCountProc		mByteCountProc;
 };
@@ -50,6 +50,26 @@ fileprivate extension MDSDocumentStorageError {
 			}
 }
 
+//----------------------------------------------------------------------------------------------------------------------
+// MARK: - Error extension
+fileprivate extension Error {
+
+	// MARK: Properties
+	var	httpEndpointStatus :HTTPEndpointStatus {
+				// Check error
+				if let documentStorageError = self as? MDSDocumentStorageError {
+					// MDSDocumentStorageError
+					return documentStorageError.status
+				} else if ((self as NSError).domain == "MDSDocumentStorage") && ((self as NSError).code == 91) {
+					// Not up to date error from a C++ document storage
+					return .conflict
+				} else {
+					// Everything else
+					return .badRequest
+				}
+			}
+}
+
 //----------------------------------------------------------------------------------------------------------------------
 // MARK: - MDSHTTPServices extension
 extension MDSHTTPServices {
@@ -224,7 +244,7 @@ extension HTTPServer {
 				return (.ok, nil, nil)
 			} catch {
 				// Error
-				return ((error as? MDSDocumentStorageError)?.status ?? .badRequest, nil,
+				return (error.httpEndpointStatus, nil,
 						.json(["error": error.localizedDescription]))
 			}
 		}
@@ -262,7 +282,7 @@ extension HTTPServer {
 				return (.ok, nil, nil)
 			} catch {
 				// Error
-				return ((error as? MDSDocumentStorageError)?.status ?? .badRequest, nil,
+				return (error.httpEndpointStatus, nil,
 						.json(["error": error.localizedDescription]))
 			}
 		}
@@ -341,7 +361,7 @@ extension HTTPServer {
 				}
 			} catch {
 				// Error
-				return ((error as? MDSDocumentStorageError)?.status ?? .badRequest, nil,
+				return (error.httpEndpointStatus, nil,
 						.json(["error": error.localizedDescription]))
 			}
 		}
@@ -391,7 +411,7 @@ extension HTTPServer {
 				return (.ok, nil, .json(results))
 			} catch {
 				// Error
-				return ((error as? MDSDocumentStorageError)?.status ?? .badRequest, nil,
+				return (error.httpEndpointStatus, nil,
 						.json(["error": error.localizedDescription]))
 			}
 		}
@@ -463,7 +483,7 @@ extension HTTPServer {
 				return (.ok, nil, nil)
 			} catch {
 				// Error
-				return ((error as? MDSDocumentStorageError)?.status ?? .badRequest, nil,
+				return (error.httpEndpointStatus, nil,
 						.json(["error": error.localizedDescription]))
 			}
 		}
@@ -485,7 +505,7 @@ extension HTTPServer {
 				return (.ok, nil, nil)
 			} catch {
 				// Error
-				return ((error as? MDSDocumentStorageError)?.status ?? .badRequest, nil,
+				return (error.httpEndpointStatus, nil,
 						.json(["error": error.localizedDescription]))
 			}
 		}
@@ -518,7 +538,7 @@ extension HTTPServer {
 				return (.ok, nil, .json(results))
 			} catch {
 				// Error
-				return ((error as? MDSDocumentStorageError)?.status ?? .badRequest, nil,
+				return (error.httpEndpointStatus, nil,
 						.json(["error": error.localizedDescription]))
 			}
 		}
@@ -572,7 +592,7 @@ extension HTTPServer {
 				return (.ok, nil, nil)
 			} catch {
 				// Error
-				return ((error as? MDSDocumentStorageError)?.status ?? .badRequest, nil,
+				return (error.httpEndpointStatus, nil,
 						.json(["error": error.localizedDescription]))
 			}
 		}
@@ -597,7 +617,7 @@ extension HTTPServer {
 						nil)
 			} catch {
 				// Error
-				return ((error as? MDSDocumentStorageError)?.status ?? .badRequest, nil,
+				return (error.httpEndpointStatus, nil,
 						.json(["error": error.localizedDescription]))
 			}
 		}
@@ -652,7 +672,7 @@ extension HTTPServer {
 				}
 			} catch {
 				// Error
-				return ((error as? MDSDocumentStorageError)?.status ?? .badRequest, nil,
+				return (error.httpEndpointStatus, nil,
 						.json(["error": error.localizedDescription]))
 			}
 		}
@@ -703,7 +723,7 @@ extension HTTPServer {
 						nil)
 			} catch {
 				// Error
-				return ((error as? MDSDocumentStorageError)?.status ?? .badRequest, nil,
+				return (error.httpEndpointStatus, nil,
 						.json(["error": error.localizedDescription]))
 			}
 		}
@@ -780,7 +800,7 @@ extension HTTPServer {
 				}
 			} catch {
 				// Error
-				return ((error as? MDSDocumentStorageError)?.status ?? .badRequest, nil,
+				return (error.httpEndpointStatus, nil,
 						.json(["error": error.localizedDescription]))
 			}
 		}
@@ -805,7 +825,7 @@ extension HTTPServer {
 				return (.ok, nil, .json(infos))
 			} catch {
 				// Error
-				return ((error as? MDSDocumentStorageError)?.status ?? .badRequest, nil,
+				return (error.httpEndpointStatus, nil,
 						.json(["error": error.localizedDescription]))
 			}
 		}
@@ -838,7 +858,7 @@ extension HTTPServer {
 				return (.ok, nil, .json(documentAttachmentInfo.httpServicesInfo))
 			} catch {
 				// Error
-				return ((error as? MDSDocumentStorageError)?.status ?? .badRequest, nil,
+				return (error.httpEndpointStatus, nil,
 						.json(["error": error.localizedDescription]))
 			}
 		}
@@ -862,7 +882,7 @@ extension HTTPServer {
 				return (.ok, nil, .data(content))
 			} catch {
 				// Error
-				return ((error as? MDSDocumentStorageError)?.status ?? .badRequest, nil,
+				return (error.httpEndpointStatus, nil,
 						.json(["error": error.localizedDescription]))
 			}
 		}
@@ -896,7 +916,7 @@ extension HTTPServer {
 				return (.ok, nil, .json(["revision": revision]))
 			} catch {
 				// Error
-				return ((error as? MDSDocumentStorageError)?.status ?? .badRequest, nil,
+				return (error.httpEndpointStatus, nil,
 						.json(["error": error.localizedDescription]))
 			}
 		}
@@ -919,7 +939,7 @@ extension HTTPServer {
 				return (.ok, nil, nil)
 			} catch {
 				// Error
-				return ((error as? MDSDocumentStorageError)?.status ?? .badRequest, nil,
+				return (error.httpEndpointStatus, nil,
 						.json(["error": error.localizedDescription]))
 			}
 		}
@@ -971,7 +991,7 @@ extension HTTPServer {
 				return (.ok, nil, nil)
 			} catch {
 				// Error
-				return ((error as? MDSDocumentStorageError)?.status ?? .badRequest, nil,
+				return (error.httpEndpointStatus, nil,
 						.json(["error": error.localizedDescription]))
 			}
 		}
@@ -993,7 +1013,7 @@ extension HTTPServer {
 				return (.ok, nil, nil)
 			} catch {
 				// Error
-				return ((error as? MDSDocumentStorageError)?.status ?? .badRequest, nil,
+				return (error.httpEndpointStatus, nil,
 						.json(["error": error.localizedDescription]))
 			}
 		}
@@ -1032,7 +1052,7 @@ extension HTTPServer {
 				}
 			} catch {
 				// Error
-				return ((error as? MDSDocumentStorageError)?.status ?? .badRequest, nil,
+				return (error.httpEndpointStatus, nil,
 						.json(["error": error.localizedDescription]))
 			}
 		}
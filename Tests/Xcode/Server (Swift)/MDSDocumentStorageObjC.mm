@@ -753,9 +753,22 @@ static	SValue			sIntegerValueForProperty(const CString& documentType, const I<CM
 - (BOOL) cacheGetStatusNamed:(NSString*) name error:(NSError**) error
 {
 	// Get status
-	OV<SError>	cppError = self.documentStorageServer->cacheGetStatus(CString((__bridge CFStringRef) name));
+	CMDSDocumentStorageServer::StatusResult	status =
+													self.documentStorageServer->cacheGetStatus(
+															CString((__bridge CFStringRef) name));
+	if (status.hasError()) {
+		// Error
+		*error = [self errorFrom:status.getError()];
 
-	return [self composeResultsFrom:cppError error:error];
+		return NO;
+	} else if (!status->isUpToDate()) {
+		// Not up to date
+		*error = [self errorFrom:CMDSDocumentStorage::getNotUpToDateError(CString((__bridge CFStringRef) name))];
+
+		return NO;
+	}
+
+	return YES;
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -1254,9 +1267,22 @@ static	SValue			sIntegerValueForProperty(const CString& documentType, const I<CM
 - (BOOL) indexGetStatusNamed:(NSString*) name error:(NSError**) error
 {
 	// Get status
-	OV<SError>	cppError = self.documentStorageServer->indexGetStatus(CString((__bridge CFStringRef) name));
+	CMDSDocumentStorageServer::StatusResult	status =
+													self.documentStorageServer->indexGetStatus(
+															CString((__bridge CFStringRef) name));
+	if (status.hasError()) {
+		// Error
+		*error = [self errorFrom:status.getError()];
 
-	return [self composeResultsFrom:cppError error:error];
+		return NO;
+	} else if (!status->isUpToDate()) {
+		// Not up to date
+		*error = [self errorFrom:CMDSDocumentStorage::getNotUpToDateError(CString((__bridge CFStringRef) name))];
+
+		return NO;
+	}
+
+	return YES;
 }
 
 //----------------------------------------------------------------------------------------------------------------------
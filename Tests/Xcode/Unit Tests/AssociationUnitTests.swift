@@ -743,6 +743,83 @@ class AssociationUnitTests : XCTestCase {
 		}
 	}
 
+	//------------------------------------------------------------------------------------------------------------------
+	func testGetDocumentInfosFromAndTo() throws {
+		// Setup
+		let	associationName = "\(Parent.documentType)To\(Child.documentType.capitalizingFirstLetter)"
+		let	config = Config.current
+		let	documentStorage = MDSEphemeral()
+
+		// Create documents
+		let	(parentInfos, parentCreateError) =
+					config.httpEndpointClient.documentCreate(documentStorageID: config.documentStorageID,
+							documentType: Parent.documentType,
+							documentCreateInfos: [MDSDocument.CreateInfo(propertyMap: [:])])
+		XCTAssertNil(parentCreateError, "create parent document received error: \(parentCreateError!)")
+		XCTAssertNotNil(parentInfos, "create parent document did not receive info")
+		guard parentInfos != nil else { return }
+		let	parent = Parent(id: parentInfos![0]["documentID"] as! String, documentStorage: documentStorage)
+
+		let	(childInfos, childCreateError) =
+					config.httpEndpointClient.documentCreate(documentStorageID: config.documentStorageID,
+							documentType: Child.documentType,
+							documentCreateInfos:
+									[
+										MDSDocument.CreateInfo(propertyMap: [:]),
+										MDSDocument.CreateInfo(propertyMap: [:]),
+									])
+		XCTAssertNil(childCreateError, "create child documents received error: \(childCreateError!)")
+		XCTAssertNotNil(childInfos, "create child documents did not receive infos")
+		guard childInfos != nil else { return }
+		let	child1 = Child(id: childInfos![0]["documentID"] as! String, documentStorage: documentStorage)
+		let	child2 = Child(id: childInfos![1]["documentID"] as! String, documentStorage: documentStorage)
+
+		// Register Association
+		let	associationRegisterError =
+					config.httpEndpointClient.associationRegister(documentStorageID: config.documentStorageID,
+							name: associationName, fromDocumentType: Parent.documentType,
+							toDocumentType: Child.documentType)
+		XCTAssertNil(associationRegisterError, "association register received error: \(associationRegisterError!)")
+		guard associationRegisterError == nil else { return }
+
+		// Add Associations (Parent -> 1, 2)
+		let	addErrors =
+					config.httpEndpointClient.associationUpdate(documentStorageID: config.documentStorageID,
+							name: associationName,
+							updates:
+									[
+										MDSAssociation.Update.add(from: parent, to: child1),
+										MDSAssociation.Update.add(from: parent, to: child2),
+									])
+		XCTAssertEqual(addErrors.count, 0, "update (add) received errors: \(addErrors)")
+		guard addErrors.isEmpty else { return }
+
+		// Perform
+		let	(fromInfo, fromError) =
+					config.httpEndpointClient.associationGetDocumentRevisionInfos(
+							documentStorageID: config.documentStorageID, name: associationName,
+							fromDocumentID: parent.id)
+		let	(toInfo, toError) =
+					config.httpEndpointClient.associationGetDocumentRevisionInfos(
+							documentStorageID: config.documentStorageID, name: associationName,
+							toDocumentID: child2.id)
+
+		// Evaluate results
+		XCTAssertNotNil(fromInfo, "from did not receive info")
+		if fromInfo != nil {
+			XCTAssertEqual(Set<String>(fromInfo!.documentRevisionInfos.map({ $0.documentID })),
+					Set<String>([child1.id, child2.id]), "from did not receive expected documentIDs")
+		}
+		XCTAssertNil(fromError, "from received error \(fromError!)")
+
+		XCTAssertNotNil(toInfo, "to did not receive info")
+		if toInfo != nil {
+			XCTAssertEqual(toInfo!.documentRevisionInfos.map({ $0.documentID }), [parent.id],
+					"to did not receive expected documentIDs")
+		}
+		XCTAssertNil(toError, "to received error \(toError!)")
+	}
+
 	//------------------------------------------------------------------------------------------------------------------
 	func testDetailGetValueInvalidDocumentStorageID() throws {
 		// Test Detail
@@ -1249,4 +1326,84 @@ class AssociationUnitTests : XCTestCase {
 			}
 		}
 	}
+
+	//------------------------------------------------------------------------------------------------------------------
+	func testSumGetValueManyDocuments() throws {
+		// Setup
+		let	associationName = "\(Parent.documentType)To\(Child.documentType.capitalizingFirstLetter)"
+		let	cacheName = UUID().uuidString
+		let	config = Config.current
+		let	documentStorage = MDSEphemeral()
+		let	childCount = 2000
+
+		// Create documents.  There are enough children that bulk writes and id lookups span several statements.
+		let	(parentInfos, parentCreateError) =
+					config.httpEndpointClient.documentCreate(documentStorageID: config.documentStorageID,
+							documentType: Parent.documentType,
+							documentCreateInfos: [MDSDocument.CreateInfo(propertyMap: [:])])
+		XCTAssertNil(parentCreateError, "create parent document received error: \(parentCreateError!)")
+		XCTAssertNotNil(parentInfos, "create parent document did not receive info")
+		guard parentInfos != nil else { return }
+		let	parent = Parent(id: parentInfos![0]["documentID"] as! String, documentStorage: documentStorage)
+
+		let	(childInfos, childCreateError) =
+					config.httpEndpointClient.documentCreate(documentStorageID: config.documentStorageID,
+							documentType: Child.documentType,
+							documentCreateInfos:
+									(1...childCount).map({ MDSDocument.CreateInfo(propertyMap: ["size": $0]) }))
+		XCTAssertNil(childCreateError, "create child documents received error: \(childCreateError!)")
+		XCTAssertNotNil(childInfos, "create child documents did not receive infos")
+		guard childInfos != nil else { return }
+		let	children =
+					childInfos!.map({ Child(id: $0["documentID"] as! String, documentStorage: documentStorage) })
+
+		// Register Association
+		let	associationRegisterError =
+					config.httpEndpointClient.associationRegister(documentStorageID: config.documentStorageID,
+							name: associationName, fromDocumentType: Parent.documentType,
+							toDocumentType: Child.documentType)
+		XCTAssertNil(associationRegisterError, "association register received error: \(associationRegisterError!)")
+		guard associationRegisterError == nil else { return }
+
+		// Add Associations (Parent -> all children)
+		let	addErrors =
+					config.httpEndpointClient.associationUpdate(documentStorageID: config.documentStorageID,
+							name: associationName,
+							updates: children.map({ MDSAssociation.Update.add(from: parent, to: $0) }))
+		XCTAssertEqual(addErrors.count, 0, "update (add) received errors: \(addErrors)")
+		guard addErrors.isEmpty else { return }
+
+		// Register Cache
+		let	cacheRegisterError =
+					config.httpEndpointClient.cacheRegister(documentStorageID: config.documentStorageID,
+							name: cacheName, documentType: Child.documentType, relevantProperties: ["size"],
+							valueInfos: [(MDSValueInfo(name: "size", type: .integer), "integerValueForProperty()")])
+		XCTAssertNil(cacheRegisterError, "cache register received error: \(cacheRegisterError!)")
+		guard cacheRegisterError == nil else { return }
+
+		// Perform.  The cache may still be building, in which case the value is not up to date yet.
+		var	getValueInfo :(info :Any?, isUpToDate :Bool)?
+		var	getValueError :Error?
+		for _ in 0..<100 {
+			// Get Association Value
+			(getValueInfo, getValueError) =
+					config.httpEndpointClient.associationGetValues(documentStorageID: config.documentStorageID,
+							name: associationName, action: .sum, fromDocumentIDs: [parent.id],
+							cacheName: cacheName, cachedValueNames: ["size"])
+			guard (getValueInfo != nil) && !getValueInfo!.isUpToDate else { break }
+
+			// Wait
+			Thread.sleep(forTimeInterval: 0.1)
+		}
+
+		// Evaluate results
+		XCTAssertNotNil(getValueInfo, "did not receive info")
+		if getValueInfo != nil {
+			XCTAssertTrue(getValueInfo!.isUpToDate, "did not become up to date")
+			XCTAssertEqual((getValueInfo!.info as? [String : Int64])?["size"], Int64(childCount * (childCount + 1) / 2),
+					"did not receive expected sum")
+		}
+
+		XCTAssertNil(getValueError, "received error \(getValueError!)")
+	}
 }
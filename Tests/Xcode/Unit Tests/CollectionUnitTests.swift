@@ -304,6 +304,95 @@ class CollectionUnitTests : XCTestCase {
 		}
 	}
 
+	//------------------------------------------------------------------------------------------------------------------
+	func testGetDocumentCountEmpty() throws {
+		// Setup
+		let	collectionName = UUID().uuidString
+		let	config = Config.current
+		let	property1 = UUID().uuidString
+
+		// Register
+		let	registerError =
+					config.httpEndpointClient.collectionRegister(documentStorageID: config.documentStorageID,
+							name: collectionName, documentType: config.defaultDocumentType,
+							relevantProperties: [property1], isUpToDate: true,
+							isIncludedSelector: "documentPropertyIsValue()",
+							isIncludedSelectorInfo: ["property": property1, "value": "111"])
+		XCTAssertNil(registerError, "register received error \(registerError!)")
+		guard registerError == nil else { return }
+
+		// Perform
+		let	(info, error) =
+					config.httpEndpointClient.collectionGetDocumentCount(documentStorageID: config.documentStorageID,
+							name: collectionName)
+
+		// Evaluate results
+		XCTAssertNotNil(info, "did not receive info")
+		if info != nil {
+			XCTAssertTrue(info!.isUpToDate, "is not up to date")
+			XCTAssertEqual(info!.count, 0, "did not receive count of 0")
+		}
+
+		XCTAssertNil(error, "received error \(error!)")
+	}
+
+	//------------------------------------------------------------------------------------------------------------------
+	func testGetDocumentCountBuildsInBackground() throws {
+		// Setup
+		let	collectionName = UUID().uuidString
+		let	config = Config.current
+		let	property1 = UUID().uuidString
+
+		// Create Test documents
+		let	(_, createError) =
+					config.httpEndpointClient.documentCreate(documentStorageID: config.documentStorageID,
+							documentType: config.defaultDocumentType,
+							documentCreateInfos:
+									[
+										MDSDocument.CreateInfo(propertyMap: [property1: "111"]),
+										MDSDocument.CreateInfo(propertyMap: [property1: "111"]),
+										MDSDocument.CreateInfo(propertyMap: [property1: "222"]),
+									])
+		XCTAssertNil(createError, "create documents received error: \(createError!)")
+		guard createError == nil else { return }
+
+		// Register.  The existing documents are processed by the background builder.
+		let	registerError =
+					config.httpEndpointClient.collectionRegister(documentStorageID: config.documentStorageID,
+							name: collectionName, documentType: config.defaultDocumentType,
+							relevantProperties: [property1], isUpToDate: false,
+							isIncludedSelector: "documentPropertyIsValue()",
+							isIncludedSelectorInfo: ["property": property1, "value": "111"])
+		XCTAssertNil(registerError, "register received error \(registerError!)")
+		guard registerError == nil else { return }
+
+		// Perform.  However far along the build is, each response must either be not up to date with no count or be
+		//	up to date with the final count, never an error or a partial count.
+		let	deadline = Date(timeIntervalSinceNow: 60.0)
+		var	info :(isUpToDate :Bool, count :Int?)?
+		var	error :Error?
+		repeat {
+			// Get Document Count
+			(info, error) =
+					config.httpEndpointClient.collectionGetDocumentCount(documentStorageID: config.documentStorageID,
+							name: collectionName)
+			guard (error == nil) && (info != nil) && !info!.isUpToDate else { break }
+			XCTAssertNil(info!.count, "received count while not up to date")
+
+			// Wait
+			Thread.sleep(forTimeInterval: 0.05)
+		} while Date() < deadline
+
+		// Evaluate results
+		XCTAssertNotNil(info, "did not receive info")
+		if info != nil {
+			XCTAssertTrue(info!.isUpToDate, "did not become up to date")
+			XCTAssertEqual(info!.count, 2, "did not receive count of 2")
+		}
+
+		XCTAssertNil(error, "received error \(error!)")
+	}
+
 	//------------------------------------------------------------------------------------------------------------------
 	func testGetDocumentInfosInvalidDocumentStorageID() throws {
 		// Setup
@@ -465,6 +554,130 @@ class CollectionUnitTests : XCTestCase {
 		}
 	}
 
+	//------------------------------------------------------------------------------------------------------------------
+	func testGetDocumentInfosPaging() throws {
+		// Setup
+		let	collectionName = UUID().uuidString
+		let	config = Config.current
+		let	property1 = UUID().uuidString
+
+		// Register
+		let	registerError =
+					config.httpEndpointClient.collectionRegister(documentStorageID: config.documentStorageID,
+							name: collectionName, documentType: config.defaultDocumentType,
+							relevantProperties: [property1], isUpToDate: true,
+							isIncludedSelector: "documentPropertyIsValue()",
+							isIncludedSelectorInfo: ["property": property1, "value": "111"])
+		XCTAssertNil(registerError, "register received error \(registerError!)")
+		guard registerError == nil else { return }
+
+		// Create Test documents
+		let	(createInfos, createError) =
+					config.httpEndpointClient.documentCreate(documentStorageID: config.documentStorageID,
+							documentType: config.defaultDocumentType,
+							documentCreateInfos:
+									(0..<5).map({ _ in MDSDocument.CreateInfo(propertyMap: [property1: "111"]) }))
+		XCTAssertNil(createError, "create documents received error: \(createError!)")
+		XCTAssertNotNil(createInfos, "create documents did not receive infos")
+		guard createInfos != nil else { return }
+		let	documentIDs = createInfos!.map({ $0["documentID"] as! String })
+
+		// Remove the second document from the collection
+		let	(_, updateError) =
+					config.httpEndpointClient.documentUpdate(documentStorageID: config.documentStorageID,
+							documentType: config.defaultDocumentType,
+							documentUpdateInfos:
+									[MDSDocument.UpdateInfo(documentID: documentIDs[1], updated: [property1: "222"])])
+		XCTAssertNil(updateError, "update document received error: \(updateError!)")
+		guard updateError == nil else { return }
+
+		// Perform
+		var	pagedDocumentIDs = [String]()
+		for startIndex in stride(from: 0, to: 6, by: 2) {
+			// Get Document Infos
+			let	(isUpToDate, info, error) =
+						config.httpEndpointClient.collectionGetDocumentRevisionInfos(
+								documentStorageID: config.documentStorageID, name: collectionName,
+								startIndex: startIndex, count: 2)
+			XCTAssertEqual(isUpToDate, true, "page at \(startIndex) is not up to date")
+			XCTAssertNil(error, "page at \(startIndex) received error \(error!)")
+			guard info != nil else { break }
+
+			pagedDocumentIDs += info!.documentRevisionInfos.map({ $0.documentID })
+		}
+
+		// Evaluate results.  Each included document is returned once and the pages keep the order of inclusion.
+		XCTAssertEqual(pagedDocumentIDs, [documentIDs[0], documentIDs[2], documentIDs[3], documentIDs[4]],
+				"did not receive expected documentIDs")
+	}
+
+	//------------------------------------------------------------------------------------------------------------------
+	func testGetDocumentInfosPagingReincluded() throws {
+		// Setup
+		let	collectionName = UUID().uuidString
+		let	config = Config.current
+		let	property1 = UUID().uuidString
+
+		// Register
+		let	registerError =
+					config.httpEndpointClient.collectionRegister(documentStorageID: config.documentStorageID,
+							name: collectionName, documentType: config.defaultDocumentType,
+							relevantProperties: [property1], isUpToDate: true,
+							isIncludedSelector: "documentPropertyIsValue()",
+							isIncludedSelectorInfo: ["property": property1, "value": "111"])
+		XCTAssertNil(registerError, "register received error \(registerError!)")
+		guard registerError == nil else { return }
+
+		// Create Test documents
+		let	(createInfos, createError) =
+					config.httpEndpointClient.documentCreate(documentStorageID: config.documentStorageID,
+							documentType: config.defaultDocumentType,
+							documentCreateInfos:
+									(0..<5).map({ _ in MDSDocument.CreateInfo(propertyMap: [property1: "111"]) }))
+		XCTAssertNil(createError, "create documents received error: \(createError!)")
+		XCTAssertNotNil(createInfos, "create documents did not receive infos")
+		guard createInfos != nil else { return }
+		let	documentIDs = createInfos!.map({ $0["documentID"] as! String })
+
+		// Remove the second document from the collection and then include it again
+		for value in ["222", "111"] {
+			// Update document
+			let	(_, updateError) =
+						config.httpEndpointClient.documentUpdate(documentStorageID: config.documentStorageID,
+								documentType: config.defaultDocumentType,
+								documentUpdateInfos:
+										[
+											MDSDocument.UpdateInfo(documentID: documentIDs[1],
+													updated: [property1: value]),
+										])
+			XCTAssertNil(updateError, "update document to \(value) received error: \(updateError!)")
+			guard updateError == nil else { return }
+		}
+
+		// Perform
+		var	pagedDocumentIDs = [String]()
+		for startIndex in stride(from: 0, to: 8, by: 2) {
+			// Get Document Infos
+			let	(isUpToDate, info, error) =
+						config.httpEndpointClient.collectionGetDocumentRevisionInfos(
+								documentStorageID: config.documentStorageID, name: collectionName,
+								startIndex: startIndex, count: 2)
+			XCTAssertEqual(isUpToDate, true, "page at \(startIndex) is not up to date")
+			XCTAssertNil(error, "page at \(startIndex) received error \(error!)")
+			guard info != nil else { break }
+
+			pagedDocumentIDs += info!.documentRevisionInfos.map({ $0.documentID })
+		}
+
+		// Evaluate results.  The re-included document is returned once and the other documents keep the order of
+		//	inclusion.
+		XCTAssertEqual(pagedDocumentIDs.count, 5, "did not receive 5 documentIDs")
+		XCTAssertEqual(Set<String>(pagedDocumentIDs), Set<String>(documentIDs), "did not receive expected documentIDs")
+		XCTAssertEqual(pagedDocumentIDs.filter({ $0 != documentIDs[1] }),
+				[documentIDs[0], documentIDs[2], documentIDs[3], documentIDs[4]],
+				"did not receive documentIDs in order of inclusion")
+	}
+
 	//------------------------------------------------------------------------------------------------------------------
 	func testGetDocumentsInvalidDocumentStorageID() throws {
 		// Setup
@@ -217,6 +217,51 @@ class DocumentUnitTests : XCTestCase {
 		XCTAssertNil(error, "received error \(error!)")
 	}
 
+	//------------------------------------------------------------------------------------------------------------------
+	func testCreateDates() throws {
+		// Setup
+		let	config = Config.current
+		let	creationDate = Date(timeIntervalSinceReferenceDate: 700_000_000.125)
+		let	modificationDate = Date(timeIntervalSinceReferenceDate: 700_000_100.375)
+
+		// Create document
+		let	(createDocumentInfos, createError) =
+					config.httpEndpointClient.documentCreate(documentStorageID: config.documentStorageID,
+							documentType: config.defaultDocumentType,
+							documentCreateInfos:
+									[
+										MDSDocument.CreateInfo(creationDate: creationDate,
+												modificationDate: modificationDate, propertyMap: ["key": "value"]),
+									])
+		XCTAssertNotNil(createDocumentInfos, "create did not receive documentInfos")
+		XCTAssertNil(createError, "create received error \(createError!)")
+		guard createDocumentInfos != nil else { return }
+		let	documentID = createDocumentInfos![0]["documentID"] as! String
+
+		// Perform
+		let	(documentFullInfos, error) =
+					config.httpEndpointClient.documentGetDocumentFullInfos(documentStorageID: config.documentStorageID,
+							documentType: config.defaultDocumentType, documentIDs: [documentID])
+
+		// Evaluate results.  Stored dates must come back unchanged, including fractional seconds.
+		XCTAssertNotNil(documentFullInfos, "did not receive documentFullInfos")
+		if documentFullInfos != nil {
+			XCTAssertEqual(documentFullInfos!.count, 1, "did not receive 1 documentFullInfo")
+			if documentFullInfos!.count > 0 {
+				let	documentFullInfo = documentFullInfos![0]
+
+				XCTAssertEqual(documentFullInfo.creationDate.timeIntervalSinceReferenceDate,
+						creationDate.timeIntervalSinceReferenceDate, accuracy: 0.001,
+						"did not receive expected creationDate")
+				XCTAssertEqual(documentFullInfo.modificationDate.timeIntervalSinceReferenceDate,
+						modificationDate.timeIntervalSinceReferenceDate, accuracy: 0.001,
+						"did not receive expected modificationDate")
+			}
+		}
+
+		XCTAssertNil(error, "received error \(error!)")
+	}
+
 	//------------------------------------------------------------------------------------------------------------------
 	func testGetCountInvalidDocumentStorageID() throws {
 		// Setup
@@ -404,6 +449,58 @@ class DocumentUnitTests : XCTestCase {
 		}
 	}
 
+	//------------------------------------------------------------------------------------------------------------------
+	func testGetSinceRevision() throws {
+		// Setup
+		let	config = Config.current
+
+		// Create documents
+		let	(createDocumentInfos, createError) =
+					config.httpEndpointClient.documentCreate(documentStorageID: config.documentStorageID,
+							documentType: config.defaultDocumentType,
+							documentCreateInfos:
+									[
+										MDSDocument.CreateInfo(propertyMap: ["key": "value1"]),
+										MDSDocument.CreateInfo(propertyMap: ["key": "value2"]),
+									])
+		XCTAssertNotNil(createDocumentInfos, "create did not receive documentInfos")
+		XCTAssertNil(createError, "create received error \(createError!)")
+		guard createDocumentInfos != nil else { return }
+		let	documentID1 = createDocumentInfos![0]["documentID"] as! String
+		let	documentID2 = createDocumentInfos![1]["documentID"] as! String
+		let	revision = createDocumentInfos!.map({ $0["revision"] as! Int }).max()!
+
+		// Update documents.  The second one becomes inactive, which must still be reported as a change.
+		let	(_, updateError) =
+					config.httpEndpointClient.documentUpdate(documentStorageID: config.documentStorageID,
+							documentType: config.defaultDocumentType,
+							documentUpdateInfos:
+									[
+										MDSDocument.UpdateInfo(documentID: documentID1, updated: ["key": "value3"]),
+										MDSDocument.UpdateInfo(documentID: documentID2, active: false),
+									])
+		XCTAssertNil(updateError, "update received error \(updateError!)")
+		guard updateError == nil else { return }
+
+		// Perform
+		let	(info, error) =
+					config.httpEndpointClient.documentGetDocumentRevisionInfos(
+							documentStorageID: config.documentStorageID, documentType: config.defaultDocumentType,
+							sinceRevision: revision)
+
+		// Evaluate results
+		XCTAssertNotNil(info, "did not receive info")
+		if info != nil {
+			let	documentIDs = Set<String>(info!.documentRevisionInfos.map({ $0.documentID }))
+			XCTAssertTrue(documentIDs.contains(documentID1), "did not receive updated document")
+			XCTAssertTrue(documentIDs.contains(documentID2), "did not receive inactive document")
+			XCTAssertTrue(info!.documentRevisionInfos.allSatisfy({ $0.revision > revision }),
+					"received document not changed since revision")
+		}
+
+		XCTAssertNil(error, "received error \(error!)")
+	}
+
 	//------------------------------------------------------------------------------------------------------------------
 	func testGetIDsInvalidDocumentStorageID() throws {
 		// Setup